@@ -84,6 +84,9 @@ local FILE_PATH = "/etc/ntfr.conf"
 local allowedParamNames = {
     "snmp_srv",
     "syslog_srv",
+    "syslog_srv_2",
+    "syslog_srv_3",
+    "syslog_srv_4",
 }
 
 --========================================================================
@@ -103,31 +106,47 @@ local function loadConfiguration( filePath )
         return RES_FAILURE
     end
     local params = {}
+    local lines = {}
     for line in confFile:lines() do 
-        local key, value = string.match(line, "([%w_]+)[%s]+=[%s]+\"([%d\.]+)\"")
+        table.insert(lines, line)
+        local key, value = string.match(line, "^([%w_]+)%s*=%s*\"([^\"]*)\"")
         if key ~= nil and value ~= nil then
             params[key] = value
         end
     end
     confFile:close()
-    return rescode, params
+    return rescode, params, lines
 end
 
-local function saveConfiguration( filePath, params )
+-- Only 'key = "value"' lines are rewritten, other lines (comments, lists
+-- like rate_limits) are written back as they were read
+local function saveConfiguration( filePath, params, lines )
     local confFile = io.open(filePath, "w")
     local rescode = RES_OK
     if confFile == nil then
         return RES_FAILURE
     end
+    local written = {}
+    for _, line in ipairs(lines) do
+        local key, tail = string.match(line, "^([%w_]+)%s*=%s*\"[^\"]*\"(.*)$")
+        if key ~= nil and params[key] ~= nil and written[key] == nil then
+            confFile:write(key .. " = \"" .. params[key] .. "\"" .. tail .. "\n")
+            written[key] = true
+        else
+            confFile:write(line .. "\n")
+        end
+    end
     for key, value in pairs(params) do 
-        confFile:write(key .. " = \"" .. value .. "\"\n")
+        if written[key] == nil then
+            confFile:write(key .. " = \"" .. value .. "\"\n")
+        end
     end
     confFile:close()
     return rescode
 end
 
 function ing.ntfr.setParam( pName, pValue )
-    local rescode, params = loadConfiguration(FILE_PATH)
+    local rescode, params, lines = loadConfiguration(FILE_PATH)
     if rescode ~= RES_OK then
         return rescode
     end
@@ -136,7 +155,7 @@ function ing.ntfr.setParam( pName, pValue )
     else
         return RES_INVLD_ARGS
     end
-    rescode = saveConfiguration(FILE_PATH, params)
+    rescode = saveConfiguration(FILE_PATH, params, lines)
     return rescode
 end
 
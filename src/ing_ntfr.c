@@ -73,19 +73,101 @@
 /* This file contains API and helpers functions for notifier shared library
  */
 
+#define _GNU_SOURCE
+
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
+#include <stdint.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 
 #include "ing_ntfr_defines.h"
 
+/*
+ * Notification sent reliably, kept until it is acked
+ */
+struct ntf_reliable_msg
+{
+    uint64_t seq;
+    size_t   len;
+    char     data[NTF_STR_MSG_BUFFER_LEN];
+};
+
+/*
+ * Reliable sender of process
+ */
+struct ntf_reliable_sender
+{
+    pthread_mutex_t lock;
+    pid_t    pid;       /* sender is started again in forked child  */
+    int      sock;      /* connected to core, acks are received on it */
+    uint32_t sender;    /* random id, core tells restarted sender by it */
+    uint64_t seq_next;
+    uint64_t acked;     /* last sequence number acked by core */
+    int       rto;       /* retransmit timeout of notifications left not acked */
+    long long resend_ms; /* when they are retransmitted next time */
+    struct ntf_reliable_msg window[NTF_RELIABLE_WINDOW];
+};
+
+/*
+ * Constants of queue of notifications sent with NTF_MSG_DONOTWAIT
+ */
+#define NTF_SEND_QUEUE_LEN  1024 /* power of 2 */
+#define NTF_SEND_BATCH_MAX  64   /* notifications sent to core with one call */
+#define NTF_SEND_IDLE_MS    1000 /* flusher wakes up when idle to report drops */
+
+/*
+ * Cell of queue: it is free for enqueue position 'seq' and holds
+ * notification for dequeue when 'seq' is position + 1
+ */
+struct ntf_send_cell
+{
+    size_t seq;
+    int    flags;
+    size_t len;
+    char   data[NTF_STR_MSG_BUFFER_LEN];
+};
+
+/*
+ * Bounded lock-free queue with many producers (sending threads) and
+ * single consumer (flusher thread). Sending threads never block: the
+ * flusher is woken through eventfd only if it is idle
+ */
+struct ntf_send_queue
+{
+    size_t enqueue_pos __attribute__((aligned(64)));
+    size_t dequeue_pos __attribute__((aligned(64)));
+    int    sleeping __attribute__((aligned(64))); /* flusher is waiting for eventfd */
+    int    started;  /* flusher is running in this process */
+    int    efd;
+    int    sock;
+    pthread_mutex_t start_lock;
+    unsigned long queued;  /* notifications put to queue        */
+    unsigned long done;    /* notifications sent or failed      */
+    unsigned long dropped; /* notifications not put, queue full */
+    struct ntf_send_cell *cells;
+};
+
+/*
+ * Global variables
+ */
+static struct ntf_reliable_sender ntf_reliable = { .lock = PTHREAD_MUTEX_INITIALIZER, .sock = -1 };
+static struct ntf_send_queue ntf_send_queue = { .start_lock = PTHREAD_MUTEX_INITIALIZER,
+                                                .efd = -1, .sock = -1 };
+
+static int ntf_send_start();
+
 /*
  * Serialize notification
  */
@@ -224,11 +306,495 @@ static ntf_stat_t ntfproto_decode( struct ing_notification *notif,
     return NTF_ST_OK;
 }
 
+/*
+ * Milliseconds of monotonic clock
+ */
+static long long ntf_reliable_now_ms()
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/*
+ * Start reliable sender, once per process. Called under lock
+ */
+static int ntf_reliable_start()
+{
+    struct sockaddr_in addr = { 0 };
+    struct timespec now;
+
+    if ( ntf_reliable.sock >= 0 && ntf_reliable.pid == getpid() )
+        return 0;
+
+    /* socket of parent process is not shared with forked child */
+    if ( ntf_reliable.sock >= 0 )
+        close( ntf_reliable.sock );
+
+    ntf_reliable.sock = socket( AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_UDP );
+    if ( ntf_reliable.sock < 0 )
+        return -1;
+
+    addr.sin_family      = PF_INET;
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    addr.sin_port        = htons( NTF_PORT_SERVER );
+    if ( connect( ntf_reliable.sock, (struct sockaddr*)&addr, sizeof( addr ) ) != 0 )
+    {
+        ERR( "Cannot connect to notifier core, err %d (%s)", errno, strerror(errno) );
+        close( ntf_reliable.sock );
+        ntf_reliable.sock = -1;
+        return -1;
+    }
+
+    clock_gettime( CLOCK_REALTIME, &now );
+    ntf_reliable.pid      = getpid();
+    ntf_reliable.sender   = ( (uint32_t)ntf_reliable.pid * 2654435761u ) ^ (uint32_t)now.tv_nsec ^
+                            (uint32_t)now.tv_sec;
+    ntf_reliable.seq_next = 1;
+    ntf_reliable.acked    = 0;
+    ntf_reliable.rto      = NTF_RELIABLE_RTO_MS;
+    return 0;
+}
+
+/*
+ * Send notification with header carrying the current base of window
+ */
+static void ntf_reliable_transmit( struct ntf_reliable_msg *msg )
+{
+    char header[NTF_RELIABLE_HDR_LEN];
+    struct iovec iov[2];
+    struct msghdr mh = { 0 };
+    int len;
+
+    len = snprintf( header, sizeof( header ), "%cR;%08x;%llu;%llu;", NTF_RELIABLE_MARK,
+                    ntf_reliable.sender, (unsigned long long)msg->seq,
+                    (unsigned long long)( ntf_reliable.acked + 1 ) );
+
+    iov[0].iov_base = header;
+    iov[0].iov_len  = len;
+    iov[1].iov_base = msg->data;
+    iov[1].iov_len  = msg->len;
+    mh.msg_iov    = iov;
+    mh.msg_iovlen = 2;
+
+    /* lost notification is retransmitted */
+    if ( sendmsg( ntf_reliable.sock, &mh, 0 ) < 0 )
+        LOG( "Cannot send reliable notification %llu, err %d (%s)",
+             (unsigned long long)msg->seq, errno, strerror(errno) );
+}
+
+/*
+ * Read acks of core waiting up to 'timeout_ms' for the first one
+ */
+static void ntf_reliable_read_acks( int timeout_ms )
+{
+    struct pollfd pfd = { .fd = ntf_reliable.sock, .events = POLLIN };
+    char buffer[NTF_RELIABLE_HDR_LEN];
+    unsigned long long seq;
+    unsigned sender;
+    ssize_t len;
+
+    if ( poll( &pfd, 1, timeout_ms ) <= 0 )
+        return;
+
+    while ( ( len = recv( ntf_reliable.sock, buffer, sizeof( buffer ) - 1, MSG_DONTWAIT ) ) > 0 )
+    {
+        buffer[len] = '\0';
+        if ( sscanf( buffer, "!A;%x;%llu;", &sender, &seq ) != 2 || sender != ntf_reliable.sender )
+            continue;
+        if ( seq > ntf_reliable.acked && seq < ntf_reliable.seq_next )
+            ntf_reliable.acked = seq;
+    }
+}
+
+/*
+ * Wait until notification 'seq' is acked, all notifications not acked
+ * are retransmitted on timeout which doubles every time
+ * Returns: 0 if acked, -1 on timeout
+ */
+static int ntf_reliable_wait( uint64_t seq )
+{
+    long long deadline, left;
+    int rto = NTF_RELIABLE_RTO_MS;
+    uint64_t n;
+    int retry;
+
+    for ( retry = 0; ; ++retry )
+    {
+        deadline = ntf_reliable_now_ms() + rto;
+        while ( ntf_reliable.acked < seq && ( left = deadline - ntf_reliable_now_ms() ) > 0 )
+            ntf_reliable_read_acks( (int)left );
+
+        if ( ntf_reliable.acked >= seq )
+            return 0;
+        if ( retry == NTF_RELIABLE_RETRIES - 1 )
+            return -1;
+
+        for ( n = ntf_reliable.acked + 1; n < ntf_reliable.seq_next; ++n )
+            ntf_reliable_transmit( &ntf_reliable.window[n % NTF_RELIABLE_WINDOW] );
+        rto *= 2;
+    }
+}
+
+/*
+ * Retransmit notifications left not acked after their sending timed out,
+ * retransmit timeout doubles up to NTF_RELIABLE_RTO_MAX_MS. Called under lock
+ * Returns: number of notifications not acked
+ */
+static uint64_t ntf_reliable_resend()
+{
+    long long now;
+    uint64_t n;
+
+    if ( ntf_reliable.sock < 0 || ntf_reliable.pid != getpid() )
+        return 0;
+
+    ntf_reliable_read_acks( 0 );
+    if ( ntf_reliable.acked + 1 >= ntf_reliable.seq_next )
+        return 0;
+
+    now = ntf_reliable_now_ms();
+    if ( now >= ntf_reliable.resend_ms )
+    {
+        for ( n = ntf_reliable.acked + 1; n < ntf_reliable.seq_next; ++n )
+            ntf_reliable_transmit( &ntf_reliable.window[n % NTF_RELIABLE_WINDOW] );
+
+        ntf_reliable.rto = ( ntf_reliable.rto * 2 < NTF_RELIABLE_RTO_MAX_MS ) ?
+                           ntf_reliable.rto * 2 : NTF_RELIABLE_RTO_MAX_MS;
+        ntf_reliable.resend_ms = now + ntf_reliable.rto;
+    }
+
+    return ntf_reliable.seq_next - 1 - ntf_reliable.acked;
+}
+
+/*
+ * Send notification reliably: it is kept in window until core acks it
+ */
+static ntf_stat_t ntf_reliable_send( const char *buffer, size_t len )
+{
+    struct ntf_reliable_msg *msg;
+    ntf_stat_t res;
+
+    pthread_mutex_lock( &ntf_reliable.lock );
+
+    if ( ntf_reliable_start() != 0 )
+    {
+        pthread_mutex_unlock( &ntf_reliable.lock );
+        return NTF_ST_FAIL_NETWORK_OPERATION;
+    }
+
+    ntf_reliable_read_acks( 0 );
+
+    /* window is full, the oldest notification must be acked first */
+    if ( ntf_reliable.seq_next - ntf_reliable.acked > NTF_RELIABLE_WINDOW &&
+         ntf_reliable_wait( ntf_reliable.acked + 1 ) != 0 )
+    {
+        pthread_mutex_unlock( &ntf_reliable.lock );
+        ERR( "Notifier core does not ack, %d notifications are waiting", NTF_RELIABLE_WINDOW );
+        return NTF_ST_FAIL_NETWORK_OPERATION;
+    }
+
+    msg = &ntf_reliable.window[ntf_reliable.seq_next % NTF_RELIABLE_WINDOW];
+    msg->seq = ntf_reliable.seq_next++;
+    msg->len = len;
+    memcpy( msg->data, buffer, len );
+
+    ntf_reliable_transmit( msg );
+    res = ( ntf_reliable_wait( msg->seq ) == 0 ) ? NTF_ST_OK : NTF_ST_TIMEOUT;
+    if ( res == NTF_ST_TIMEOUT )
+    {
+        ntf_reliable.rto       = NTF_RELIABLE_RTO_MS << NTF_RELIABLE_RETRIES;
+        ntf_reliable.resend_ms = ntf_reliable_now_ms() + ntf_reliable.rto;
+    }
+
+    pthread_mutex_unlock( &ntf_reliable.lock );
+
+    /* notification left not acked is retransmitted by flusher thread */
+    if ( res == NTF_ST_TIMEOUT && !__atomic_load_n( &ntf_send_queue.started, __ATOMIC_ACQUIRE ) )
+        ntf_send_start();
+    return res;
+}
+
+/*
+ * Send batch of notifications to core with one call
+ */
+static void ntf_send_batch( struct mmsghdr *msgs, int num )
+{
+    int done = 0, n;
+
+    while ( done < num )
+    {
+        n = sendmmsg( ntf_send_queue.sock, msgs + done, num - done, 0 );
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n <= 0 )
+        {
+            /* the failed notification is skipped */
+            LOG( "Cannot send notification to the notifier core, err %d (%s)", errno, strerror(errno) );
+            n = 1;
+        }
+        done += n;
+    }
+}
+
+/*
+ * Flusher thread: queued notifications are sent in batches
+ */
+static void* ntf_send_flusher( void __attribute__((__unused__)) *arg )
+{
+    struct ntf_send_queue *q = &ntf_send_queue;
+    struct mmsghdr msgs[NTF_SEND_BATCH_MAX];
+    struct iovec iovs[NTF_SEND_BATCH_MAX];
+    struct sockaddr_in addr = { 0 };
+    struct pollfd pfd = { .fd = q->efd, .events = POLLIN };
+    struct ntf_send_cell *cell;
+    unsigned long dropped, reported = 0;
+    long long now, report_time = 0;
+    eventfd_t value;
+    size_t pos;
+    int n, i, timeout;
+
+    pthread_setname_np( pthread_self(), "ntf-flusher" );
+
+    addr.sin_family      = PF_INET;
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    addr.sin_port        = htons( NTF_PORT_SERVER );
+    memset( msgs, 0, sizeof( msgs ) );
+
+    for ( ;; )
+    {
+        /* take ready cells, they are freed once batch is sent */
+        pos = q->dequeue_pos;
+        for ( n = 0; n < NTF_SEND_BATCH_MAX; ++n )
+        {
+            cell = &q->cells[( pos + n ) & ( NTF_SEND_QUEUE_LEN - 1 )];
+            if ( __atomic_load_n( &cell->seq, __ATOMIC_ACQUIRE ) != pos + n + 1 )
+                break;
+            if ( cell->flags & NTF_MSG_RELIABLE )
+            {
+                /* reliable one is sent alone after the ones before it */
+                if ( n == 0 )
+                {
+                    ntf_reliable_send( cell->data, cell->len );
+                    n = 1;
+                }
+                break;
+            }
+
+            iovs[n].iov_base = cell->data;
+            iovs[n].iov_len  = cell->len;
+            msgs[n].msg_hdr.msg_iov     = &iovs[n];
+            msgs[n].msg_hdr.msg_iovlen  = 1;
+            msgs[n].msg_hdr.msg_name    = &addr;
+            msgs[n].msg_hdr.msg_namelen = sizeof( addr );
+        }
+
+        if ( n > 0 )
+        {
+            if ( !( q->cells[pos & ( NTF_SEND_QUEUE_LEN - 1 )].flags & NTF_MSG_RELIABLE ) )
+                ntf_send_batch( msgs, n );
+
+            for ( i = 0; i < n; ++i )
+                __atomic_store_n( &q->cells[( pos + i ) & ( NTF_SEND_QUEUE_LEN - 1 )].seq,
+                                  pos + i + NTF_SEND_QUEUE_LEN, __ATOMIC_RELEASE );
+            q->dequeue_pos = pos + n;
+            __atomic_add_fetch( &q->done, n, __ATOMIC_RELEASE );
+            continue;
+        }
+
+        /* drops are reported once per idle period at most */
+        dropped = __atomic_load_n( &q->dropped, __ATOMIC_RELAXED );
+        now     = ntf_reliable_now_ms();
+        if ( dropped != reported && now - report_time >= NTF_SEND_IDLE_MS )
+        {
+            ERR( "%lu notification(s) dropped, send queue is full", dropped - reported );
+            reported    = dropped;
+            report_time = now;
+        }
+
+        /* reliable notifications left not acked are retransmitted until acked,
+         * if lock is taken the sending thread retransmits them itself */
+        timeout = NTF_SEND_IDLE_MS;
+        if ( pthread_mutex_trylock( &ntf_reliable.lock ) == 0 )
+        {
+            if ( ntf_reliable_resend() > 0 && ntf_reliable.resend_ms - now < timeout )
+                timeout = ( ntf_reliable.resend_ms > now ) ? (int)( ntf_reliable.resend_ms - now ) : 1;
+            pthread_mutex_unlock( &ntf_reliable.lock );
+        }
+
+        /* queue is checked again after flag is set, so wakeup is not lost */
+        __atomic_store_n( &q->sleeping, 1, __ATOMIC_SEQ_CST );
+        cell = &q->cells[q->dequeue_pos & ( NTF_SEND_QUEUE_LEN - 1 )];
+        if ( __atomic_load_n( &cell->seq, __ATOMIC_SEQ_CST ) == q->dequeue_pos + 1 )
+        {
+            __atomic_store_n( &q->sleeping, 0, __ATOMIC_RELAXED );
+            continue;
+        }
+        if ( poll( &pfd, 1, timeout ) > 0 )
+            eventfd_read( q->efd, &value );
+        __atomic_store_n( &q->sleeping, 0, __ATOMIC_RELAXED );
+    }
+
+    return NULL;
+}
+
+/*
+ * Flusher thread does not exist in forked child, it is started again
+ */
+static void ntf_send_atfork_child()
+{
+    __atomic_store_n( &ntf_send_queue.started, 0, __ATOMIC_RELEASE );
+}
+
+/*
+ * Start flusher thread on the first notification queued in process
+ * Returns: 0 on success, -1 on error
+ */
+static int ntf_send_start()
+{
+    struct ntf_send_queue *q = &ntf_send_queue;
+    static int atfork_registered = 0;
+    pthread_attr_t attr;
+    pthread_t thread;
+    size_t i;
+    int res = -1;
+
+    pthread_mutex_lock( &q->start_lock );
+
+    if ( q->started )
+    {
+        pthread_mutex_unlock( &q->start_lock );
+        return 0;
+    }
+
+    /* queue of parent process is dropped in forked child */
+    if ( q->cells == NULL )
+        q->cells = malloc( NTF_SEND_QUEUE_LEN * sizeof( struct ntf_send_cell ) );
+    if ( q->cells == NULL )
+        goto out;
+    for ( i = 0; i < NTF_SEND_QUEUE_LEN; ++i )
+        q->cells[i].seq = i;
+    q->enqueue_pos = q->dequeue_pos = 0;
+    q->queued = q->done = q->dropped = 0;
+    q->sleeping = 0;
+
+    if ( q->efd >= 0 )
+        close( q->efd );
+    if ( q->sock >= 0 )
+        close( q->sock );
+    q->efd  = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+    q->sock = socket( AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_UDP );
+    if ( q->efd < 0 || q->sock < 0 )
+        goto out;
+
+    if ( !atfork_registered && pthread_atfork( NULL, NULL, ntf_send_atfork_child ) == 0 )
+        atfork_registered = 1;
+
+    pthread_attr_init( &attr );
+    pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+    if ( pthread_create( &thread, &attr, ntf_send_flusher, NULL ) == 0 )
+    {
+        __atomic_store_n( &q->started, 1, __ATOMIC_RELEASE );
+        res = 0;
+    }
+    pthread_attr_destroy( &attr );
+
+out:
+    pthread_mutex_unlock( &q->start_lock );
+    if ( res != 0 )
+        ERR( "Cannot start notification flusher, err %d (%s)", errno, strerror(errno) );
+    return res;
+}
+
+/*
+ * Put notification to queue of flusher without blocking
+ * Returns: 0 on success, -1 if queue is full
+ */
+static int ntf_send_enqueue( const char *buffer, size_t len, int flags )
+{
+    struct ntf_send_queue *q = &ntf_send_queue;
+    struct ntf_send_cell *cell;
+    size_t pos, seq;
+
+    if ( !__atomic_load_n( &q->started, __ATOMIC_ACQUIRE ) && ntf_send_start() != 0 )
+        return -1;
+
+    pos = __atomic_load_n( &q->enqueue_pos, __ATOMIC_RELAXED );
+    for ( ;; )
+    {
+        cell = &q->cells[pos & ( NTF_SEND_QUEUE_LEN - 1 )];
+        seq  = __atomic_load_n( &cell->seq, __ATOMIC_ACQUIRE );
+        if ( seq == pos )
+        {
+            if ( __atomic_compare_exchange_n( &q->enqueue_pos, &pos, pos + 1, 1,
+                                              __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+                break;
+        }
+        else if ( (intptr_t)( seq - pos ) < 0 )
+        {
+            __atomic_add_fetch( &q->dropped, 1, __ATOMIC_RELAXED );
+            return -1;
+        }
+        else
+            pos = __atomic_load_n( &q->enqueue_pos, __ATOMIC_RELAXED );
+    }
+
+    memcpy( cell->data, buffer, len );
+    cell->len   = len;
+    cell->flags = flags;
+    __atomic_store_n( &cell->seq, pos + 1, __ATOMIC_SEQ_CST );
+    __atomic_add_fetch( &q->queued, 1, __ATOMIC_RELAXED );
+
+    if ( __atomic_exchange_n( &q->sleeping, 0, __ATOMIC_SEQ_CST ) )
+        eventfd_write( q->efd, 1 );
+    return 0;
+}
+
+/*
+ * Wait until notifications queued with NTF_MSG_DONOTWAIT are sent and
+ * reliable ones left not acked are acked
+ */
+ntf_stat_t ing_notification_flush( unsigned long timeout_ms )
+{
+    struct ntf_send_queue *q = &ntf_send_queue;
+    unsigned long queued;
+    long long deadline, now, wait;
+    ntf_stat_t res = NTF_ST_OK;
+
+    deadline = ntf_reliable_now_ms() + timeout_ms;
+    if ( __atomic_load_n( &q->started, __ATOMIC_ACQUIRE ) )
+    {
+        queued = __atomic_load_n( &q->queued, __ATOMIC_RELAXED );
+        while ( (long)( __atomic_load_n( &q->done, __ATOMIC_ACQUIRE ) - queued ) < 0 )
+        {
+            if ( ntf_reliable_now_ms() >= deadline )
+                return NTF_ST_TIMEOUT;
+            usleep( 1000 );
+        }
+    }
+
+    pthread_mutex_lock( &ntf_reliable.lock );
+    while ( ntf_reliable_resend() > 0 )
+    {
+        now = ntf_reliable_now_ms();
+        if ( now >= deadline )
+        {
+            res = NTF_ST_TIMEOUT;
+            break;
+        }
+        wait = ( ntf_reliable.resend_ms < deadline ) ? ntf_reliable.resend_ms - now : deadline - now;
+        ntf_reliable_read_acks( ( wait > 0 ) ? (int)wait : 1 );
+    }
+    pthread_mutex_unlock( &ntf_reliable.lock );
+
+    return res;
+}
+
 /*
  * Send notification
  */
-ntf_stat_t ing_notification_send( struct ing_notification *notif,
-                                  int __attribute__((__unused__)) flags )
+ntf_stat_t ing_notification_send( struct ing_notification *notif, int flags )
 {
     char buffer[NTF_STR_MSG_BUFFER_LEN];
     ntf_stat_t res;
@@ -241,6 +807,17 @@ ntf_stat_t ing_notification_send( struct ing_notification *notif,
     if ( ntfproto_encode( notif, buffer, &len ) != NTF_ST_OK )
         return NTF_ST_BAD_INPUT_PARAMS;
 
+    /* not logged, logging may block */
+    if ( flags & NTF_MSG_DONOTWAIT )
+        return ( ntf_send_enqueue( buffer, len, flags ) == 0 ) ? NTF_ST_OK : NTF_ST_NOMEMORY;
+
+    if ( flags & NTF_MSG_RELIABLE )
+    {
+        res = ntf_reliable_send( buffer, len );
+        LOG( "Notification [%.*s] is sent reliably to the notifier core: %lu", (int)len, buffer, res );
+        return res;
+    }
+
     sock = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
     if ( sock == -1 )
         return NTF_ST_GENERAL_ERROR;
@@ -369,3 +946,13 @@ ntf_stat_t ing_notification_recv( int listener_handle, char *listener_name,
                            param_pool, pool_len );
     return res;
 }
+
+/*
+ * Decode notification received from notifier core
+ */
+ntf_stat_t ing_notification_decode( char *buffer, size_t buff_len,
+                                    struct ing_notification *notif,
+                                    char *param_pool, size_t *pool_len )
+{
+    return ntfproto_decode( notif, buffer, buff_len, param_pool, pool_len );
+}
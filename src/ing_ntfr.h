@@ -98,6 +98,7 @@
  */
 #define NTF_MSG_DONOTWAIT 1
 #define NTF_MSG_WAIT      0
+#define NTF_MSG_RELIABLE  2 /* send: wait for ack of notifier core, retransmit if lost */
 
 /*
  * Limiths
@@ -143,10 +144,39 @@ typedef struct ing_notification
  *
  * Input:
  *  notif - pointer to notification structure
- *  flags - additional flags for notificator
+ *  flags - additional flags for notificator, NTF_MSG_RELIABLE for
+ *          at-least-once delivery: notification is numbered and kept
+ *          until notifier core acks it, sending waits for the ack up to
+ *          75 ms retransmitting it;
+ *          NTF_MSG_DONOTWAIT to put notification to the queue of library
+ *          and return immediately, queue is sent by background thread
+ *          (reliably if NTF_MSG_RELIABLE is set too)
+ *
+ * Output:
+ *  NTF_ST_OK if notification is sent (and acked if it is reliable) or queued,
+ *  NTF_ST_TIMEOUT if reliable notification is not acked yet, it is kept
+ *  and retransmitted with next reliable notification,
+ *  NTF_ST_NOMEMORY if queue is full
+ *
+ * Order: core with several receive shards ('recv_shards') keeps order of
+ * notifications sent from one socket only. Queued and reliable notifications
+ * of a process are sent from its own socket for each of the two kinds, others
+ * are sent from a new socket every time and may be passed on in other order
  */
 ntf_stat_t ing_notification_send( struct ing_notification *notif, int flags );
 
+/*
+ * Wait until notifications queued with NTF_MSG_DONOTWAIT are sent and
+ * reliable notifications left not acked are acked, to be called before exit
+ *
+ * Input:
+ *  timeout_ms - max time to wait
+ *
+ * Output:
+ *  NTF_ST_OK if all are sent, NTF_ST_TIMEOUT otherwise
+ */
+ntf_stat_t ing_notification_flush( unsigned long timeout_ms );
+
 /*
  * Create listener handler
  *
@@ -188,4 +218,18 @@ ntf_stat_t ing_notification_recv( int listener_handle, char *listener_name,
                                   struct ing_notification *notif, int flags,
                                   char *param_pool, size_t *pool_len );
 
+/*
+ * Decode notification received from notifier core
+ *
+ * Input:
+ *  buffer     - serialized notification
+ *  buff_len   - length of serialized notification
+ *  notif      - pointer to notification stricture for decoding
+ *  param_pool - pool for storing parameters value
+ *  pool_len   - length of parameter pool
+ */
+ntf_stat_t ing_notification_decode( char *buffer, size_t buff_len,
+                                    struct ing_notification *notif,
+                                    char *param_pool, size_t *pool_len );
+
 #endif /* ING_NTFR_H */
@@ -0,0 +1,278 @@
+/* ing_ntfr_bench_recv.c
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains benchmark of receiving side of notifier core:
+ * producer threads send notifications to the core, each from its own
+ * socket, and the benchmark counts them on logger listener port.
+ * Core is run with 'logger_listener_enabled' set and ntfrlog stopped,
+ * once for every value of 'recv_shards' to be compared
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "ing_ntfr.h"
+#include "ing_ntfr_defines.h"
+
+#define BENCH_PRODUCERS_DEF  (4)
+#define BENCH_PRODUCERS_MAX  (64)
+#define BENCH_SECONDS_DEF    (5)
+#define BENCH_BATCH          (32)
+#define BENCH_RCVBUF         (8 * 1024 * 1024)
+
+/*
+ * Producer: sends "msg_id;module_id;severity;2;<producer>;<seq>;" as fast
+ * as it can, 'seq' lets the counter check order per producer
+ */
+struct bench_producer
+{
+    int idx;
+    pthread_t thread;
+    unsigned long sent;
+    unsigned long forwarded;
+    unsigned long reordered;
+    long last_seq;
+};
+
+static struct bench_producer bench_producers[BENCH_PRODUCERS_MAX];
+static int bench_producers_num = BENCH_PRODUCERS_DEF;
+static volatile int bench_stop = 0;
+
+static double bench_now()
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void* bench_produce( void *arg )
+{
+    struct bench_producer *p = arg;
+    char buffers[BENCH_BATCH][NTF_STR_MSG_BUFFER_LEN];
+    struct mmsghdr msgs[BENCH_BATCH];
+    struct iovec iovs[BENCH_BATCH];
+    struct sockaddr_in addr;
+    unsigned long seq = 0;
+    int sock, i, n;
+
+    memset( &addr, 0, sizeof( addr ) );
+    addr.sin_family      = PF_INET;
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    addr.sin_port        = htons( NTF_PORT_SERVER );
+
+    /* one socket per producer, so that its notifications go to one shard */
+    sock = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+    if ( sock < 0 || connect( sock, (struct sockaddr*)&addr, sizeof( addr ) ) < 0 )
+    {
+        fprintf( stderr, "producer %d: cannot open socket: %s\n", p->idx, strerror(errno) );
+        return NULL;
+    }
+
+    memset( msgs, 0, sizeof( msgs ) );
+    while ( !bench_stop )
+    {
+        for ( i = 0; i < BENCH_BATCH; ++i )
+        {
+            iovs[i].iov_base = buffers[i];
+            iovs[i].iov_len  = snprintf( buffers[i], NTF_STR_MSG_BUFFER_LEN, "%d;%d;%d;2;%d;%lu;",
+                                         7, 1, NTF_SEVERITY_INFO, p->idx, seq++ );
+            msgs[i].msg_hdr.msg_iov    = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        n = sendmmsg( sock, msgs, BENCH_BATCH, 0 );
+        if ( n > 0 )
+            p->sent += n;
+        /* sequence numbers of not sent ones are skipped */
+    }
+
+    close( sock );
+    return NULL;
+}
+
+/*
+ * Count notifications forwarded by core to listener socket 'sock'
+ */
+static void* bench_count( void *arg )
+{
+    int sock = *(int*)arg;
+    char buffers[BENCH_BATCH][NTF_STR_MSG_BUFFER_LEN + 1];
+    struct mmsghdr msgs[BENCH_BATCH];
+    struct iovec iovs[BENCH_BATCH];
+    struct bench_producer *p;
+    int idx, i, n;
+    long seq;
+
+    memset( msgs, 0, sizeof( msgs ) );
+    for ( i = 0; i < BENCH_BATCH; ++i )
+    {
+        iovs[i].iov_base = buffers[i];
+        iovs[i].iov_len  = NTF_STR_MSG_BUFFER_LEN;
+        msgs[i].msg_hdr.msg_iov    = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    /* socket receive timeout lets the stop flag be checked */
+    while ( bench_stop < 2 )
+    {
+        n = recvmmsg( sock, msgs, BENCH_BATCH, MSG_WAITFORONE, NULL );
+        for ( i = 0; i < n; ++i )
+        {
+            buffers[i][msgs[i].msg_len] = '\0';
+            if ( sscanf( buffers[i], "%*d;%*d;%*d;%*d;%d;%ld;", &idx, &seq ) != 2 ||
+                 idx < 0 || idx >= bench_producers_num )
+                continue;
+
+            p = &bench_producers[idx];
+            p->forwarded++;
+            if ( seq < p->last_seq )
+                p->reordered++;
+            p->last_seq = seq;
+        }
+    }
+
+    return NULL;
+}
+
+int main( int argc, char *argv[] )
+{
+    int seconds = BENCH_SECONDS_DEF, rcvbuf = BENCH_RCVBUF;
+    unsigned long sent = 0, forwarded = 0, reordered = 0;
+    pthread_t counter;
+    double start, elapsed;
+    int sock, i;
+
+    if ( argc > 1 && atoi( argv[1] ) > 0 )
+        bench_producers_num = atoi( argv[1] );
+    if ( bench_producers_num > BENCH_PRODUCERS_MAX )
+        bench_producers_num = BENCH_PRODUCERS_MAX;
+    if ( argc > 2 && atoi( argv[2] ) > 0 )
+        seconds = atoi( argv[2] );
+
+    sock = ing_listener_init( NTF_PORT_LISTENER_LOGGER, 1 );
+    if ( sock < 0 )
+    {
+        fprintf( stderr, "cannot listen on port %d, is ntfrlog running?\n", NTF_PORT_LISTENER_LOGGER );
+        return 1;
+    }
+    setsockopt( sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof( rcvbuf ) );
+    pthread_create( &counter, NULL, &bench_count, &sock );
+
+    start = bench_now();
+    for ( i = 0; i < bench_producers_num; ++i )
+    {
+        bench_producers[i].idx = i;
+        bench_producers[i].last_seq = -1;
+        pthread_create( &bench_producers[i].thread, NULL, &bench_produce, &bench_producers[i] );
+    }
+
+    sleep( seconds );
+    bench_stop = 1;
+    for ( i = 0; i < bench_producers_num; ++i )
+        pthread_join( bench_producers[i].thread, NULL );
+    elapsed = bench_now() - start;
+
+    /* the rest is drained from socket buffers */
+    sleep( 1 );
+    bench_stop = 2;
+    pthread_join( counter, NULL );
+    ing_listener_free( sock );
+
+    for ( i = 0; i < bench_producers_num; ++i )
+    {
+        printf( "producer %2d: %10lu sent %10lu forwarded %6lu out of order\n", i,
+                bench_producers[i].sent, bench_producers[i].forwarded, bench_producers[i].reordered );
+        sent      += bench_producers[i].sent;
+        forwarded += bench_producers[i].forwarded;
+        reordered += bench_producers[i].reordered;
+    }
+
+    /* shards scale with CPUs, numbers of single CPU show overhead only */
+    printf( "%d producer(s), %ld CPU(s), %.1f s\n", bench_producers_num,
+            sysconf( _SC_NPROCESSORS_ONLN ), elapsed );
+    printf( "sent:      %10.0f msg/s\n", sent / elapsed );
+    printf( "forwarded: %10.0f msg/s (%.1f%% of sent)\n", forwarded / elapsed,
+            sent ? 100.0 * forwarded / sent : 0.0 );
+    printf( "out of order: %lu\n", reordered );
+
+    return 0;
+}
@@ -0,0 +1,210 @@
+/* ing_ntfr_bench_xml.c
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains benchmark of NETCONF notification XML building:
+ * microxml tree (former listener implementation) against compiled
+ * template of NETCONF listener, both made of the same db entry
+ */
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <microxml.h>
+
+#include "ing_ntfr_defines.h"
+#include "ing_ntfr_messages.h"
+#include "ing_ntfr_listeners.h"
+
+#define BENCH_ITERATIONS_DEF  (200000)
+#define BENCH_MSGSIZE         (1024)
+#define BENCH_PARAMSIZE       (256)
+
+extern struct ntf_netconf_db_entry ntf_netconf_db[NTF_MAX_DB_MESSAGE_NUM];
+
+/*
+ * Sample notification: link down with parameters converted to YANG values
+ */
+static char *bench_values[] = { "eth0", "1", "2" };
+#define BENCH_PARAM_NUM  ( sizeof( bench_values ) / sizeof( bench_values[0] ) )
+
+/*
+ * Build message as former listener did: parse template of db entry
+ * to tree, add nodes and save tree to string
+ */
+static size_t bench_mxml( struct ntf_netconf_db_entry *entry, struct ing_notification *notif,
+                          char *buf, size_t size )
+{
+    char value[BENCH_PARAMSIZE];
+    mxml_node_t *xml_notif, *node;
+    int i;
+
+    xml_notif = mxmlLoadString( NULL, entry->template, MXML_OPAQUE_CALLBACK );
+    if ( xml_notif == NULL )
+        return 0;
+
+    node = mxmlFindElement( xml_notif, xml_notif, "type", NULL, NULL, MXML_DESCEND );
+    mxmlNewText( node, 0, entry->type );
+    node = mxmlFindElement( xml_notif, xml_notif, "content", NULL, NULL, MXML_DESCEND );
+    for ( i = 0; i < entry->param_num; ++i )
+    {
+        memset( value, 0, sizeof( value ) );
+        if ( entry->params[i].convert_func == NULL ||
+             entry->params[i].convert_func( notif->params[i], value, NULL ) != 0 )
+            strncpy( value, notif->params[i], sizeof( value ) - 1 );
+        mxmlNewText( mxmlNewElement( node, entry->params[i].par_info ), 0, value );
+    }
+
+    memset( buf, 0, size );
+    if ( mxmlSaveString( xml_notif, buf, size, MXML_NO_CALLBACK ) <= 0 )
+        buf[0] = '\0';
+
+    mxmlDelete( xml_notif );
+    return strlen( buf );
+}
+
+/*
+ * Build the same message with compiled template as NETCONF listener does
+ */
+static size_t bench_template( struct ing_notification *notif, char *buf, size_t size )
+{
+    ssize_t len;
+
+    len = ntf_netconf_prepare( notif, buf, size );
+    return ( len > 0 ) ? (size_t)len : 0;
+}
+
+static double bench_now()
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main( int argc, char *argv[] )
+{
+    static char buf[BENCH_MSGSIZE];
+    struct ntf_netconf_db_entry *entry = NULL;
+    struct ing_notification notif;
+    long iterations = BENCH_ITERATIONS_DEF;
+    size_t len = 0, i;
+    double start, mxml_ns, template_ns;
+    long n;
+
+    if ( argc > 1 && atol( argv[1] ) > 0 )
+        iterations = atol( argv[1] );
+
+    memset( &notif, 0, sizeof( notif ) );
+    notif.msg_id    = NTF_MSG_LINKDOWN;
+    notif.severity  = NTF_SEVERITY_ERROR;
+    notif.param_num = BENCH_PARAM_NUM;
+    for ( i = 0; i < BENCH_PARAM_NUM; ++i )
+        notif.params[i] = bench_values[i];
+
+    for ( i = 0; i < NTF_MAX_DB_MESSAGE_NUM && ntf_netconf_db[i].msg_id != NTF_MSG_NOTUSED; ++i )
+    {
+        if ( ntf_netconf_db[i].msg_id == notif.msg_id )
+            entry = &ntf_netconf_db[i];
+    }
+
+    /* templates are compiled by listener init */
+    if ( entry == NULL || ntf_netconf_init( NULL ) != 0 )
+    {
+        fprintf( stderr, "Cannot initialize NETCONF listener\n" );
+        return 1;
+    }
+
+    /* show messages to check they are the same */
+    bench_mxml( entry, &notif, buf, sizeof( buf ) );
+    printf( "mxml:     %s\n", buf );
+    bench_template( &notif, buf, sizeof( buf ) );
+    printf( "template: %s\n", buf );
+
+    start = bench_now();
+    for ( n = 0; n < iterations; ++n )
+        len += bench_mxml( entry, &notif, buf, sizeof( buf ) );
+    mxml_ns = ( bench_now() - start ) / iterations;
+
+    start = bench_now();
+    for ( n = 0; n < iterations; ++n )
+        len += bench_template( &notif, buf, sizeof( buf ) );
+    template_ns = ( bench_now() - start ) / iterations;
+
+    printf( "%ld iterations (%zu bytes)\n", iterations, len );
+    printf( "mxml:     %8.1f ns/msg\n", mxml_ns );
+    printf( "template: %8.1f ns/msg (x%.1f)\n", template_ns, mxml_ns / template_ns );
+
+    ntf_netconf_clean();
+    return 0;
+}
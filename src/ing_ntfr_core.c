@@ -76,6 +76,7 @@
 #define _GNU_SOURCE
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
 #include <unistd.h>
@@ -85,12 +86,21 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <errno.h>
+#include <libgen.h>
+#include <poll.h>
 #include <sys/inotify.h>
 #include <time.h>
+#include <signal.h>
 
 #include "ing_ntfr_defines.h"
 #include "ing_ntfr_listeners.h"
 #include "ing_ntfr_settings.h"
+#include "ing_ntfr_ratelimit.h"
+#include "ing_ntfr_plugins.h"
+#include "ing_ntfr_journal.h"
+#include "ing_ntfr_reliable.h"
+#include "ing_ntfr_threads.h"
+#include "ing_ntfr_metrics.h"
 
 
 /*
@@ -130,47 +140,297 @@ static int ntf_core_sockets_init( int *recv_sock, int *send_sock )
 }
 
 
-int ntf_get_syslog_enabled( char *buffer, size_t buff_len)
+int ntf_get_syslog_enabled( void )
 {
-    if (!ntfsettings_get( "syslog_listener_enabled", buffer, buff_len ) && !strcmp("true", buffer))
-        return 1;
+    int enabled = 0;
 
-    return 0;
+    ntfsettings_get_bool( "syslog_listener_enabled", &enabled );
+    return enabled;
 }
 
-int ntf_get_netconf_enabled( char *buffer, size_t buff_len)
+int ntf_get_netconf_enabled( void )
 {
-    if (!ntfsettings_get( "netconf_listener_enabled", buffer, buff_len ) && !strcmp("true", buffer))
-        return 1;
+    int enabled = 0;
 
-    return 0;
+    ntfsettings_get_bool( "netconf_listener_enabled", &enabled );
+    return enabled;
 }
 
-int ntf_get_logger_enabled( char *buffer, size_t buff_len)
+int ntf_get_logger_enabled( void )
 {
-    if (!ntfsettings_get( "logger_listener_enabled", buffer, buff_len ) && !strcmp("true", buffer))
-        return 1;
+    int enabled = 0;
 
-    return 0;
+    ntfsettings_get_bool( "logger_listener_enabled", &enabled );
+    return enabled;
 }
 
-int ntf_get_snmp_enabled( char *buffer, size_t buff_len)
+int ntf_get_snmp_enabled( void )
 {
-    if (!ntfsettings_get( "snmp_listener_enabled", buffer, buff_len ) && !strcmp("true", buffer))
-        return 1;
+    int enabled = 0;
+
+    ntfsettings_get_bool( "snmp_listener_enabled", &enabled );
+    return enabled;
+}
+
+int ntf_get_mmx_enabled( void )
+{
+    int enabled = 0;
+
+    ntfsettings_get_bool( "mmx_listener_enabled", &enabled );
+    return enabled;
+}
+
+
+/*
+ * Get msg_id, module_id and severity from header of serialized notification
+ * ("msg_id;module_id;severity;param_num;...")
+ */
+static int ntf_core_parse_header( char *buffer, int *msg_id, int *module_id, int *severity )
+{
+    char *pos, *end;
+
+    pos = buffer;
+    *msg_id = (int)strtol( pos, &end, 10 );
+    if ( end == pos || *end != ';' )
+        return -1;
+
+    pos = end + 1;
+    *module_id = (int)strtol( pos, &end, 10 );
+    if ( end == pos || *end != ';' )
+        return -1;
+
+    pos = end + 1;
+    *severity = (int)strtol( pos, &end, 10 );
+    if ( end == pos || *end != ';' )
+        return -1;
 
     return 0;
 }
 
-int ntf_get_mmx_enabled( char *buffer, size_t buff_len)
+
+/*
+ * Listener is enabled in configuration
+ */
+static int ntf_core_listener_wanted( int idx )
 {
-    if (!ntfsettings_get( "mmx_listener_enabled", buffer, buff_len) && !strcmp("true", buffer))
+    switch ( idx )
     {
-        return 1;
+    case NTF_LISTENER_LOGGER:
+        return ntf_get_logger_enabled();
+    case NTF_LISTENER_SYSLOG:
+        return ntf_get_syslog_enabled();
+    case NTF_LISTENER_SNMP:
+        return ntf_get_snmp_enabled();
+    case NTF_LISTENER_NETCONF:
+        return ntf_get_netconf_enabled();
+    case NTF_LISTENER_MMX:
+        return ntf_get_mmx_enabled();
+    default:
+        return 0;
     }
-    return 0;
 }
 
+/*
+ * Generation of forwarding, bumped by main thread when forwarding to a
+ * listener is disabled. Receive shards acknowledge it between notifications
+ */
+static unsigned long ntf_core_generation = 0;
+
+static int ntf_core_shards_passed( unsigned long generation );
+
+/* SIGTERM or SIGINT is received, core stops */
+static volatile sig_atomic_t ntf_core_exit = 0;
+
+static void ntf_core_signal( int __attribute__((__unused__)) sig )
+{
+    ntf_core_exit = 1;
+}
+
+/*
+ * Catch SIGTERM and SIGINT. They are blocked in all threads, threads
+ * created later inherit the mask, and main thread unblocks them only
+ * while it waits in ppoll(), so it is woken up at once
+ * 'wait_mask' is set to signal mask to be used while waiting
+ */
+static void ntf_core_signals_init( sigset_t *wait_mask )
+{
+    struct sigaction sa;
+    sigset_t mask;
+
+    memset( &sa, 0, sizeof( sa ) );
+    sa.sa_handler = &ntf_core_signal;
+    sigemptyset( &sa.sa_mask );
+    sigaction( SIGTERM, &sa, NULL );
+    sigaction( SIGINT, &sa, NULL );
+
+    sigemptyset( &mask );
+    sigaddset( &mask, SIGTERM );
+    sigaddset( &mask, SIGINT );
+    pthread_sigmask( SIG_BLOCK, &mask, wait_mask );
+    sigdelset( wait_mask, SIGTERM );
+    sigdelset( wait_mask, SIGINT );
+}
+
+/* '<name>_listener_enabled' is changed, set by settings update in core thread */
+static int ntf_core_listeners_changed = 0;
+
+static void ntf_core_listener_notify( const char *key, const char *value, void *arg )
+{
+    ntf_core_listeners_changed = 1;
+}
+
+/*
+ * Start listener thread, listener without thread function (logger) is
+ * a separate process, notifications are just forwarded to it
+ */
+static void ntf_core_listener_start( struct ntf_listener *listener )
+{
+    if ( listener->func == NULL && listener->batch == NULL )
+    {
+        __atomic_store_n( &listener->enabled, 1, __ATOMIC_RELEASE );
+        listener->state = NTF_LISTENER_RUNNING;
+        LOG( "%s listener enabled", listener->name );
+        return;
+    }
+
+    listener->stop   = 0;
+    listener->ready  = 0;
+    listener->exited = 0;
+    if ( pthread_create( &listener->thread_id, NULL, &ntf_handler, listener ) != 0 )
+    {
+        ERR( "Cannot create pthread for %s handler", listener->name );
+        listener->wanted = 0;
+        return;
+    }
+
+    listener->state = NTF_LISTENER_STARTING;
+    LOG( "%s listener thread id: %lu", listener->name, listener->thread_id );
+}
+
+/*
+ * Stop listener gracefully: notifications are not forwarded to it any
+ * more; once receive shards have finished sending notifications they got
+ * before, its handler processes everything left in its socket and exits
+ */
+static void ntf_core_listener_stop( struct ntf_listener *listener )
+{
+    __atomic_store_n( &listener->enabled, 0, __ATOMIC_SEQ_CST );
+
+    if ( listener->func == NULL && listener->batch == NULL )
+    {
+        listener->state = NTF_LISTENER_STOPPED;
+        LOG( "%s listener disabled", listener->name );
+        return;
+    }
+
+    listener->disabled_generation = __atomic_add_fetch( &ntf_core_generation, 1, __ATOMIC_SEQ_CST );
+    listener->state = NTF_LISTENER_DISABLING;
+    LOG( "%s listener is stopping", listener->name );
+}
+
+/*
+ * Let handler of disabled listener drain its socket and exit
+ */
+static void ntf_core_listener_drain( struct ntf_listener *listener )
+{
+    __atomic_store_n( &listener->stop, 1, __ATOMIC_RELEASE );
+    listener->state = NTF_LISTENER_STOPPING;
+}
+
+/*
+ * Bring listener threads to state required by configuration
+ * Returns: 1 if some listener is starting or stopping, 0 otherwise
+ */
+static int ntf_core_listeners_update( struct ntf_listener *listeners )
+{
+    struct ntf_listener *listener;
+    int i, reload, busy = 0;
+
+    reload = ntf_core_listeners_changed;
+    ntf_core_listeners_changed = 0;
+
+    for ( i = 0; i < NTF_LISTENER_LAST; ++i )
+    {
+        listener = &listeners[i];
+        if ( reload )
+            listener->wanted = ntf_core_listener_wanted( i );
+
+        /* handler has exited: stopped, or failed to start */
+        if ( listener->state != NTF_LISTENER_STOPPED &&
+             __atomic_load_n( &listener->exited, __ATOMIC_ACQUIRE ) )
+        {
+            pthread_join( listener->thread_id, NULL );
+            if ( listener->state != NTF_LISTENER_STOPPING )
+            {
+                ERR( "%s listener has stopped unexpectedly", listener->name );
+                listener->wanted = 0;
+            }
+            else
+                LOG( "%s listener stopped", listener->name );
+            __atomic_store_n( &listener->enabled, 0, __ATOMIC_SEQ_CST );
+            listener->exited  = 0;
+            listener->state   = NTF_LISTENER_STOPPED;
+        }
+
+        switch ( listener->state )
+        {
+        case NTF_LISTENER_STOPPED:
+            if ( listener->wanted )
+                ntf_core_listener_start( listener );
+            break;
+        case NTF_LISTENER_STARTING:
+            if ( __atomic_load_n( &listener->ready, __ATOMIC_ACQUIRE ) )
+            {
+                __atomic_store_n( &listener->enabled, 1, __ATOMIC_RELEASE );
+                listener->state = NTF_LISTENER_RUNNING;
+            }
+            break;
+        case NTF_LISTENER_RUNNING:
+            if ( !listener->wanted )
+                ntf_core_listener_stop( listener );
+            break;
+        case NTF_LISTENER_DISABLING:
+            if ( ntf_core_shards_passed( listener->disabled_generation ) )
+                ntf_core_listener_drain( listener );
+            break;
+        default:
+            break;
+        }
+
+        if ( listener->state == NTF_LISTENER_STARTING || listener->state == NTF_LISTENER_DISABLING ||
+             listener->state == NTF_LISTENER_STOPPING )
+            busy = 1;
+    }
+
+    return busy;
+}
+
+/*
+ * Stop all listeners and wait until they process their notifications,
+ * receive shards are stopped already
+ */
+static void ntf_core_listeners_free( struct ntf_listener *listeners )
+{
+    char key[NTF_LISTENER_NAME_LEN + sizeof( "_listener_enabled" )];
+    int i;
+
+    for ( i = 0; i < NTF_LISTENER_LAST; ++i )
+    {
+        snprintf( key, sizeof( key ), "%s_listener_enabled", listeners[i].name );
+        ntfsettings_unsubscribe( key, &ntf_core_listener_notify, NULL );
+
+        if ( listeners[i].state == NTF_LISTENER_STOPPED )
+            continue;
+
+        if ( listeners[i].state == NTF_LISTENER_STARTING || listeners[i].state == NTF_LISTENER_RUNNING )
+            ntf_core_listener_stop( &listeners[i] );
+        if ( listeners[i].state == NTF_LISTENER_DISABLING )
+            ntf_core_listener_drain( &listeners[i] );
+        if ( listeners[i].state == NTF_LISTENER_STOPPING )
+            pthread_join( listeners[i].thread_id, NULL );
+        listeners[i].state = NTF_LISTENER_STOPPED;
+    }
+}
 
 static void ntf_core_sockets_free( int *recv_sock, int *send_sock )
 {
@@ -178,39 +438,378 @@ static void ntf_core_sockets_free( int *recv_sock, int *send_sock )
     close( *recv_sock );
 }
 
+/*
+ * Watch directory of configuration file: editors often write a new
+ * file and rename it over the old one, so the file itself is not watched
+ * Returns: inotify descriptor, -1 if configuration file is polled instead
+ */
+static int ntf_core_conf_watch()
+{
+    char path[] = NTF_CONF_FILE_NAME;
+    int fd;
+
+    fd = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+    if ( fd < 0 )
+    {
+        ERR( "inotify_init1() failed: %s (%d), configuration is polled", strerror(errno), errno );
+        return -1;
+    }
+
+    if ( inotify_add_watch( fd, dirname( path ),
+                            IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE ) < 0 )
+    {
+        ERR( "inotify_add_watch() failed: %s (%d), configuration is polled", strerror(errno), errno );
+        close( fd );
+        return -1;
+    }
+
+    return fd;
+}
+
+/*
+ * Read pending inotify events
+ * Returns: 1 if configuration file has changed, 0 otherwise
+ */
+static int ntf_core_conf_changed( int fd )
+{
+    char path[] = NTF_CONF_FILE_NAME;
+    char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    const struct inotify_event *event;
+    const char *name;
+    ssize_t len, pos;
+    int changed = 0;
+
+    name = basename( path );
+    while ( ( len = read( fd, events, sizeof( events ) ) ) > 0 )
+    {
+        for ( pos = 0; pos < len; pos += sizeof( struct inotify_event ) + event->len )
+        {
+            event = (const struct inotify_event *)( events + pos );
+            if ( event->len > 0 && strcmp( event->name, name ) == 0 )
+                changed = 1;
+        }
+    }
+
+    return changed;
+}
+
+/*
+ * Reload configuration, all consumers are updated only if file
+ * contents have changed
+ */
+static void ntf_core_conf_reload()
+{
+    if ( ntf_settings_update() == 0 )
+        ntf_ratelimit_load();
+}
+
+/*
+ * Milliseconds from 'from' to 'to'
+ */
+static long ntf_core_elapsed_ms( struct timespec *from, struct timespec *to )
+{
+    return ( to->tv_sec - from->tv_sec ) * 1000 + ( to->tv_nsec - from->tv_nsec ) / 1000000;
+}
+
+/* journal of received notifications, open if 'journal_dir' is set */
+static struct ntf_journal ntf_core_journal;
+static int ntf_core_journal_on = 0;
+
+/*
+ * Open journal of received notifications if it is configured, changes
+ * of journal settings take effect on restart
+ */
+static void ntf_core_journal_start()
+{
+    char dir[256] = { 0 };
+    long size     = NTF_JOURNAL_SEGMENT_LEN;
+    long segments = NTF_JOURNAL_SEGMENTS;
+    long sync_ms  = NTF_JOURNAL_SYNC_MS;
+
+    if ( ntfsettings_get( "journal_dir", dir, sizeof( dir ) ) != 0 || dir[0] == '\0' )
+        return;
+    ntfsettings_get_int( "journal_segment_size", &size );
+    ntfsettings_get_int( "journal_segments", &segments );
+    ntfsettings_get_duration( "journal_sync_interval", &sync_ms );
+
+    if ( size <= 0 || ntf_journal_open( &ntf_core_journal, dir, size, segments, sync_ms ) != 0 )
+    {
+        ERR( "Cannot open journal in %s, notifications are not journaled", dir );
+        return;
+    }
+    ntf_core_journal_on = 1;
+}
+
+/*
+ * Receive shard: socket bound to server port with SO_REUSEPORT and the
+ * thread draining it. Kernel selects socket by hash of sender address and
+ * port, so notifications sent from one socket are handled by one shard in
+ * order they are sent; order of notifications of different sockets is not kept
+ */
+struct ntf_core_shard
+{
+    int idx;
+    int recv_sock;
+    int send_sock;
+    int stop;
+    pthread_t thread;
+    struct ntf_listener *listeners;
+    unsigned long generation; /* ntf_core_generation seen between notifications */
+    unsigned long received;  /* notifications received by shard      */
+    unsigned long reported;  /* value of 'received' on previous report */
+};
+
+/* shard 0 is served by main thread, the rest by their own threads */
+static struct ntf_core_shard ntf_core_shards[NTF_CORE_RECV_SHARDS_MAX];
+static int ntf_core_shards_num = 1;
+
+/*
+ * Pass received notification on: it is checked against rate limits,
+ * journaled and sent to enabled listeners and plugins; reliable sender
+ * is acked once notification is passed on
+ */
+static void ntf_core_forward( struct ntf_core_shard *shard, char *buffer, int len,
+                              struct sockaddr_in *from )
+{
+    struct ntf_listener *listeners = shard->listeners;
+    struct sockaddr_in send_addr;
+    int msg_id, module_id, severity;
+    size_t msg_len;
+    void *ack = NULL;
+    int i, res;
+
+    __atomic_add_fetch( &shard->received, 1, __ATOMIC_RELAXED );
+    ntf_metrics_count( NTF_SCOPE_CORE, NTF_METRIC_RECEIVED, 1 );
+
+    /* header of reliable notification is removed, duplicates are only acked */
+    if ( len > 0 && buffer[0] == NTF_RELIABLE_MARK )
+    {
+        msg_len = (size_t)len;
+        len = ( ntf_reliable_receive( buffer, &msg_len, from, &ack ) == 1 ) ? (int)msg_len : -1;
+    }
+
+    msg_id = -1;
+    if ( len >= 0 &&
+         ntf_core_parse_header( buffer, &msg_id, &module_id, &severity ) == 0 &&
+         !ntf_ratelimit_allow( msg_id, module_id, severity ) )
+    {
+        /* notification is over its rate limit, drop it */
+        ntf_metrics_count( NTF_SCOPE_CORE, NTF_METRIC_DROPPED, 1 );
+    }
+    else if ( len >= 0 )
+    {
+        /* notification is kept before it is passed on */
+        if ( ntf_core_journal_on )
+            ntf_journal_append( &ntf_core_journal, buffer, (size_t)len, msg_id );
+
+        memset( (void*)&send_addr, 0, sizeof( struct sockaddr_in ) );
+        send_addr.sin_family      = PF_INET;
+        send_addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+
+        for( i = 0; i < NTF_LISTENER_LAST; ++i )
+        {
+            /* listeners are started and stopped by main thread */
+            if ( !__atomic_load_n( &listeners[i].enabled, __ATOMIC_RELAXED ) )
+                continue;
+            send_addr.sin_port = htons( listeners[i].port );
+
+            res = sendto( shard->send_sock,
+                          (void*)buffer, (size_t)len,
+                          0,
+                          (struct sockaddr*)&send_addr,
+                          sizeof( struct sockaddr_in) );
+            if ( res < 0 )
+            {
+                ERR("Failed to send ntf to listener port %u, err: %d (%s)",
+                    listeners[i].port, errno, strerror(errno) );
+                ntf_metrics_count( listeners[i].metrics_scope, NTF_METRIC_SEND_FAILED, 1 );
+            }
+            else
+                ntf_metrics_count( listeners[i].metrics_scope, NTF_METRIC_FORWARDED, 1 );
+        }
+
+        /* plugins get the notification in-process */
+        ntf_plugins_dispatch( buffer, (size_t)len );
+    }
+
+    ntf_reliable_ack( shard->recv_sock, ack );
+}
+
+/*
+ * Thread of additional receive shard
+ */
+static void* ntf_core_shard_thread( void *arg )
+{
+    struct ntf_core_shard *shard = arg;
+    char buffer[NTF_STR_MSG_BUFFER_LEN + NTF_RELIABLE_HDR_LEN + 1];
+    struct sockaddr_in from;
+    socklen_t from_len;
+    char name[16];
+    int res;
+
+    snprintf( name, sizeof( name ), "ntf-core%d", shard->idx );
+    ntf_thread_setup( "core", name );
+
+    /* socket receive timeout lets the stop flag be checked */
+    while ( !__atomic_load_n( &shard->stop, __ATOMIC_ACQUIRE ) )
+    {
+        /* nothing is being sent to listeners disabled before this point */
+        __atomic_store_n( &shard->generation,
+                          __atomic_load_n( &ntf_core_generation, __ATOMIC_SEQ_CST ), __ATOMIC_RELEASE );
+
+        from_len = sizeof( from );
+        res = recvfrom( shard->recv_sock, (void*)&buffer[0], sizeof( buffer ) - 1, 0,
+                        (struct sockaddr*)&from, &from_len );
+        if ( res < 0 )
+        {
+            if ( errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR )
+                ERR( "shard %d: failed to receive msg, err %d (%s)",
+                     shard->idx, errno, strerror(errno) );
+            continue;
+        }
+
+        buffer[res] = '\0';
+        ntf_core_forward( shard, buffer, res, &from );
+    }
+
+    return NULL;
+}
+
+/*
+ * Open receive sockets of additional shards and start their threads,
+ * 'recv_sock' of shard 0 is already bound with SO_REUSEPORT
+ */
+static void ntf_core_shards_start( int num, struct sockaddr_in *recv_addr, struct timeval *waittime )
+{
+    struct ntf_core_shard *shard;
+    int i, reuse = 1;
+
+    for ( i = 1; i < num; ++i )
+    {
+        shard = &ntf_core_shards[i];
+        shard->idx       = i;
+        shard->listeners = ntf_core_shards[0].listeners;
+
+        if ( ntf_core_sockets_init( &shard->recv_sock, &shard->send_sock ) != 0 )
+            break;
+
+        if ( setsockopt( shard->recv_sock, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof( reuse ) ) < 0 ||
+             setsockopt( shard->recv_sock, SOL_SOCKET, SO_RCVTIMEO,
+                         (void*)waittime, sizeof( struct timeval ) ) < 0 ||
+             bind( shard->recv_sock, (struct sockaddr*)recv_addr, sizeof( struct sockaddr_in ) ) < 0 ||
+             pthread_create( &shard->thread, NULL, &ntf_core_shard_thread, shard ) != 0 )
+        {
+            ERR( "Cannot start receive shard %d, err %d (%s)", i, errno, strerror(errno) );
+            ntf_core_sockets_free( &shard->recv_sock, &shard->send_sock );
+            break;
+        }
+    }
+
+    ntf_core_shards_num = i;
+    LOG( "%d receive shard(s) on port %u", ntf_core_shards_num, NTF_PORT_SERVER );
+}
+
+/*
+ * Additional shards have passed 'generation': notifications they are
+ * forwarding now were received after listeners were disabled. Shard 0 is
+ * served by main thread, which disables listeners
+ */
+static int ntf_core_shards_passed( unsigned long generation )
+{
+    int i;
+
+    for ( i = 1; i < ntf_core_shards_num; ++i )
+        if ( __atomic_load_n( &ntf_core_shards[i].generation, __ATOMIC_ACQUIRE ) < generation )
+            return 0;
+
+    return 1;
+}
+
+/*
+ * Stop threads of additional shards and close their sockets
+ */
+static void ntf_core_shards_stop()
+{
+    int i;
+
+    /* shutdown() wakes up thread waiting in recvfrom() */
+    for ( i = 1; i < ntf_core_shards_num; ++i )
+    {
+        __atomic_store_n( &ntf_core_shards[i].stop, 1, __ATOMIC_RELEASE );
+        shutdown( ntf_core_shards[i].recv_sock, SHUT_RD );
+    }
+
+    for ( i = 1; i < ntf_core_shards_num; ++i )
+    {
+        pthread_join( ntf_core_shards[i].thread, NULL );
+        ntf_core_sockets_free( &ntf_core_shards[i].recv_sock, &ntf_core_shards[i].send_sock );
+    }
+    ntf_core_shards_num = 1;
+}
+
+/*
+ * Log number of notifications received by every shard since previous report
+ */
+static void ntf_core_shards_report()
+{
+    unsigned long received;
+    int i;
+
+    if ( ntf_core_shards_num < 2 )
+        return;
+
+    for ( i = 0; i < ntf_core_shards_num; ++i )
+    {
+        received = __atomic_load_n( &ntf_core_shards[i].received, __ATOMIC_RELAXED );
+        if ( received == ntf_core_shards[i].reported )
+            continue;
+        INF( "shard %d: %lu notification(s) received (%lu total)",
+              i, received - ntf_core_shards[i].reported, received );
+        ntf_core_shards[i].reported = received;
+    }
+}
+
 /*
  * Main application thread
  */
 int main( int __attribute__((__unused__)) argc, char __attribute__((__unused__)) *argv[] )
 {
     int recv_sock, send_sock;
+    int conf_fd = -1, conf_changed;
+    long shards = 1;
+    int reuse = 1;
+    int poll_timeout, listeners_busy;
+    char key[NTF_LISTENER_NAME_LEN + sizeof( "_listener_enabled" )];
+    struct pollfd pfd[2];
+    struct timespec poll_time;
+    sigset_t wait_mask;
 
-    int res, i, name_size, subres;
-    char buffer[NTF_STR_MSG_BUFFER_LEN] = { 0 };
+    int res, i, name_size;
+    char buffer[NTF_STR_MSG_BUFFER_LEN + NTF_RELIABLE_HDR_LEN + 1] = { 0 };
+    struct sockaddr_in from;
+    socklen_t from_len;
     size_t timeout;
     struct timeval waittime;
-    struct timespec curr_time, old_time;
-    struct sockaddr_in recv_addr, send_addr, lo_addr;
+    struct timespec curr_time, old_time, conf_time;
+    struct sockaddr_in recv_addr, lo_addr;
     struct ntf_listener listeners[NTF_LISTENER_LAST];
 
     memset((char *)listeners, 0, sizeof(listeners));
 
     memset( (void*)&recv_addr, 0, sizeof( struct sockaddr_in ) );
-    memset( (void*)&send_addr, 0, sizeof( struct sockaddr_in ) );
     memset( (void*)&lo_addr,   0, sizeof( struct sockaddr_in ) );
 
     recv_addr.sin_family       = PF_INET;
     recv_addr.sin_port         = htons( NTF_PORT_SERVER );
     recv_addr.sin_addr.s_addr  = htonl( INADDR_ANY );
 
-    send_addr.sin_family       = PF_INET;
-    send_addr.sin_addr.s_addr  = htonl( INADDR_LOOPBACK );
-
     waittime.tv_sec  = 2;
     waittime.tv_usec = 0;
 
     name_size = sizeof(ntf_listener_t.name);
 
+    /* before any thread is created */
+    ntf_core_signals_init( &wait_mask );
 
     if ( ntfsettings_init() != 0 )
     {
@@ -222,21 +821,43 @@ int main( int __attribute__((__unused__)) argc, char __attribute__((__unused__))
 
 
     /* load values of keys */
-    ntfsettings_load( "snmp_srv" );
+    ntfsettings_load_type( "snmp_srv", NTF_SETTINGS_ADDRESSES );
     ntfsettings_load( "snmp_community" );
     ntfsettings_load( "syslog_srv" );
-    ntfsettings_load( "syslog_listener_enabled" );
-    ntfsettings_load( "netconf_listener_enabled" );
-    ntfsettings_load( "logger_listener_enabled" );
-    ntfsettings_load( "snmp_listener_enabled" );
-    ntfsettings_load( "mmx_listener_enabled" );
-
-
-    listeners[NTF_LISTENER_LOGGER].enabled = ntf_get_logger_enabled(&buffer[0], sizeof(buffer));
-    listeners[NTF_LISTENER_SYSLOG].enabled = ntf_get_syslog_enabled(&buffer[0], sizeof(buffer));
-    listeners[NTF_LISTENER_SNMP].enabled = ntf_get_snmp_enabled(&buffer[0], sizeof(buffer));
-    listeners[NTF_LISTENER_NETCONF].enabled = ntf_get_netconf_enabled(&buffer[0], sizeof(buffer));
-    listeners[NTF_LISTENER_MMX].enabled = ntf_get_mmx_enabled(&buffer[0], sizeof(buffer));
+    ntfsettings_load( "syslog_srv_2" );
+    ntfsettings_load( "syslog_srv_3" );
+    ntfsettings_load( "syslog_srv_4" );
+    ntfsettings_load( "syslog_format" );
+    ntfsettings_load( "syslog_sd_id" );
+    ntfsettings_load( "syslog_stream" );
+    ntfsettings_load_type( "syslog_listener_enabled", NTF_SETTINGS_BOOL );
+    ntfsettings_load_type( "netconf_listener_enabled", NTF_SETTINGS_BOOL );
+    ntfsettings_load_type( "logger_listener_enabled", NTF_SETTINGS_BOOL );
+    ntfsettings_load_type( "snmp_listener_enabled", NTF_SETTINGS_BOOL );
+    ntfsettings_load_type( "mmx_listener_enabled", NTF_SETTINGS_BOOL );
+    ntfsettings_load( "listener_queue_sched" );
+    ntfsettings_load_type( "syslog_listener_workers", NTF_SETTINGS_INT );
+    ntfsettings_load_type( "snmp_listener_workers", NTF_SETTINGS_INT );
+    ntfsettings_load_type( "netconf_listener_workers", NTF_SETTINGS_INT );
+    ntfsettings_load_type( "mmx_listener_workers", NTF_SETTINGS_INT );
+    ntfsettings_load_type( "mmx_coalesce_ms", NTF_SETTINGS_DURATION );
+    ntfsettings_load_type( "mmx_response_timeout_ms", NTF_SETTINGS_DURATION );
+    ntfsettings_load( "plugin_dir" );
+    ntfsettings_load_type( "netconf_envelope", NTF_SETTINGS_BOOL );
+    ntfsettings_load( "netconf_stream" );
+    ntfsettings_load( "netconf_replay" );
+    ntfsettings_load_type( "netconf_replay_size", NTF_SETTINGS_INT );
+    ntfsettings_load( "netconf_replay_file" );
+    ntfsettings_load( "journal_dir" );
+    ntfsettings_load_type( "journal_segment_size", NTF_SETTINGS_INT );
+    ntfsettings_load_type( "journal_segments", NTF_SETTINGS_INT );
+    ntfsettings_load_type( "journal_sync_interval", NTF_SETTINGS_DURATION );
+    ntfsettings_load_type( "recv_shards", NTF_SETTINGS_INT );
+    ntfsettings_load( "stats_socket" );
+
+    ntf_ratelimit_load();
+    ntf_threads_init();
+
     
     listeners[NTF_LISTENER_LOGGER].port  = NTF_PORT_LISTENER_LOGGER;
     listeners[NTF_LISTENER_LOGGER].init  = NULL;
@@ -247,27 +868,35 @@ int main( int __attribute__((__unused__)) argc, char __attribute__((__unused__))
     listeners[NTF_LISTENER_SYSLOG].port  = NTF_PORT_LISTENER_SYSLOG;
     listeners[NTF_LISTENER_SYSLOG].init  = &ntf_syslog_init;
     listeners[NTF_LISTENER_SYSLOG].func  = &ntf_call_syslog;
+    listeners[NTF_LISTENER_SYSLOG].batch = &ntf_call_syslog_batch;
     listeners[NTF_LISTENER_SYSLOG].clean = &ntf_syslog_clean;
+    listeners[NTF_LISTENER_SYSLOG].threadsafe = 1;
     strncpy((char *)listeners[NTF_LISTENER_SYSLOG].name, "syslog", name_size);
 
     listeners[NTF_LISTENER_SNMP].port  = NTF_PORT_LISTENER_SNMP; 
     listeners[NTF_LISTENER_SNMP].init  = &ntf_snmp_init;
     listeners[NTF_LISTENER_SNMP].func  = &ntf_call_snmp_trap;
     listeners[NTF_LISTENER_SNMP].clean = &ntf_snmp_clean;
+    listeners[NTF_LISTENER_SNMP].threadsafe = 1;
     strncpy((char *)listeners[NTF_LISTENER_SNMP].name, "snmp", name_size);
 
     listeners[NTF_LISTENER_NETCONF].port  = NTF_PORT_LISTENER_NETCONF;
     listeners[NTF_LISTENER_NETCONF].init  = &ntf_netconf_init;
     listeners[NTF_LISTENER_NETCONF].func  = &ntf_send_netconf_notif;
+    listeners[NTF_LISTENER_NETCONF].batch = &ntf_send_netconf_batch;
     listeners[NTF_LISTENER_NETCONF].clean = &ntf_netconf_clean;
+    listeners[NTF_LISTENER_NETCONF].threadsafe = 1;
     strncpy((char *)listeners[NTF_LISTENER_NETCONF].name, "netconf", name_size);
     
     listeners[NTF_LISTENER_MMX].port  = NTF_PORT_LISTENER_MMX;
     listeners[NTF_LISTENER_MMX].init  = &ntf_mmx_init;
     listeners[NTF_LISTENER_MMX].func  = &ntf_send_mmx_notif;
     listeners[NTF_LISTENER_MMX].clean = &ntf_mmx_clean;
+    listeners[NTF_LISTENER_MMX].threadsafe = 1;
     strncpy((char *)listeners[NTF_LISTENER_MMX].name, "mmx", name_size);
 
+    for ( i = 0; i < NTF_LISTENER_LAST; ++i )
+        listeners[i].metrics_scope = ntf_metrics_scope( listeners[i].name );
 
     /* initialize receive/send UDP sockets */
     if ( ntf_core_sockets_init( &recv_sock, &send_sock ) != 0 )
@@ -283,59 +912,35 @@ int main( int __attribute__((__unused__)) argc, char __attribute__((__unused__))
         goto reterr;
     }
 
-    if (listeners[NTF_LISTENER_SYSLOG].enabled) {
-        if ( pthread_create( &listeners[NTF_LISTENER_SYSLOG].thread_id,
-                             NULL, &ntf_handler, &listeners[NTF_LISTENER_SYSLOG] ) != 0 )
-        {
-            ERR( "Cannot create pthread for syslog handler" );
-            goto reterr;
-        }
-        LOG("Syslog listener thread id: %lu",listeners[NTF_LISTENER_SYSLOG].thread_id );
-    } else {
-        LOG("syslog listener disabled");
+    /* notifications are received by 'recv_shards' sockets sharing server
+     * port, number of shards is changed on restart */
+    ntfsettings_get_int( "recv_shards", &shards );
+    if ( shards < 1 || shards > NTF_CORE_RECV_SHARDS_MAX )
+    {
+        ERR( "recv_shards must be 1..%d, %ld is ignored", NTF_CORE_RECV_SHARDS_MAX, shards );
+        shards = 1;
     }
-
-
-    if (listeners[NTF_LISTENER_SNMP].enabled) {
-        if ( pthread_create( &listeners[NTF_LISTENER_SNMP].thread_id,
-            NULL, &ntf_handler, &listeners[NTF_LISTENER_SNMP] ) != 0 )
-        {
-            ERR( "Cannot create pthread for SNMP handler" );
-            goto reterr;
-        }
-        LOG("SNMP listener thread id: %lu",listeners[NTF_LISTENER_SNMP].thread_id );
-    } else {
-        LOG("SNMP listener disabled");
-     }
-
-     
- 
-    if (listeners[NTF_LISTENER_NETCONF].enabled) {
-        if ( pthread_create( &listeners[NTF_LISTENER_NETCONF].thread_id,
-            NULL, &ntf_handler, &listeners[NTF_LISTENER_NETCONF] ) != 0 )
-        {
-            ERR( "Cannot create pthread for NETCONF handler" );
-            goto reterr;
-        }
-        LOG("Netconf listener thread id: %lu",listeners[NTF_LISTENER_NETCONF].thread_id );
-    } else {
-        LOG("netconf listener disabled");
+    if ( shards > 1 &&
+         setsockopt( recv_sock, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof( reuse ) ) < 0 )
+    {
+        ERR( "Cannot set SO_REUSEPORT, only one receive shard is used, err %d (%s)",
+              errno, strerror(errno) );
+        shards = 1;
     }
-    
+    ntf_core_shards[0].recv_sock = recv_sock;
+    ntf_core_shards[0].send_sock = send_sock;
+    ntf_core_shards[0].listeners = listeners;
 
-    if (listeners[NTF_LISTENER_MMX].enabled) {
-        if ( pthread_create( &listeners[NTF_LISTENER_MMX].thread_id,
-            NULL, &ntf_handler, &listeners[NTF_LISTENER_MMX] ) != 0 )
-        {
-            ERR( "Cannot create pthread for MMX handler" );
-            goto reterr;
-        }
-        LOG("MMX listener thread id: %lu",listeners[NTF_LISTENER_MMX].thread_id );
-    } else {
-        LOG("mmx listener disabled");
+    /* start enabled listeners, they are started and stopped later
+     * when '<name>_listener_enabled' is changed */
+    for ( i = 0; i < NTF_LISTENER_LAST; ++i )
+    {
+        snprintf( key, sizeof( key ), "%s_listener_enabled", listeners[i].name );
+        ntfsettings_subscribe( key, &ntf_core_listener_notify, NULL );
     }
+    ntf_core_listeners_changed = 1;
+    ntf_core_listeners_update( listeners );
 
-    
     res = bind( recv_sock, (struct sockaddr*)&recv_addr, sizeof( struct sockaddr_in ) );
     if ( res < 0 )
     {
@@ -344,36 +949,82 @@ int main( int __attribute__((__unused__)) argc, char __attribute__((__unused__))
         goto reterr;
     }
 
+    if ( ntfsettings_get( "plugin_dir", buffer, sizeof( buffer ) ) != 0 )
+        strcpy( buffer, NTF_PLUGIN_DIR );
+    LOG( "%d plugin(s) loaded from %s", ntf_plugins_load( buffer ), buffer );
+
+    ntf_core_journal_start();
+
+    /* main thread is configured once threads not having settings are created */
+    ntf_thread_setup( "core", "ntf-core" );
+    ntf_core_shards_start( (int)shards, &recv_addr, &waittime );
+
+    /* statistics are not served if 'stats_socket' is set to empty value */
+    if ( ntfsettings_get( "stats_socket", buffer, sizeof( buffer ) ) != 0 )
+        strcpy( buffer, NTF_STATS_SOCKET_PATH );
+    if ( buffer[0] != '\0' )
+        ntf_metrics_start( buffer );
+
     INF( "Notifier core successfully started" );
 
+    conf_fd = ntf_core_conf_watch();
+    conf_changed = 0;
+
+    pfd[0].fd     = recv_sock;
+    pfd[0].events = POLLIN;
+    pfd[1].fd     = conf_fd;
+    pfd[1].events = POLLIN;
+
     clock_gettime( CLOCK_MONOTONIC, &old_time );
-    for( ;; )
+    while ( !ntf_core_exit )
     {
+        listeners_busy = ntf_core_listeners_update( listeners );
+
+        /* wait for notification, change of configuration file or
+         * end of debounce period of the change */
+        poll_timeout = listeners_busy ? NTF_CORE_LISTENER_POLL_MS : NTF_CORE_POLL_TIMEOUT_MS;
+        if ( conf_changed )
+        {
+            clock_gettime( CLOCK_MONOTONIC, &curr_time );
+            res = NTF_CONF_RELOAD_DEBOUNCE_MS - ntf_core_elapsed_ms( &conf_time, &curr_time );
+            if ( res < poll_timeout )
+                poll_timeout = ( res > 0 ) ? res : 0;
+        }
+        poll_time.tv_sec  = poll_timeout / 1000;
+        poll_time.tv_nsec = ( poll_timeout % 1000 ) * 1000000L;
+        if ( ppoll( pfd, conf_fd >= 0 ? 2 : 1, &poll_time, &wait_mask ) < 0 )
+        {
+            if ( errno != EINTR )
+            {
+                ERR("ppoll() failed, err %d (%s)", errno, strerror(errno));
+                goto reterr;
+            }
+            continue;
+        }
+
+        /* every event restarts debounce period, file is parsed once
+         * writer has finished */
+        if ( conf_fd >= 0 && ( pfd[1].revents & POLLIN ) && ntf_core_conf_changed( conf_fd ) )
+        {
+            clock_gettime( CLOCK_MONOTONIC, &conf_time );
+            conf_changed = 1;
+        }
+
         /* receive notification */
         memset( (void*)&buffer[0], 0, sizeof( buffer ) );
         memset( (void*)&curr_time, 0, sizeof( struct timespec ) );
 
-        res = recv( recv_sock, (void*)&buffer[0], NTF_STR_MSG_BUFFER_LEN, 0 );
+        res = -1;
+        if ( pfd[0].revents & POLLIN )
+        {
+            from_len = sizeof( from );
+            res = recvfrom( recv_sock, (void*)&buffer[0], sizeof( buffer ) - 1, MSG_DONTWAIT,
+                            (struct sockaddr*)&from, &from_len );
+        }
+
         if ( res >= 0 )
         {
-            /* receive notification */
-            for( i = 0; i < NTF_LISTENER_LAST; ++i )
-            {   
-                if (!listeners[i].enabled)
-                    continue;
-                send_addr.sin_port = htons( listeners[i].port );
-
-                subres = sendto( send_sock,
-                             (void*)&buffer[0], (size_t)res,
-                              0,
-                             (struct sockaddr*)&send_addr,
-                              sizeof( struct sockaddr_in) );
-                if ( subres < 0 )
-                {
-                    ERR("Failed to send ntf to listener port %u, err: %d (%s)",
-                        listeners[i].port, errno, strerror(errno) );
-                }
-            }
+            ntf_core_forward( &ntf_core_shards[0], buffer, res, &from );
         }
         else if ( res < -1 )
         {
@@ -389,21 +1040,44 @@ int main( int __attribute__((__unused__)) argc, char __attribute__((__unused__))
         clock_gettime( CLOCK_MONOTONIC, &curr_time );
         timeout = curr_time.tv_sec - old_time.tv_sec;
 
-        /* ToDo */
+        if ( conf_changed && ntf_core_elapsed_ms( &conf_time, &curr_time ) >= NTF_CONF_RELOAD_DEBOUNCE_MS )
+        {
+            INF( "%s has changed, reloading", NTF_CONF_FILE_NAME );
+            ntf_core_conf_reload();
+            conf_changed = 0;
+        }
+
         if ( timeout > NTF_CONF_FILE_MONITOR_TIMEOUT )
         {
-            ntf_settings_update();
+            /* no inotify, file is checked periodically */
+            if ( conf_fd < 0 )
+                ntf_core_conf_reload();
+            ntf_ratelimit_report();
+            ntf_reliable_report();
+            ntf_core_shards_report();
+            ntf_plugins_report();
+            if ( ntf_core_journal_on )
+                ntf_journal_report( &ntf_core_journal );
             memcpy( &old_time, &curr_time, sizeof( struct timespec ) );
         }
 
     }
 
+    INF( "Notifier core is stopping" );
     res = 0;
     goto out;
 
 reterr:
     res = -1;
 out:
+    ntf_metrics_stop();
+    ntf_core_shards_stop();
+    ntf_core_listeners_free( listeners );
+    if ( ntf_core_journal_on )
+        ntf_journal_close( &ntf_core_journal );
+    if ( conf_fd >= 0 )
+        close( conf_fd );
+    ntf_plugins_unload();
     ntf_core_sockets_free( &recv_sock, &send_sock );
     ntfsettings_free();
     return ( res );
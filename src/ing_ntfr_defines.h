@@ -84,6 +84,16 @@
  */
 #define NTF_CONF_FILE_NAME "/etc/ntfr.conf"
 
+/*
+ * Default directory of listener plugins
+ */
+#define NTF_PLUGIN_DIR "/usr/lib/ingntfr/plugins"
+
+/*
+ * Default path of local socket serving statistics of notifier core
+ */
+#define NTF_STATS_SOCKET_PATH "/var/run/ingnotifier.stats"
+
 /*
  * String limits
  */
@@ -103,6 +113,19 @@
 #define NTF_PORT_LISTENER_NETCONF  15013
 #define NTF_PORT_LISTENER_MMX      15014
 
+/*
+ * Reliable delivery (NTF_MSG_RELIABLE): notification is prefixed with
+ * "!R;<sender>;<seq>;<base>;" where <base> is the first sequence number
+ * not acked yet; core acks with "!A;<sender>;<seq>;" where <seq> is the
+ * last sequence number received with all preceding ones
+ */
+#define NTF_RELIABLE_MARK     '!'
+#define NTF_RELIABLE_HDR_LEN  64
+#define NTF_RELIABLE_WINDOW   32 /* notifications not acked kept by sender      */
+#define NTF_RELIABLE_RTO_MS   5  /* first retransmit timeout, doubled each time */
+#define NTF_RELIABLE_RETRIES  4  /* so sending waits for ack up to 75 ms        */
+#define NTF_RELIABLE_RTO_MAX_MS 1000 /* retransmit period of notifications left not acked */
+
 /*
  * Receiving timeout limits in seconds
  */
@@ -121,6 +144,10 @@
  */
 #define NTF_IFIDX_UPDATE_TIMEOUT 30 /* different in timestamp for update table */
 #define NTF_CONF_FILE_MONITOR_TIMEOUT 30
+#define NTF_CONF_RELOAD_DEBOUNCE_MS 250 /* configuration is reloaded when file is quiet */
+#define NTF_CORE_POLL_TIMEOUT_MS 2000
+#define NTF_CORE_LISTENER_POLL_MS 50 /* while listener is starting or stopping */
+#define NTF_CORE_RECV_SHARDS_MAX 16 /* receive sockets of core sharing server port */
 
 /*
  * Logging
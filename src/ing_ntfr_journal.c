@@ -0,0 +1,802 @@
+/* ing_ntfr_journal.c
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains persistent journal of received notifications
+ * kept in memory-mapped segment files
+ */
+
+#define _GNU_SOURCE
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ing_ntfr_defines.h"
+#include "ing_ntfr_journal.h"
+
+#define NTF_JOURNAL_ALIGN(len) ( ( (len) + 7 ) & ~(size_t)7 )
+
+/*
+ * Checksum of record, FNV-1a of data seeded with length and sequence number
+ */
+static uint32_t ntf_journal_check( const char *data, uint32_t len, uint64_t seq )
+{
+    uint32_t hash = 2166136261u ^ len ^ (uint32_t)seq;
+    uint32_t i;
+
+    for ( i = 0; i < len; ++i )
+        hash = ( hash ^ (unsigned char)data[i] ) * 16777619u;
+
+    return hash;
+}
+
+/*
+ * Realtime clock in nanoseconds
+ */
+static int64_t ntf_journal_now()
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_REALTIME, &now );
+    return (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/*
+ * Path of segment or index file
+ */
+static void ntf_journal_path( const char *dir, uint64_t seq, const char *ext, char *path, size_t size )
+{
+    snprintf( path, size, "%s/%020" PRIu64 ".%s", dir, seq, ext );
+}
+
+/*
+ * Map file of 'len' bytes, file is created and sized if 'create' is set
+ * Returns: mapping, NULL on error
+ */
+static void* ntf_journal_map( const char *path, size_t len, int create, int writable, int *fd )
+{
+    struct stat st;
+    void *map;
+
+    *fd = open( path, ( writable ? O_RDWR : O_RDONLY ) | ( create ? O_CREAT : 0 ) | O_CLOEXEC, 0600 );
+    if ( *fd < 0 )
+    {
+        ERR( "Cannot open journal file %s: %s (%d)", path, strerror(errno), errno );
+        return NULL;
+    }
+
+    if ( create && ftruncate( *fd, len ) != 0 )
+    {
+        ERR( "Cannot size journal file %s: %s (%d)", path, strerror(errno), errno );
+        goto reterr;
+    }
+
+    /* pages past the end of file cannot be accessed */
+    if ( !create && ( fstat( *fd, &st ) != 0 || (size_t)st.st_size < len ) )
+    {
+        ERR( "Journal file %s is truncated", path );
+        goto reterr;
+    }
+
+    map = mmap( NULL, len, PROT_READ | ( writable ? PROT_WRITE : 0 ), MAP_SHARED, *fd, 0 );
+    if ( map == MAP_FAILED )
+    {
+        ERR( "Cannot map journal file %s: %s (%d)", path, strerror(errno), errno );
+        goto reterr;
+    }
+
+    return map;
+
+reterr:
+    close( *fd );
+    *fd = -1;
+    return NULL;
+}
+
+/*
+ * Unmap segment and free it
+ */
+static void ntf_journal_segment_free( struct ntf_journal_segment *seg )
+{
+    if ( seg->index != NULL )
+        munmap( seg->index, seg->index_len );
+    if ( seg->hdr != NULL )
+        munmap( seg->hdr, seg->map_len );
+    if ( seg->index_fd >= 0 )
+        close( seg->index_fd );
+    if ( seg->fd >= 0 )
+        close( seg->fd );
+    free( seg );
+}
+
+/*
+ * Map segment files for reading or appending. Segment of another layout
+ * is not mapped for appending
+ * Returns: segment, NULL on error
+ */
+static struct ntf_journal_segment* ntf_journal_segment_open( const char *dir, uint64_t seq_first,
+                                                             size_t segment_size, int create,
+                                                             int writable )
+{
+    struct ntf_journal_segment *seg;
+    struct ntf_journal_header hdr;
+    char path[320];
+    uint32_t index_max;
+    int fd;
+
+    seg = calloc( 1, sizeof( struct ntf_journal_segment ) );
+    if ( seg == NULL )
+        return NULL;
+    seg->fd = seg->index_fd = -1;
+
+    ntf_journal_path( dir, seq_first, "jrn", path, sizeof( path ) );
+    if ( !create )
+    {
+        /* layout of existing segment is taken from its header */
+        fd = open( path, O_RDONLY | O_CLOEXEC );
+        if ( fd < 0 || pread( fd, &hdr, sizeof( hdr ), 0 ) != sizeof( hdr ) ||
+             hdr.magic != NTF_JOURNAL_MAGIC || hdr.version != NTF_JOURNAL_VERSION ||
+             hdr.seq_first != seq_first || hdr.segment_size < NTF_JOURNAL_SEGMENT_MIN ||
+             hdr.segment_size > UINT32_MAX || hdr.index_max == 0 ||
+             ( writable && hdr.segment_size != segment_size ) )
+        {
+            if ( fd >= 0 )
+                close( fd );
+            free( seg );
+            return NULL;
+        }
+        close( fd );
+        segment_size = hdr.segment_size;
+        index_max    = hdr.index_max;
+    }
+    else
+        index_max = segment_size / NTF_JOURNAL_ENTRY_AVG;
+
+    seg->hdr = ntf_journal_map( path, segment_size, create, writable, &seg->fd );
+    if ( seg->hdr == NULL )
+        goto reterr;
+    seg->map_len = segment_size;
+
+    seg->index_len = (size_t)index_max * sizeof( struct ntf_journal_index );
+    ntf_journal_path( dir, seq_first, "idx", path, sizeof( path ) );
+    seg->index = ntf_journal_map( path, seg->index_len, create || writable, writable, &seg->index_fd );
+    if ( seg->index == NULL )
+        goto reterr;
+
+    if ( create )
+    {
+        memset( seg->hdr, 0, sizeof( struct ntf_journal_header ) );
+        seg->hdr->magic        = NTF_JOURNAL_MAGIC;
+        seg->hdr->version      = NTF_JOURNAL_VERSION;
+        seg->hdr->segment_size = segment_size;
+        seg->hdr->seq_first    = seq_first;
+        seg->hdr->tail         = NTF_JOURNAL_HEADER_LEN;
+        seg->hdr->index_max    = index_max;
+    }
+
+    return seg;
+
+reterr:
+    ntf_journal_segment_free( seg );
+    return NULL;
+}
+
+/*
+ * Record at 'offset' of segment if it is valid
+ */
+static struct ntf_journal_record* ntf_journal_record( struct ntf_journal_segment *seg, uint64_t offset,
+                                                      uint64_t seq )
+{
+    struct ntf_journal_record *rec;
+
+    if ( offset < NTF_JOURNAL_HEADER_LEN || offset % 8 != 0 ||
+         offset + sizeof( struct ntf_journal_record ) > seg->map_len )
+        return NULL;
+
+    rec = (struct ntf_journal_record *)( (char *)seg->hdr + offset );
+    if ( rec->len == 0 || rec->seq != seq ||
+         rec->len > seg->map_len - offset - sizeof( struct ntf_journal_record ) ||
+         rec->check != ntf_journal_check( (char *)( rec + 1 ), rec->len, rec->seq ) )
+        return NULL;
+
+    return rec;
+}
+
+/*
+ * Find the last valid record of segment written before crash and rebuild
+ * header and index from records, they may be synced partially
+ */
+static void ntf_journal_recover( struct ntf_journal_segment *seg )
+{
+    struct ntf_journal_header *hdr = seg->hdr;
+    struct ntf_journal_record *rec;
+    uint64_t offset = NTF_JOURNAL_HEADER_LEN;
+    uint32_t n = 0;
+
+    while ( n < hdr->index_max &&
+            ( rec = ntf_journal_record( seg, offset, hdr->seq_first + n ) ) != NULL )
+    {
+        seg->index[n].time_ns = rec->time_ns;
+        seg->index[n].offset  = offset;
+        seg->index[n].msg_id  = rec->msg_id;
+        if ( n == 0 )
+            hdr->time_first = rec->time_ns;
+        hdr->time_last = rec->time_ns;
+        offset += NTF_JOURNAL_ALIGN( sizeof( struct ntf_journal_record ) + rec->len );
+        ++n;
+    }
+
+    hdr->count = n;
+    hdr->tail  = offset;
+}
+
+/*
+ * Sync range of mapping, start is aligned to page
+ */
+static void ntf_journal_msync( void *base, uint64_t from, uint64_t to )
+{
+    uint64_t page = sysconf( _SC_PAGESIZE );
+
+    from &= ~( page - 1 );
+    if ( to > from && msync( (char *)base + from, to - from, MS_SYNC ) != 0 )
+        ERR( "Cannot sync journal: %s (%d)", strerror(errno), errno );
+}
+
+/*
+ * Sync records and index entries appended since the last sync, 'tail'
+ * and 'count' are taken under lock
+ */
+static void ntf_journal_segment_sync( struct ntf_journal_segment *seg, uint64_t tail, uint32_t count )
+{
+    if ( tail <= seg->synced && count <= seg->index_synced )
+        return;
+
+    if ( seg->synced < NTF_JOURNAL_HEADER_LEN )
+        seg->synced = NTF_JOURNAL_HEADER_LEN;
+    ntf_journal_msync( seg->index, (uint64_t)seg->index_synced * sizeof( struct ntf_journal_index ),
+                       (uint64_t)count * sizeof( struct ntf_journal_index ) );
+    ntf_journal_msync( seg->hdr, seg->synced, tail );
+    ntf_journal_msync( seg->hdr, 0, NTF_JOURNAL_HEADER_LEN );
+
+    seg->synced       = tail;
+    seg->index_synced = count;
+}
+
+/*
+ * Compare sequence numbers for qsort
+ */
+static int ntf_journal_seq_cmp( const void *a, const void *b )
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+    return ( x > y ) - ( x < y );
+}
+
+/*
+ * List segment files of 'dir', oldest first
+ * Returns: number of segments, -1 on error; '*segments' is allocated
+ */
+static int ntf_journal_scan( const char *dir, uint64_t **segments, int *segments_size )
+{
+    struct dirent *ent;
+    uint64_t *grown;
+    char *end;
+    uint64_t seq;
+    int num = 0;
+    DIR *d;
+
+    d = opendir( dir );
+    if ( d == NULL )
+    {
+        ERR( "Cannot open journal directory %s: %s (%d)", dir, strerror(errno), errno );
+        return -1;
+    }
+
+    while ( ( ent = readdir( d ) ) != NULL )
+    {
+        seq = strtoull( ent->d_name, &end, 10 );
+        if ( end == ent->d_name || strcmp( end, ".jrn" ) != 0 )
+            continue;
+
+        if ( num == *segments_size )
+        {
+            grown = realloc( *segments, ( *segments_size ? *segments_size * 2 : 16 ) * sizeof( uint64_t ) );
+            if ( grown == NULL )
+                break;
+            *segments = grown;
+            *segments_size = *segments_size ? *segments_size * 2 : 16;
+        }
+        ( *segments )[num++] = seq;
+    }
+    closedir( d );
+
+    if ( num > 0 )
+        qsort( *segments, num, sizeof( uint64_t ), ntf_journal_seq_cmp );
+    return num;
+}
+
+/*
+ * Remove oldest segment files above limit. Called under lock
+ */
+static void ntf_journal_trim( struct ntf_journal *journal )
+{
+    char path[320];
+    int n;
+
+    for ( n = 0; journal->segments_num - n > journal->segments_max; ++n )
+    {
+        ntf_journal_path( journal->dir, journal->segments[n], "jrn", path, sizeof( path ) );
+        unlink( path );
+        ntf_journal_path( journal->dir, journal->segments[n], "idx", path, sizeof( path ) );
+        unlink( path );
+    }
+
+    if ( n > 0 )
+    {
+        journal->segments_num -= n;
+        memmove( journal->segments, journal->segments + n, journal->segments_num * sizeof( uint64_t ) );
+    }
+}
+
+/*
+ * Seal the active segment and start a new one. Called under lock
+ */
+static int ntf_journal_rotate( struct ntf_journal *journal )
+{
+    struct ntf_journal_segment *seg;
+    uint64_t *grown;
+
+    if ( journal->segments_num == journal->segments_size )
+    {
+        grown = realloc( journal->segments, ( journal->segments_size + 16 ) * sizeof( uint64_t ) );
+        if ( grown == NULL )
+            return -1;
+        journal->segments = grown;
+        journal->segments_size += 16;
+    }
+
+    seg = ntf_journal_segment_open( journal->dir, journal->seq_next, journal->segment_size, 1, 1 );
+    if ( seg == NULL )
+        return -1;
+
+    if ( journal->active != NULL )
+    {
+        if ( journal->thread_started )
+        {
+            /* unmapped by sync thread once it is synced */
+            journal->active->next = journal->sealed;
+            journal->sealed = journal->active;
+        }
+        else
+        {
+            ntf_journal_segment_sync( journal->active, journal->active->hdr->tail,
+                                      journal->active->hdr->count );
+            ntf_journal_segment_free( journal->active );
+        }
+    }
+    journal->active = seg;
+    journal->segments[journal->segments_num++] = journal->seq_next;
+
+    ntf_journal_trim( journal );
+    return 0;
+}
+
+/*
+ * Sync thread: records appended during 'sync_ms' are synced at once
+ */
+static void* ntf_journal_sync_thread( void *arg )
+{
+    struct ntf_journal *journal = arg;
+    struct ntf_journal_segment *seg, *sealed;
+    struct timespec deadline;
+    uint64_t tail;
+    uint32_t count;
+    int stop;
+
+    /* journal is used by tools too, so thread is only named */
+    pthread_setname_np( pthread_self(), "ntf-journal" );
+
+    pthread_mutex_lock( &journal->lock );
+    do
+    {
+        clock_gettime( CLOCK_REALTIME, &deadline );
+        deadline.tv_sec  += journal->sync_ms / 1000;
+        deadline.tv_nsec += ( journal->sync_ms % 1000 ) * 1000000;
+        if ( deadline.tv_nsec >= 1000000000 )
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        if ( !journal->stop )
+            pthread_cond_timedwait( &journal->cond, &journal->lock, &deadline );
+        stop = journal->stop;
+
+        sealed = journal->sealed;
+        journal->sealed = NULL;
+        seg = journal->active;
+        tail  = seg != NULL ? seg->hdr->tail : 0;
+        count = seg != NULL ? seg->hdr->count : 0;
+        pthread_mutex_unlock( &journal->lock );
+
+        /* appending goes on while records are synced */
+        if ( seg != NULL )
+            ntf_journal_segment_sync( seg, tail, count );
+        while ( sealed != NULL )
+        {
+            seg = sealed;
+            sealed = seg->next;
+            ntf_journal_segment_sync( seg, seg->hdr->tail, seg->hdr->count );
+            ntf_journal_segment_free( seg );
+        }
+
+        pthread_mutex_lock( &journal->lock );
+        journal->syncs++;
+    } while ( !stop );
+    pthread_mutex_unlock( &journal->lock );
+
+    return NULL;
+}
+
+/*
+ * Open journal
+ */
+int ntf_journal_open( struct ntf_journal *journal, const char *dir, size_t segment_size,
+                      int segments_max, long sync_ms )
+{
+    struct ntf_journal_segment *seg = NULL;
+    int num;
+
+    memset( journal, 0, sizeof( struct ntf_journal ) );
+    pthread_mutex_init( &journal->lock, NULL );
+    pthread_cond_init( &journal->cond, NULL );
+
+    if ( segment_size < NTF_JOURNAL_SEGMENT_MIN || segment_size > UINT32_MAX )
+    {
+        ERR( "Bad size of journal segment: %zu", segment_size );
+        return -1;
+    }
+    journal->segment_size = segment_size;
+    journal->segments_max = segments_max > 1 ? segments_max : 2;
+    journal->sync_ms      = sync_ms > 0 ? sync_ms : 0;
+    snprintf( journal->dir, sizeof( journal->dir ), "%s", dir );
+
+    if ( mkdir( dir, 0700 ) != 0 && errno != EEXIST )
+    {
+        ERR( "Cannot create journal directory %s: %s (%d)", dir, strerror(errno), errno );
+        return -1;
+    }
+
+    num = ntf_journal_scan( dir, &journal->segments, &journal->segments_size );
+    if ( num < 0 )
+        return -1;
+    journal->segments_num = num;
+
+    /* appending continues in the last segment */
+    if ( num > 0 )
+    {
+        seg = ntf_journal_segment_open( dir, journal->segments[num - 1], segment_size, 0, 1 );
+        if ( seg != NULL )
+        {
+            ntf_journal_recover( seg );
+            journal->active    = seg;
+            journal->seq_next  = seg->hdr->seq_first + seg->hdr->count;
+            journal->time_last = seg->hdr->time_last;
+            INF( "Journal %s: %d segment(s), appending at %" PRIu64, dir, num, journal->seq_next );
+        }
+        else
+        {
+            /* last segment is of other layout, it is only read */
+            seg = ntf_journal_segment_open( dir, journal->segments[num - 1], segment_size, 0, 0 );
+            if ( seg != NULL )
+            {
+                journal->seq_next  = seg->hdr->seq_first + seg->hdr->count;
+                journal->time_last = seg->hdr->time_last;
+                ntf_journal_segment_free( seg );
+            }
+            else
+                journal->seq_next = journal->segments[num - 1] + 1;
+        }
+    }
+
+    if ( journal->active == NULL && ntf_journal_rotate( journal ) != 0 )
+        goto reterr;
+
+    if ( journal->sync_ms > 0 )
+    {
+        if ( pthread_create( &journal->thread, NULL, ntf_journal_sync_thread, journal ) != 0 )
+        {
+            ERR( "Cannot start journal sync thread, every record is synced" );
+            journal->sync_ms = 0;
+        }
+        else
+            journal->thread_started = 1;
+    }
+
+    return 0;
+
+reterr:
+    free( journal->segments );
+    journal->segments = NULL;
+    return -1;
+}
+
+/*
+ * Append notification with the current time
+ */
+int ntf_journal_append( struct ntf_journal *journal, const char *data, size_t len, int msg_id )
+{
+    struct ntf_journal_segment *seg;
+    struct ntf_journal_record *rec;
+    struct ntf_journal_header *hdr;
+    size_t need;
+    int64_t now;
+
+    need = NTF_JOURNAL_ALIGN( sizeof( struct ntf_journal_record ) + len );
+    if ( len == 0 || need > journal->segment_size - NTF_JOURNAL_HEADER_LEN )
+        return -1;
+
+    pthread_mutex_lock( &journal->lock );
+
+    seg = journal->active;
+    if ( seg == NULL || seg->hdr->tail + need > seg->hdr->segment_size ||
+         seg->hdr->count >= seg->hdr->index_max )
+    {
+        if ( ntf_journal_rotate( journal ) != 0 )
+        {
+            pthread_mutex_unlock( &journal->lock );
+            return -1;
+        }
+        seg = journal->active;
+    }
+    hdr = seg->hdr;
+
+    /* time never decreases, so that index is searched by time */
+    now = ntf_journal_now();
+    if ( now < journal->time_last )
+        now = journal->time_last;
+    journal->time_last = now;
+
+    rec = (struct ntf_journal_record *)( (char *)hdr + hdr->tail );
+    memcpy( rec + 1, data, len );
+    rec->len      = len;
+    rec->seq      = journal->seq_next;
+    rec->time_ns  = now;
+    rec->msg_id   = msg_id;
+    rec->reserved = 0;
+    rec->check    = ntf_journal_check( data, len, rec->seq );
+
+    seg->index[hdr->count].time_ns = now;
+    seg->index[hdr->count].offset  = hdr->tail;
+    seg->index[hdr->count].msg_id  = msg_id;
+
+    if ( hdr->count == 0 )
+        hdr->time_first = now;
+    hdr->time_last = now;
+    hdr->tail += need;
+    hdr->count++;
+
+    journal->seq_next++;
+    journal->appended++;
+
+    if ( !journal->thread_started )
+        ntf_journal_segment_sync( seg, hdr->tail, hdr->count );
+
+    pthread_mutex_unlock( &journal->lock );
+    return 0;
+}
+
+/*
+ * Log number of notifications journaled since the last report
+ */
+void ntf_journal_report( struct ntf_journal *journal )
+{
+    unsigned long appended, syncs;
+
+    pthread_mutex_lock( &journal->lock );
+    appended = journal->appended;
+    syncs    = journal->syncs;
+    pthread_mutex_unlock( &journal->lock );
+
+    if ( appended == journal->reported )
+        return;
+
+    INF( "journal: %lu notification(s) appended (%lu total, %lu group sync(s)), next seq %" PRIu64,
+          appended - journal->reported, appended, syncs, journal->seq_next );
+    journal->reported = appended;
+}
+
+/*
+ * Sync and close journal
+ */
+void ntf_journal_close( struct ntf_journal *journal )
+{
+    if ( journal->thread_started )
+    {
+        pthread_mutex_lock( &journal->lock );
+        journal->stop = 1;
+        pthread_cond_signal( &journal->cond );
+        pthread_mutex_unlock( &journal->lock );
+        pthread_join( journal->thread, NULL );
+        journal->thread_started = 0;
+    }
+
+    if ( journal->active != NULL )
+    {
+        ntf_journal_segment_sync( journal->active, journal->active->hdr->tail,
+                                  journal->active->hdr->count );
+        ntf_journal_segment_free( journal->active );
+        journal->active = NULL;
+    }
+
+    free( journal->segments );
+    journal->segments = NULL;
+    journal->segments_num = journal->segments_size = 0;
+
+    pthread_cond_destroy( &journal->cond );
+    pthread_mutex_destroy( &journal->lock );
+}
+
+/*
+ * Index of the first entry not older than 'from_ns'
+ */
+static uint32_t ntf_journal_index_find( struct ntf_journal_index *index, uint32_t count, int64_t from_ns )
+{
+    uint32_t lo = 0, hi = count, mid;
+
+    while ( lo < hi )
+    {
+        mid = lo + ( hi - lo ) / 2;
+        if ( index[mid].time_ns < from_ns )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/*
+ * Replay records of journal
+ */
+long ntf_journal_replay( const char *dir, int64_t from_ns, int64_t to_ns, int msg_id,
+                         ntf_journal_replay_func func, void *arg )
+{
+    struct ntf_journal_segment *seg;
+    struct ntf_journal_record *rec;
+    struct ntf_journal_index *entry;
+    uint64_t *segments = NULL;
+    int segments_size = 0;
+    int i, num, stop = 0;
+    uint32_t count, n;
+    long replayed = 0;
+
+    num = ntf_journal_scan( dir, &segments, &segments_size );
+    if ( num < 0 )
+        return -1;
+
+    for ( i = 0; i < num && !stop; ++i )
+    {
+        seg = ntf_journal_segment_open( dir, segments[i], 0, 0, 0 );
+        if ( seg == NULL )
+        {
+            ERR( "Journal segment %" PRIu64 " is not valid, skipped", segments[i] );
+            continue;
+        }
+
+        count = seg->hdr->count;
+        if ( count > seg->hdr->index_max )
+            count = seg->hdr->index_max;
+
+        /* whole segment is out of time range */
+        if ( count == 0 || seg->hdr->time_last < from_ns ||
+             ( to_ns > 0 && seg->hdr->time_first > to_ns ) )
+        {
+            ntf_journal_segment_free( seg );
+            continue;
+        }
+
+        for ( n = ntf_journal_index_find( seg->index, count, from_ns ); n < count; ++n )
+        {
+            entry = &seg->index[n];
+            if ( to_ns > 0 && entry->time_ns > to_ns )
+            {
+                stop = 1;
+                break;
+            }
+            if ( msg_id >= 0 && entry->msg_id != msg_id )
+                continue;
+
+            rec = ntf_journal_record( seg, entry->offset, seg->hdr->seq_first + n );
+            if ( rec == NULL )
+                break;
+
+            replayed++;
+            if ( func( (char *)( rec + 1 ), rec->len, rec->time_ns, rec->seq, rec->msg_id, arg ) != 0 )
+            {
+                stop = 1;
+                break;
+            }
+        }
+
+        ntf_journal_segment_free( seg );
+    }
+
+    free( segments );
+    return replayed;
+}
@@ -0,0 +1,215 @@
+/* ing_ntfr_journal.h
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains API of persistent journal of received notifications
+ * kept in memory-mapped segment files
+ */
+
+#ifndef ING_NTFR_JOURNAL_H
+#define ING_NTFR_JOURNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+/*
+ * Constants
+ */
+#define NTF_JOURNAL_MAGIC        (0x4e544a52) /* "NTJR" */
+#define NTF_JOURNAL_VERSION      (1)
+#define NTF_JOURNAL_DIR          "/var/lib/ingntfr/journal"
+#define NTF_JOURNAL_SEGMENT_LEN  (4 * 1024 * 1024) /* default size of segment file   */
+#define NTF_JOURNAL_SEGMENT_MIN  (64 * 1024)
+#define NTF_JOURNAL_SEGMENTS     (16)   /* default number of segments kept             */
+#define NTF_JOURNAL_SYNC_MS      (1000) /* default interval of group commit            */
+#define NTF_JOURNAL_ENTRY_AVG    (128)  /* average record size, gives size of index    */
+#define NTF_JOURNAL_HEADER_LEN   (64)   /* records start after header of segment       */
+
+/*
+ * Segment file "<seq_first>.jrn" layout: header, then records one after
+ * another, each is aligned to 8 bytes. Index file "<seq_first>.idx" has
+ * one entry per record in the same order, so that records are found by
+ * time with binary search and by msg_id without reading the segment
+ */
+struct ntf_journal_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t segment_size;
+    uint64_t seq_first;  /* sequence number of the first record */
+    uint64_t tail;       /* where next record is put            */
+    int64_t  time_first; /* time of the first and last records  */
+    int64_t  time_last;
+    uint32_t count;
+    uint32_t index_max;
+    uint64_t reserved;
+};
+
+struct ntf_journal_record
+{
+    uint32_t len;        /* length of notification data following */
+    uint32_t check;      /* checksum of record, torn record is not valid */
+    uint64_t seq;
+    int64_t  time_ns;    /* receive time, realtime clock, never decreases */
+    int32_t  msg_id;
+    uint32_t reserved;
+};
+
+struct ntf_journal_index
+{
+    int64_t  time_ns;
+    uint32_t offset;     /* offset of record in segment */
+    int32_t  msg_id;
+};
+
+/*
+ * Segment file mapped
+ */
+struct ntf_journal_segment
+{
+    struct ntf_journal_header *hdr;
+    struct ntf_journal_index  *index;
+    size_t   map_len;
+    size_t   index_len;
+    int      fd;
+    int      index_fd;
+    uint64_t synced;     /* bytes of records and index entries synced */
+    uint32_t index_synced;
+    struct ntf_journal_segment *next; /* sealed segments waiting for sync */
+};
+
+/*
+ * Journal
+ *
+ *  Notifications are appended to the active segment by the core thread.
+ *  Records are synced to disk by the sync thread once per 'sync_ms'
+ *  (group commit); full segments are sealed, synced and unmapped by it.
+ *  If 'sync_ms' is 0, every record is synced when it is appended.
+ *  Oldest segments are removed when there are more than 'segments_max'
+ */
+struct ntf_journal
+{
+    char     dir[256];
+    size_t   segment_size;
+    int      segments_max;
+    long     sync_ms;
+    uint64_t seq_next;
+    int64_t  time_last;
+    struct ntf_journal_segment *active;
+    struct ntf_journal_segment *sealed;
+    uint64_t *segments;   /* first sequence numbers of segment files, oldest first */
+    int      segments_num;
+    int      segments_size;
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    pthread_t thread;
+    int      thread_started;
+    int      stop;
+    unsigned long appended;
+    unsigned long syncs;
+    unsigned long reported;
+};
+
+/*
+ * Function called for every record replayed, replaying is stopped
+ * if it returns non-zero
+ */
+typedef int (*ntf_journal_replay_func)( const char *data, size_t len, int64_t time_ns,
+                                        uint64_t seq, int msg_id, void *arg );
+
+/*
+ * Open journal in 'dir', records of previous run are kept and appending
+ * continues after the last valid record
+ */
+int ntf_journal_open( struct ntf_journal *journal, const char *dir, size_t segment_size,
+                      int segments_max, long sync_ms );
+/*
+ * Append notification with the current time
+ */
+int ntf_journal_append( struct ntf_journal *journal, const char *data, size_t len, int msg_id );
+/*
+ * Log number of notifications journaled since the last report
+ */
+void ntf_journal_report( struct ntf_journal *journal );
+/*
+ * Sync and close journal
+ */
+void ntf_journal_close( struct ntf_journal *journal );
+/*
+ * Call 'func' for every record of journal in 'dir' received from 'from_ns'
+ * to 'to_ns' (0 for no limit) with 'msg_id' (-1 for any)
+ * Returns: number of records replayed, -1 on error
+ */
+long ntf_journal_replay( const char *dir, int64_t from_ns, int64_t to_ns, int msg_id,
+                         ntf_journal_replay_func func, void *arg );
+
+#endif /* ING_NTFR_JOURNAL_H */
@@ -0,0 +1,292 @@
+/* ing_ntfr_journalreplay.c
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains tool reading journal of received notifications,
+ * records are printed or replayed into a listener
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "ing_ntfr_defines.h"
+#include "ing_ntfr_journal.h"
+
+#define REPLAY_BATCH_MAX 64
+
+/*
+ * Global variables
+ */
+static const char *dir = NTF_JOURNAL_DIR;
+static int64_t from_ns = 0;      /* time range, 0 for no limit      */
+static int64_t to_ns = 0;
+static int msg_id = -1;          /* -1 for any notification         */
+static int port = 0;             /* listener port, 0 to print       */
+static int batch_delay_us = 0;   /* delay between batches sent      */
+
+static int sock = -1;
+static struct sockaddr_in addr;
+static struct mmsghdr msgs[REPLAY_BATCH_MAX];
+static struct iovec iovs[REPLAY_BATCH_MAX];
+static char data[REPLAY_BATCH_MAX][NTF_STR_MSG_BUFFER_LEN];
+static int batch_len;
+static unsigned long sent, failed;
+
+/*
+ * Print help about usage command line parameters
+ */
+static void print_usage()
+{
+    printf( "ntfrjournal - read journal of received notifications\n"
+            "\nParameters:\n"
+            "\t-d, --dir\tjournal directory, default %s\n"
+            "\t-f, --from\tfirst time, seconds since the Epoch\n"
+            "\t-t, --to\tlast time, seconds since the Epoch\n"
+            "\t-m, --msg-id\tonly notifications with message id\n"
+            "\t-p, --port\treplay notifications to listener port instead of printing\n"
+            "\t-w, --wait\tdelay between batches replayed, microseconds\n"
+            "\t-h, --help\tdisplay this help\n"
+            "\nExample:\n\tntfrjournal -f 1760000000 -p %d\n", NTF_JOURNAL_DIR, NTF_PORT_LISTENER_SNMP );
+}
+
+/*
+ * Proceed command line parameters
+ */
+static void proceed_input_args( int argc, char *argv[] )
+{
+    int opt;
+    const char options[] = ":d:f:t:m:p:w:h";
+    static struct option longoptions[] = {
+        { "dir",       required_argument, NULL, 'd' },
+        { "from",      required_argument, NULL, 'f' },
+        { "to",        required_argument, NULL, 't' },
+        { "msg-id",    required_argument, NULL, 'm' },
+        { "port",      required_argument, NULL, 'p' },
+        { "wait",      required_argument, NULL, 'w' },
+        { "help",      no_argument,       NULL, 'h' },
+        { 0,           0,                 0,    0   }
+    };
+
+    while( ( opt = getopt_long( argc, argv,
+                                options, longoptions, NULL ) ) != -1 )
+    {
+        switch ( opt )
+        {
+        case 0: /* getopt_long produce options value */
+            break;
+        case 'd': /* journal directory */
+            dir = optarg;
+            break;
+        case 'f': /* first time */
+            from_ns = atoll( optarg ) * 1000000000LL;
+            break;
+        case 't': /* last time */
+            to_ns = atoll( optarg ) * 1000000000LL;
+            break;
+        case 'm': /* message id */
+            msg_id = atoi( optarg );
+            break;
+        case 'p': /* listener port */
+            port = atoi( optarg );
+            break;
+        case 'w': /* delay between batches */
+            batch_delay_us = atoi( optarg );
+            break;
+        case 'h': /* need to print help */
+        case ':':
+        case '?':
+        default:
+            print_usage();
+            exit( 0 );
+            break;
+        }
+    }
+}
+
+/*
+ * Send batch of notifications to listener with one call
+ */
+static void flush_batch()
+{
+    int done = 0, n;
+
+    while ( done < batch_len )
+    {
+        n = sendmmsg( sock, msgs + done, batch_len - done, 0 );
+        if ( n <= 0 )
+        {
+            if ( n < 0 && errno == EINTR )
+                continue;
+            /* the failed datagram is skipped */
+            failed++;
+            n = 1;
+        }
+        else
+            sent += n;
+        done += n;
+    }
+    batch_len = 0;
+
+    if ( batch_delay_us > 0 )
+        usleep( batch_delay_us );
+}
+
+/*
+ * Print record of journal
+ */
+static int print_record( const char *msg, size_t len, int64_t time_ns,
+                         uint64_t seq, int id, void __attribute__((__unused__)) *arg )
+{
+    char stamp[32];
+    struct tm tm;
+    time_t sec = time_ns / 1000000000LL;
+
+    localtime_r( &sec, &tm );
+    strftime( stamp, sizeof( stamp ), "%Y-%m-%d %H:%M:%S", &tm );
+    printf( "%llu %s.%03d msg_id %d: %.*s\n", (unsigned long long)seq, stamp,
+            (int)( time_ns % 1000000000LL / 1000000 ), id, (int)strnlen( msg, len ), msg );
+    return 0;
+}
+
+/*
+ * Queue record of journal to be sent to listener
+ */
+static int replay_record( const char *msg, size_t len, int64_t __attribute__((__unused__)) time_ns,
+                          uint64_t __attribute__((__unused__)) seq, int __attribute__((__unused__)) id,
+                          void __attribute__((__unused__)) *arg )
+{
+    if ( len > NTF_STR_MSG_BUFFER_LEN )
+    {
+        failed++;
+        return 0;
+    }
+
+    memcpy( data[batch_len], msg, len );
+    iovs[batch_len].iov_base = data[batch_len];
+    iovs[batch_len].iov_len  = len;
+    msgs[batch_len].msg_hdr.msg_iov     = &iovs[batch_len];
+    msgs[batch_len].msg_hdr.msg_iovlen  = 1;
+    msgs[batch_len].msg_hdr.msg_name    = &addr;
+    msgs[batch_len].msg_hdr.msg_namelen = sizeof( addr );
+    if ( ++batch_len == REPLAY_BATCH_MAX )
+        flush_batch();
+    return 0;
+}
+
+/*
+ * Main application thread
+ */
+int main( int argc, char *argv[] )
+{
+    long replayed;
+
+    proceed_input_args( argc, argv );
+
+    if ( port == 0 )
+    {
+        replayed = ntf_journal_replay( dir, from_ns, to_ns, msg_id, print_record, NULL );
+        if ( replayed < 0 )
+            return -1;
+        printf( "%ld notification(s)\n", replayed );
+        return 0;
+    }
+
+    sock = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+    if ( sock < 0 )
+    {
+        printf( "socket create fail\n" );
+        return -1;
+    }
+    memset( &addr, 0, sizeof( addr ) );
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons( port );
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+
+    replayed = ntf_journal_replay( dir, from_ns, to_ns, msg_id, replay_record, NULL );
+    if ( batch_len > 0 )
+        flush_batch();
+    close( sock );
+
+    if ( replayed < 0 )
+        return -1;
+    printf( "%ld notification(s) replayed to port %d: %lu sent, %lu failed\n",
+            replayed, port, sent, failed );
+    return 0;
+}
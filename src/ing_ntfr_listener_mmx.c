@@ -73,12 +73,29 @@
 /* This file contains implementation of MMX notification listener
  */
 
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+
 #include "mmx-frontapi.h"
 
 #include "ing_ntfr_defines.h"
 #include "ing_ntfr_messages.h"
 #include "ing_ntfr_settings.h"
 #include "ing_ntfr_listeners.h"
+#include "ing_ntfr_threads.h"
+#include "ing_ntfr_metrics.h"
 
 /*
  * Constants
@@ -86,6 +103,37 @@
 #define  NTF_MMX_SOCKET_TIMEOUT  3
 #define  NTF_MMX_PORT            15028
 
+#define  NTF_MMX_TXA_MAX         256  /* transactions in flight, power of 2        */
+#define  NTF_MMX_TXAID_MAX       65533
+#define  NTF_MMX_COALESCE_MS     20   /* default window to coalesce requests       */
+#define  NTF_MMX_IDLE_MS         500  /* sender thread wake up period when idle    */
+#define  NTF_MMX_MSG_LEN         4096
+#define  NTF_MMX_SEND_BATCH      32   /* requests copied from table at once        */
+
+/*
+ * State of transaction table entry
+ */
+enum ntf_mmx_txa_state
+{
+    NTF_MMX_TXA_FREE = 0,
+    NTF_MMX_TXA_PENDING,   /* waiting for coalescing window to expire */
+    NTF_MMX_TXA_SENT       /* waiting for response                    */
+};
+
+/*
+ * MMX request, the entry is found by txaId: slot is txaId % NTF_MMX_TXA_MAX
+ */
+struct ntf_mmx_txa
+{
+    int       state;
+    int       txaId;
+    int       msgType;
+    long long deadline;   /* ms: time to send if pending, to give up if sent */
+    unsigned  coalesced;  /* number of notifications merged into request     */
+    char      backendName[MSG_MAX_STR_LEN];
+    char      objName[MSG_MAX_STR_LEN];
+};
+
 
 /*   Global data used by MMX listener code */
 
@@ -97,38 +145,374 @@ extern ntf_mmx_msg_db_entry_t ntf_mmx_msg_db[NTF_MAX_DB_MESSAGE_NUM];
 /* Connection to the MMX entry-point*/
 mmx_ep_connection_t ntf_mmxmsg_epconn;
 
-ep_message_t ntf_ep_req;
-
 int ntf_mmx_txaid;
 
+/*
+ * Transactions, shared by notification workers and sender thread
+ */
+static struct ntf_mmx_txa ntf_mmx_txa_table[NTF_MMX_TXA_MAX];
+static int ntf_mmx_txa_pending = 0;
+static int ntf_mmx_txa_sent = 0;
+static pthread_mutex_t ntf_mmx_txa_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* window to coalesce identical requests and time to wait for response,
+ * ms; no response is requested if the timeout is 0 */
+static int ntf_mmx_coalesce_ms = NTF_MMX_COALESCE_MS;
+static int ntf_mmx_resp_timeout_ms = 0;
+
+/* sender thread is woken up by eventfd when the first request is pending */
+static volatile int ntf_mmx_running = 0;
+static pthread_t ntf_mmx_thread;
+static int ntf_mmx_wakefd = -1;
+
+/* counters */
+static unsigned long ntf_mmx_requests;
+static unsigned long ntf_mmx_coalesced;
+static unsigned long ntf_mmx_responses;
+static unsigned long ntf_mmx_timeouts;
+static unsigned long ntf_mmx_dropped;
+
 
 /* ****************************
  *  Static helper functions
  * ***************************/
 
 /*
- * transaction ID for MMX request
+ * Monotonic time in ms
  */
-static int ntf_mmx_get_txaid()
+static long long ntf_mmx_now_ms()
 {
-    if (ntf_mmx_txaid >= 0  && ntf_mmx_txaid < 65533)
-        ntf_mmx_txaid++;
-    else
-        ntf_mmx_txaid = 1;
-        
-    return ntf_mmx_txaid;
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
 }
 
-/* Prepare the constant part of MMX request header */
-static void ntf_mmx_prepare_msg_header (ep_message_t *ep_req)
+/*
+ * Duration setting in milliseconds, 'defval' if it is not set
+ */
+static int ntf_mmx_setting( char key[], int defval )
 {
-    memset((char*)ep_req, 0, sizeof(ep_message_t));
-    
-    ep_req->header.msgType     = MSGTYPE_DISCOVERCONFIG,
-    ep_req->header.callerId    = MMX_API_CALLERID_WEB; // TODO: Think about NTF caller id
-    ep_req->header.respIpAddr  = htonl( INADDR_LOOPBACK );
-    ep_req->header.respPort    = NTF_MMX_PORT;
-    ep_req->header.respMode    = MMX_API_RESPMODE_NORESP; // MMX response is not needed
+    long msec;
+
+    if ( ntfsettings_get_duration( key, &msec ) != 0 || msec > INT_MAX )
+        return defval;
+
+    return (int)msec;
+}
+
+/*
+ * Allocate entry of transaction table with a new transaction ID,
+ * the entry slot is defined by the ID. Called under lock
+ * Returns: entry, NULL if table is full
+ */
+static struct ntf_mmx_txa* ntf_mmx_txa_alloc()
+{
+    struct ntf_mmx_txa *txa;
+    int i;
+
+    for ( i = 0; i < NTF_MMX_TXA_MAX; ++i )
+    {
+        if (ntf_mmx_txaid >= 0  && ntf_mmx_txaid < NTF_MMX_TXAID_MAX)
+            ntf_mmx_txaid++;
+        else
+            ntf_mmx_txaid = 1;
+
+        txa = &ntf_mmx_txa_table[ntf_mmx_txaid % NTF_MMX_TXA_MAX];
+        if ( txa->state == NTF_MMX_TXA_FREE )
+        {
+            memset( txa, 0, sizeof( struct ntf_mmx_txa ) );
+            txa->txaId = ntf_mmx_txaid;
+            return txa;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Entry of transaction 'txaId' waiting for response. Called under lock
+ */
+static struct ntf_mmx_txa* ntf_mmx_txa_find( int txaId )
+{
+    struct ntf_mmx_txa *txa = &ntf_mmx_txa_table[txaId % NTF_MMX_TXA_MAX];
+
+    if ( txaId <= 0 || txa->state != NTF_MMX_TXA_SENT || txa->txaId != txaId )
+        return NULL;
+
+    return txa;
+}
+
+/*
+ * Free entry of transaction table. Called under lock
+ */
+static void ntf_mmx_txa_free( struct ntf_mmx_txa *txa )
+{
+    if ( txa->state == NTF_MMX_TXA_PENDING )
+        ntf_mmx_txa_pending--;
+    else if ( txa->state == NTF_MMX_TXA_SENT )
+        ntf_mmx_txa_sent--;
+
+    txa->state = NTF_MMX_TXA_FREE;
+}
+
+/*
+ * Build and send DISCOVERCONFIG request, the response is not waited for
+ */
+static int ntf_mmx_send_req( struct ntf_mmx_txa *txa )
+{
+    ep_message_t ep_req;
+    ep_packet_t *packet;
+    char buffer[NTF_MMX_MSG_LEN];
+    int status;
+
+    /* Prepare MMX request header and body */
+    memset((char*)&ep_req, 0, sizeof(ep_message_t));
+
+    ep_req.header.msgType     = txa->msgType;
+    ep_req.header.callerId    = MMX_API_CALLERID_WEB; // TODO: Think about NTF caller id
+    ep_req.header.txaId       = txa->txaId;
+    ep_req.header.respIpAddr  = htonl( INADDR_LOOPBACK );
+    ep_req.header.respPort    = NTF_MMX_PORT;
+    ep_req.header.respMode    = ntf_mmx_resp_timeout_ms > 0 ? MMX_API_RESPMODE_ASYNC
+                                                            : MMX_API_RESPMODE_NORESP;
+
+    strncpy( ep_req.body.discoverConfig.backendName, txa->backendName, MSG_MAX_STR_LEN - 1 );
+    strncpy( ep_req.body.discoverConfig.objName, txa->objName, MSG_MAX_STR_LEN - 1 );
+
+    packet = (ep_packet_t*)buffer;
+    memset(packet->flags, 0, sizeof(packet->flags));
+
+    status = mmx_frontapi_message_build (&ep_req, packet->msg, sizeof(buffer) - sizeof(ep_packet_t));
+    if (status != FA_OK)
+    {
+        LOG("Cannot build DISCOVERCONFIG request (%d)", status);
+        return -2;
+    }
+
+    status = mmx_frontapi_send_req (&ntf_mmxmsg_epconn, packet);
+    if (status != FA_OK)
+    {
+        LOG("Cannot send DISCOVERCONFIG request to MMX (%d)", status);
+        ntf_metrics_count( NTF_SCOPE_MMX, NTF_METRIC_SEND_FAILED, txa->coalesced );
+        return -1;
+    }
+
+    LOG("MMX request %d (%s) txaId %d was sent to MMX, %u notification(s)",
+        txa->msgType, msgtype2str(txa->msgType), txa->txaId, txa->coalesced);
+    return 0;
+}
+
+/*
+ * Send requests whose coalescing window has expired, all of them are
+ * sent back to back without waiting for responses
+ * Returns: time of the next pending request, -1 if there is none
+ */
+static long long ntf_mmx_send_pending( long long now, int all )
+{
+    struct ntf_mmx_txa reqs[NTF_MMX_SEND_BATCH];
+    struct ntf_mmx_txa *txa;
+    long long next;
+    int i, n;
+
+    do
+    {
+        /* requests are copied, the table is not locked while sending */
+        next = -1;
+        n = 0;
+        pthread_mutex_lock( &ntf_mmx_txa_lock );
+        for ( i = 0; i < NTF_MMX_TXA_MAX && ntf_mmx_txa_pending > 0; ++i )
+        {
+            txa = &ntf_mmx_txa_table[i];
+            if ( txa->state != NTF_MMX_TXA_PENDING )
+                continue;
+
+            if ( n == NTF_MMX_SEND_BATCH || ( !all && txa->deadline > now ) )
+            {
+                if ( next < 0 || txa->deadline < next )
+                    next = txa->deadline;
+                continue;
+            }
+
+            reqs[n++] = *txa;
+            ntf_mmx_txa_free( txa );
+            if ( ntf_mmx_resp_timeout_ms > 0 )
+            {
+                txa->state    = NTF_MMX_TXA_SENT;
+                txa->deadline = now + ntf_mmx_resp_timeout_ms;
+                ntf_mmx_txa_sent++;
+            }
+        }
+        pthread_mutex_unlock( &ntf_mmx_txa_lock );
+
+        for ( i = 0; i < n; ++i )
+        {
+            if ( ntf_mmx_send_req( &reqs[i] ) == 0 )
+            {
+                ntf_mmx_requests++;
+                continue;
+            }
+
+            /* no response will come */
+            pthread_mutex_lock( &ntf_mmx_txa_lock );
+            ntf_mmx_dropped++;
+            txa = ntf_mmx_txa_find( reqs[i].txaId );
+            if ( txa != NULL )
+                ntf_mmx_txa_free( txa );
+            pthread_mutex_unlock( &ntf_mmx_txa_lock );
+        }
+    }
+    while ( n == NTF_MMX_SEND_BATCH );
+
+    return next;
+}
+
+/*
+ * Read all received responses and match them with requests
+ */
+static void ntf_mmx_recv_responses()
+{
+    char buffer[NTF_MMX_MSG_LEN];
+    char mem_pool[NTF_MMX_MSG_LEN];
+    ep_packet_t *packet = (ep_packet_t*)buffer;
+    ep_message_t resp;
+    struct ntf_mmx_txa *txa;
+    ssize_t len;
+
+    for ( ;; )
+    {
+        len = recv( ntf_mmxmsg_epconn.sock, buffer, sizeof(buffer) - 1, MSG_DONTWAIT );
+        if ( len < 0 && errno == EINTR )
+            continue;
+        if ( len <= (ssize_t)sizeof(ep_packet_t) )
+            break;
+        buffer[len] = '\0';
+
+        mmx_frontapi_msg_struct_init( &resp, mem_pool, sizeof(mem_pool) );
+        if ( mmx_frontapi_message_parse( packet->msg, &resp ) != FA_OK )
+        {
+            LOG("Failed to parse MMX response");
+            continue;
+        }
+
+        pthread_mutex_lock( &ntf_mmx_txa_lock );
+        txa = ntf_mmx_txa_find( resp.header.txaId );
+        if ( txa != NULL && !resp.header.moreFlag )
+            ntf_mmx_txa_free( txa );
+        pthread_mutex_unlock( &ntf_mmx_txa_lock );
+
+        if ( txa == NULL )
+            LOG("MMX response %d to unknown request txaId %d", resp.header.msgType, resp.header.txaId);
+        else
+        {
+            LOG("MMX response %d (%s) to request txaId %d",
+                resp.header.msgType, msgtype2str(resp.header.msgType), resp.header.txaId);
+            ntf_mmx_responses++;
+        }
+    }
+}
+
+/*
+ * Give up waiting for responses which are late
+ * Returns: time of the next deadline, -1 if no response is waited for
+ */
+static long long ntf_mmx_expire( long long now )
+{
+    struct ntf_mmx_txa *txa;
+    long long next = -1;
+    int i;
+
+    pthread_mutex_lock( &ntf_mmx_txa_lock );
+    for ( i = 0; i < NTF_MMX_TXA_MAX && ntf_mmx_txa_sent > 0; ++i )
+    {
+        txa = &ntf_mmx_txa_table[i];
+        if ( txa->state != NTF_MMX_TXA_SENT )
+            continue;
+
+        if ( txa->deadline <= now )
+        {
+            ERR("No response from MMX to request %d txaId %d (obj '%s', backend '%s')",
+                txa->msgType, txa->txaId, txa->objName, txa->backendName);
+            ntf_mmx_txa_free( txa );
+            ntf_mmx_timeouts++;
+        }
+        else if ( next < 0 || txa->deadline < next )
+            next = txa->deadline;
+    }
+    pthread_mutex_unlock( &ntf_mmx_txa_lock );
+
+    return next;
+}
+
+/*
+ * Sender thread: sends requests when coalescing window expires and
+ * handles responses and their timeouts
+ */
+static void* ntf_mmx_handler( void *arg )
+{
+    struct pollfd pfd[2];
+    long long now, next, expire;
+    uint64_t value;
+    int timeout;
+
+    ntf_thread_setup( "mmx", "ntf-mmx-send" );
+
+    pfd[0].fd     = ntf_mmx_wakefd;
+    pfd[0].events = POLLIN;
+    pfd[1].fd     = ntf_mmxmsg_epconn.sock;
+    pfd[1].events = POLLIN;
+
+    timeout = NTF_MMX_IDLE_MS;
+    while ( ntf_mmx_running )
+    {
+        if ( poll( pfd, ntf_mmx_resp_timeout_ms > 0 ? 2 : 1, timeout ) < 0 && errno != EINTR )
+        {
+            ERR("poll() failed: %s (%d)", strerror(errno), errno);
+            break;
+        }
+
+        if ( pfd[0].revents & POLLIN )
+        {
+            if ( read( ntf_mmx_wakefd, &value, sizeof(value) ) < 0 )
+                value = 0;
+        }
+        if ( ntf_mmx_resp_timeout_ms > 0 && ( pfd[1].revents & POLLIN ) )
+            ntf_mmx_recv_responses();
+
+        now    = ntf_mmx_now_ms();
+        next   = ntf_mmx_send_pending( now, 0 );
+        expire = ntf_mmx_expire( now );
+        if ( next < 0 || ( expire >= 0 && expire < next ) )
+            next = expire;
+
+        timeout = next < 0 ? NTF_MMX_IDLE_MS : (int)( next - now );
+        if ( timeout > NTF_MMX_IDLE_MS )
+            timeout = NTF_MMX_IDLE_MS;
+    }
+
+    /* send requests collected before stop */
+    ntf_mmx_send_pending( ntf_mmx_now_ms(), 1 );
+    return NULL;
+}
+
+/*
+ * Find MMX db entry of notification
+ */
+static ntf_mmx_msg_db_entry_t* ntf_mmx_msg_find( int msg_id )
+{
+    int i;
+
+    for ( i = 0; i < NTF_MAX_DB_MESSAGE_NUM; ++i )
+    {
+        /* Check the end of the messages list */
+        if ( ntf_mmx_msg_db[i].msg_id == NTF_MSG_NOTUSED )
+            break;
+
+        if ( msg_id == ntf_mmx_msg_db[i].msg_id )
+            return &ntf_mmx_msg_db[i];
+    }
+
+    return NULL;
 }
 
 
@@ -150,8 +534,33 @@ int ntf_mmx_init( void *args )
     }
 
     ntf_mmx_txaid = 0;
-    
-    ntf_mmx_prepare_msg_header (&ntf_ep_req);
+    memset( ntf_mmx_txa_table, 0, sizeof(ntf_mmx_txa_table) );
+    ntf_mmx_txa_pending = 0;
+    ntf_mmx_txa_sent = 0;
+
+    ntf_mmx_coalesce_ms     = ntf_mmx_setting( "mmx_coalesce_ms", NTF_MMX_COALESCE_MS );
+    ntf_mmx_resp_timeout_ms = ntf_mmx_setting( "mmx_response_timeout_ms", 0 );
+    if ( ntf_mmx_coalesce_ms < 0 )
+        ntf_mmx_coalesce_ms = 0;
+
+    ntf_mmx_wakefd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+    if ( ntf_mmx_wakefd < 0 )
+    {
+        ERR("eventfd() failed: %s (%d)", strerror(errno), errno);
+        mmx_frontapi_close(&ntf_mmxmsg_epconn);
+        return -1;
+    }
+
+    ntf_mmx_running = 1;
+    if ( pthread_create( &ntf_mmx_thread, NULL, &ntf_mmx_handler, NULL ) != 0 )
+    {
+        ERR("Cannot create pthread for MMX requests");
+        ntf_mmx_running = 0;
+        close( ntf_mmx_wakefd );
+        ntf_mmx_wakefd = -1;
+        mmx_frontapi_close(&ntf_mmxmsg_epconn);
+        return -1;
+    }
 
     return 0;
 }
@@ -159,96 +568,105 @@ int ntf_mmx_init( void *args )
 
 int ntf_mmx_clean()
 {
+    uint64_t value = 1;
+
+    if ( ntf_mmx_running )
+    {
+        ntf_mmx_running = 0;
+        if ( write( ntf_mmx_wakefd, &value, sizeof(value) ) < 0 )
+            ERR("Cannot wake up MMX sender: %s (%d)", strerror(errno), errno);
+        pthread_join( ntf_mmx_thread, NULL );
+    }
+
+    INF("MMX requests: %lu sent, %lu notifications coalesced, %lu responses, %lu timeouts, %lu dropped",
+        ntf_mmx_requests, ntf_mmx_coalesced, ntf_mmx_responses, ntf_mmx_timeouts, ntf_mmx_dropped);
+
+    if ( ntf_mmx_wakefd >= 0 )
+    {
+        close( ntf_mmx_wakefd );
+        ntf_mmx_wakefd = -1;
+    }
     mmx_frontapi_close(&ntf_mmxmsg_epconn);
     return 0;
 }
 
+/*
+ * Queue DISCOVERCONFIG request of notification. Request identical to
+ * pending one is merged into it, requests are sent by sender thread
+ * when coalescing window expires
+ */
 int ntf_send_mmx_notif( struct ing_notification *notif )
 {
-    int i = 0;
-    int found = 0;
-    int status = 0, res = 0;
-    ep_packet_t *packet;
-    char buffer[1024] = {0}; 
-    
-    while (!found)
+    ntf_mmx_msg_db_entry_t *entry;
+    struct ntf_mmx_txa *txa = NULL;
+    const char *backendName = "", *objName = "";
+    uint64_t value = 1;
+    int i, wake;
+
+    entry = ntf_mmx_msg_find( notif->msg_id );
+    if ( entry == NULL )
     {
-        /*LOG("i = %d, msg_id in db = %d, msg id in the ntf %d", i, 
-             ntf_mmx_msg_db[i].msg_id, notif->msg_id);*/
-        
-        /* Check the end of the messages list */
-        if ( ntf_mmx_msg_db[i].msg_id == NTF_MSG_NOTUSED )
-            break;
+        //LOG("Notification %d is unknown for MMX listener. Ignore", notif->msg_id);
+        return 0;
+    }
 
-        if ( notif->msg_id == ntf_mmx_msg_db[i].msg_id )
-        {
-            found = 1;
-            
-            /* Fill request type and body of the MMX request  */
-            memset((char *)&ntf_ep_req.body, 0, sizeof(ntf_ep_req.body));
-            
-            if (notif->msg_id == NTF_MSG_MMXMODULESTARTED)
-            {
-                ntf_ep_req.header.msgType = ntf_mmx_msg_db[i].mmx_req_type;
-                
-                strncpy( ntf_ep_req.body.discoverConfig.backendName, 
-                         notif->params[0], MSG_MAX_STR_LEN );
-                         
-                LOG("Notification MMXMODULESTARTED received; module name %s",
-                     notif->params[0]);
-                         
-            }
-            else if (notif->msg_id == NTF_MSG_MMXOBJCHANGED)
-            {
-                ntf_ep_req.header.msgType = ntf_mmx_msg_db[i].mmx_req_type;
-                
-                strncpy( ntf_ep_req.body.discoverConfig.objName, 
-                         notif->params[0], MSG_MAX_STR_LEN);
-                         
-                LOG("Ntf MMXOBJCHANGED received; obj name %s; msg type %d",
-                     notif->params[0], ntf_ep_req.header.msgType);
-                
-            }
-            
-            ntf_ep_req.header.txaId = ntf_mmx_get_txaid();
-        }
-        i++;
+    if ( notif->param_num < 1 || notif->params[0] == NULL )
+        return -2;
+
+    if (notif->msg_id == NTF_MSG_MMXMODULESTARTED)
+    {
+        backendName = notif->params[0];
+        LOG("Notification MMXMODULESTARTED received; module name %s",
+             notif->params[0]);
     }
-    
-    /* Send request to MMX  Entry-Point */
-    if (found)
+    else if (notif->msg_id == NTF_MSG_MMXOBJCHANGED)
     {
-        packet = (ep_packet_t*)buffer;
-        memset(packet->flags, 0, sizeof(packet->flags));
+        objName = notif->params[0];
+        LOG("Ntf MMXOBJCHANGED received; obj name %s; msg type %d",
+             notif->params[0], entry->mmx_req_type);
+    }
+
+    pthread_mutex_lock( &ntf_mmx_txa_lock );
 
-        status = mmx_frontapi_message_build (&ntf_ep_req, packet->msg, sizeof(buffer));
-        if (status == FA_OK )
+    /* coalesce with identical request waiting to be sent */
+    for ( i = 0; i < NTF_MMX_TXA_MAX && ntf_mmx_txa_pending > 0; ++i )
+    {
+        if ( ntf_mmx_txa_table[i].state == NTF_MMX_TXA_PENDING &&
+             ntf_mmx_txa_table[i].msgType == entry->mmx_req_type &&
+             strncmp( ntf_mmx_txa_table[i].backendName, backendName, MSG_MAX_STR_LEN - 1 ) == 0 &&
+             strncmp( ntf_mmx_txa_table[i].objName, objName, MSG_MAX_STR_LEN - 1 ) == 0 )
         {
-           status = mmx_frontapi_send_req (&ntf_mmxmsg_epconn, packet);
-           if (status == FA_OK)
-           {
-               LOG("MMX request %d (%s) was successfully sent to MMX", 
-                    ntf_ep_req.header.msgType, msgtype2str(ntf_ep_req.header.msgType));
-               res = 0;
-           }
-           else
-           {
-               LOG("Cannot send DISCOVERCONFIG request to MMX (%d)", status);
-               res = -1;
-           }
-       }
-       else
-       {
-           LOG("Cannot build DISCOVERCONFIG request (%d)", status);
-           res = -2;
-       }
-    }
-    else
+            txa = &ntf_mmx_txa_table[i];
+            txa->coalesced++;
+            ntf_mmx_coalesced++;
+            pthread_mutex_unlock( &ntf_mmx_txa_lock );
+            return 0;
+        }
+    }
+
+    txa = ntf_mmx_txa_alloc();
+    if ( txa == NULL )
     {
-        //LOG("Notification %d is unknown for MMX listener. Ignore", notif->msg_id);
+        ntf_mmx_dropped++;
+        pthread_mutex_unlock( &ntf_mmx_txa_lock );
+        ntf_metrics_count( NTF_SCOPE_MMX, NTF_METRIC_DROPPED, 1 );
+        ERR("MMX transaction table is full, request of notification %d is dropped", notif->msg_id);
+        return -1;
     }
-    
-    return res;
-}
 
+    txa->state     = NTF_MMX_TXA_PENDING;
+    txa->msgType   = entry->mmx_req_type;
+    txa->deadline  = ntf_mmx_now_ms() + ntf_mmx_coalesce_ms;
+    txa->coalesced = 1;
+    strncpy( txa->backendName, backendName, MSG_MAX_STR_LEN - 1 );
+    strncpy( txa->objName, objName, MSG_MAX_STR_LEN - 1 );
+    wake = ( ntf_mmx_txa_pending++ == 0 );
+
+    pthread_mutex_unlock( &ntf_mmx_txa_lock );
 
+    /* sender sleeps while there is nothing to send */
+    if ( wake && write( ntf_mmx_wakefd, &value, sizeof(value) ) < 0 )
+        ERR("Cannot wake up MMX sender: %s (%d)", strerror(errno), errno);
+
+    return 0;
+}
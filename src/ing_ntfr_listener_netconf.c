@@ -72,20 +72,33 @@
  * This file contains NETCONF notification listener implementation
  */
 
+#define _GNU_SOURCE
+
 #include <errno.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <time.h>
+#include <pthread.h>
 #include <sys/socket.h>
 #include <sys/types.h>
-
-#include <microxml.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 
 #include "ing_ntfr_defines.h"
 #include "ing_ntfr_messages.h"
 #include "ing_ntfr_listeners.h"
 #include "ing_ntfr_settings.h"
+#include "ing_ntfr_xml.h"
+#include "ing_ntfr_stream.h"
+#include "ing_ntfr_replay.h"
+#include "ing_ntfr_threads.h"
+#include "ing_ntfr_metrics.h"
 
 
 /*
@@ -95,10 +108,61 @@ extern struct ntf_netconf_db_entry ntf_netconf_db[NTF_MAX_DB_MESSAGE_NUM];
 
 
 #define NCNTF_MMXEVENT_MSGSIZE            (1024)
-char ntf_netconf_message[NCNTF_MMXEVENT_MSGSIZE];
+#define NCNTF_MMXEVENT_MSGSIZE_MAX        (65507)  /* max payload of UDP datagram */
+
+/*
+ * Output buffer of XML message
+ *
+ *  Buffers are taken from the pool for rendering of a notification and
+ *  returned afterwards, so every worker thread writes to its own buffer.
+ *  Buffer is grown if message of multi-parameter event does not fit,
+ *  and keeps its size when returned to the pool
+ */
+struct ntf_netconf_buffer
+{
+    char  *data;
+    size_t size;
+    struct ntf_netconf_buffer *next;
+};
+
+static struct ntf_netconf_buffer *ntf_netconf_pool = NULL;
+static pthread_mutex_t ntf_netconf_pool_lock = PTHREAD_MUTEX_INITIALIZER;
 
 #define NCNTF_MMXEVENT_CONTENT_PARAMSIZE   (256)
 
+/*
+ * Compiled XML template of notification
+ *
+ *  Message is assembled as 'head', then open tag, value and close tag
+ *  of every parameter node, then 'tail'
+ */
+struct ntf_netconf_slot
+{
+    int    first;  /* index of the first parameter of the node          */
+    int    last;   /* index of the last parameter (multi-param node)    */
+    ntf_param_convert_func convert;
+    char  *open;   /* "<par_info>"                                      */
+    size_t open_len;
+    char  *close;  /* "</par_info>"                                     */
+    size_t close_len;
+};
+
+struct ntf_netconf_template
+{
+    int    valid;
+    char  *head;   /* template up to parameter nodes, type is filled    */
+    size_t head_len;
+    char  *tail;   /* the rest of template                              */
+    size_t tail_len;
+    int    slots_num;
+    struct ntf_netconf_slot slots[NTF_PARAM_IN_MSG_MAX];
+};
+
+/*
+ * Templates compiled at init, index is the same as in ntf_netconf_db
+ */
+static struct ntf_netconf_template ntf_netconf_templates[NTF_MAX_DB_MESSAGE_NUM];
+
 #define NETCONF_SRV_ADDR       (INADDR_LOOPBACK)
 #define NETCONF_SRV_PORT                  (7890)
 
@@ -111,6 +175,36 @@ char ntf_netconf_message[NCNTF_MMXEVENT_MSGSIZE];
  */
 static int sockfd  = -1;
 
+/*
+ * Persistent stream to the NETCONF server, used instead of UDP socket
+ * if 'netconf_stream' address is configured. Messages are sent with
+ * RFC 6242 chunked framing
+ */
+static struct ntf_stream ntf_netconf_stream;
+static int ntf_netconf_use_stream = 0;
+
+/*
+ * Wrap notifications into RFC 5277 <notification> with <eventTime>
+ */
+static int ntf_netconf_envelope = 0;
+
+/*
+ * RFC 5277 replay: rendered notifications are kept in replay buffer and
+ * are sent to clients connected to 'netconf_replay' address. Client sends
+ * request line "<startTime> [<stopTime>]" in RFC 3339 format and gets
+ * notifications of the time range in RFC 6242 chunked framing followed
+ * by <replayComplete> notification
+ */
+#define NCNTF_REPLAY_REQUEST_LEN   (128)
+#define NCNTF_REPLAY_TIMEOUT_MS    (500)
+
+static struct ntf_replay ntf_netconf_replay;
+static int ntf_netconf_use_replay = 0;
+static int ntf_netconf_replay_fd  = -1;
+static volatile int ntf_netconf_replay_running = 0;
+static pthread_t ntf_netconf_replay_thread;
+static struct sockaddr_storage ntf_netconf_replay_addr;
+
 
 static struct ntf_netconf_db_entry* select_notif_from_netconf_db( struct ing_notification *notif )
 {
@@ -149,146 +243,388 @@ reterr:
     return NULL;
 }
 
-static int prepare_netconf_message( struct ing_notification *notif, struct ntf_netconf_db_entry *netconf_notif )
+/*
+ * Make string of 'len' bytes of 'data' followed by 'text' and 'end'
+ */
+static char* ntf_netconf_strdup3( const char *data, size_t len, const char *text, const char *end )
 {
-    int i, j, k, len;
-    mxml_node_t *xml_notif;
-    mxml_node_t *node, *content_node;
+    size_t text_len, end_len;
+    char *str;
 
-    char param_content[NCNTF_MMXEVENT_CONTENT_PARAMSIZE] = {0};
-    char multiparam_content[NCNTF_MMXEVENT_CONTENT_PARAMSIZE] = {0};
+    text_len = ( text != NULL ) ? strlen( text ) : 0;
+    end_len  = ( end != NULL ) ? strlen( end ) : 0;
+
+    str = malloc( len + text_len + end_len + 1 );
+    if ( str == NULL )
+        return NULL;
+
+    memcpy( str, data, len );
+    memcpy( str + len, text, text_len );
+    memcpy( str + len + text_len, end, end_len );
+    str[len + text_len + end_len] = '\0';
 
-    xml_notif = mxmlLoadString(NULL, netconf_notif->template, MXML_OPAQUE_CALLBACK);
-    if ( xml_notif == NULL )
+    return str;
+}
+
+/*
+ * Free compiled template
+ */
+static void ntf_netconf_template_free( struct ntf_netconf_template *tmpl )
+{
+    int i;
+
+    free( tmpl->head );
+    free( tmpl->tail );
+    for ( i = 0; i < tmpl->slots_num; ++i )
     {
-        ERR( "Cannot load notification XML template" );
-        return -1;
+        free( tmpl->slots[i].open );
+        free( tmpl->slots[i].close );
     }
+    memset( tmpl, 0, sizeof( struct ntf_netconf_template ) );
+}
+
+/*
+ * Compile XML template of db entry:
+ *  - <type/> node of <mmx-event> notification is filled with type value,
+ *  - the template is split at the place where parameter nodes are inserted
+ *    (into <content/> node of <mmx-event>, or into the root node otherwise),
+ *  - tags of parameter nodes are prepared; a node is made of one parameter,
+ *    or of several parameters if following ones have empty-string par_info
+ */
+static int ntf_netconf_template_compile( struct ntf_netconf_db_entry *netconf_notif,
+                                         struct ntf_netconf_template *tmpl )
+{
+    const char *xml, *pos, *insert, *resume, *after, *content_open, *tail_prefix;
+    char root[64], text[NCNTF_MMXEVENT_CONTENT_PARAMSIZE];
+    struct ntf_xml_writer writer;
+    size_t len;
+    struct ntf_netconf_slot *slot;
+    int i;
+
+    memset( tmpl, 0, sizeof( struct ntf_netconf_template ) );
+    xml = netconf_notif->template;
+    if ( xml == NULL || xml[0] != '<' )
+        return -1;
 
-    if (strcmp(mxmlGetElement(xml_notif), "mmx-event") == 0)
+    len = strcspn( xml + 1, " />" );
+    if ( len == 0 || len >= sizeof( root ) )
+        return -1;
+    memcpy( root, xml + 1, len );
+    root[len] = '\0';
+
+    if ( strcmp( root, "mmx-event" ) == 0 )
     {
-        node = mxmlFindElement(xml_notif, xml_notif, "type", NULL, NULL, MXML_DESCEND);
-        if ( node == NULL )
+        /* head: template up to <type/>, filled type node, then up to <content> */
+        if ( ( pos = strstr( xml, "<type/>" ) ) != NULL )
+            resume = pos + strlen( "<type/>" );
+        else if ( ( pos = strstr( xml, "<type></type>" ) ) != NULL )
+            resume = pos + strlen( "<type></type>" );
+        else
         {
-            ERR( "Missing node 'type' in loaded notification XML template" );
-            mxmlDelete( xml_notif );
+            ERR( "Missing node 'type' in notification XML template" );
+            return -1;
+        }
+
+        ntf_xml_init( &writer, text, sizeof( text ) );
+        ntf_xml_start( &writer, "type" );
+        ntf_xml_text( &writer, netconf_notif->type );
+        if ( ntf_xml_finish( &writer ) >= sizeof( text ) )
             return -1;
+
+        if ( ( insert = strstr( resume, "<content/>" ) ) != NULL )
+        {
+            after        = insert + strlen( "<content/>" );
+            content_open = "<content>";
+            tail_prefix  = "</content>";
+        }
+        else if ( ( insert = strstr( resume, "<content>" ) ) != NULL )
+        {
+            insert      += strlen( "<content>" );
+            after        = insert;
+            content_open = "";
+            tail_prefix  = "";
         }
-        mxmlNewText(node, 0, netconf_notif->type);
-        node = mxmlFindElement(xml_notif, xml_notif, "content", NULL, NULL, MXML_DESCEND);
-        if ( node == NULL )
+        else
         {
-            ERR( "Missing node 'content' in loaded notification XML template" );
-            mxmlDelete( xml_notif );
+            ERR( "Missing node 'content' in notification XML template" );
             return -1;
         }
-    } else {
-        node = xml_notif;
-    }
-
 
-    /* process params - some content nodes can be made of multiple params values */
-    for ( i = 0; i < netconf_notif->param_num; i++ )
+        len = ( pos - xml ) + strlen( text ) + ( insert - resume ) + strlen( content_open );
+        tmpl->head = malloc( len + 1 );
+        if ( tmpl->head != NULL )
+            sprintf( tmpl->head, "%.*s%s%.*s%s", (int)( pos - xml ), xml, text,
+                     (int)( insert - resume ), resume, content_open );
+        tmpl->tail = ntf_netconf_strdup3( tail_prefix, strlen( tail_prefix ), after, NULL );
+    }
+    else
     {
-        memset( param_content, 0, NCNTF_MMXEVENT_CONTENT_PARAMSIZE );
-        memset( multiparam_content, 0, NCNTF_MMXEVENT_CONTENT_PARAMSIZE );
-        if ( notif->params[i] == NULL )
+        /* parameter nodes are the last children of the root node */
+        len = strlen( xml );
+        if ( len > 2 && strcmp( xml + len - 2, "/>" ) == 0 )
         {
-            ERR( "Missing data for parameter %d in request (tag_name: %s)", i, netconf_notif->params[i].par_info );
-            mxmlDelete( xml_notif );
-            return -1;
+            /* <root/> */
+            tmpl->head = ntf_netconf_strdup3( xml, len - 2, ">", NULL );
+            tmpl->tail = ntf_netconf_strdup3( "</", 2, root, ">" );
+        }
+        else
+        {
+            insert = strrchr( xml, '<' );
+            if ( insert == NULL || insert[1] != '/' )
+                return -1;
+            tmpl->head = ntf_netconf_strdup3( xml, insert - xml, NULL, NULL );
+            tmpl->tail = ntf_netconf_strdup3( insert, strlen( insert ), NULL, NULL );
         }
+    }
+
+    if ( tmpl->head == NULL || tmpl->tail == NULL )
+        goto reterr;
+    tmpl->head_len = strlen( tmpl->head );
+    tmpl->tail_len = strlen( tmpl->tail );
 
-        len = strlen(notif->params[i]);
-        if ( len == 0 )
+    for ( i = 0; i < netconf_notif->param_num && i < NTF_PARAM_IN_MSG_MAX; ++i )
+    {
+        if ( strcmp( netconf_notif->params[i].par_info, "" ) == 0 && tmpl->slots_num > 0 )
         {
-            /* empty notification parameter would not be inserted to Xml */
+            /* value of the previous node continues */
+            tmpl->slots[tmpl->slots_num - 1].last = i;
             continue;
         }
 
-        for ( j = i + 1; j < netconf_notif->param_num; j++ )
+        slot = &tmpl->slots[tmpl->slots_num++];
+        slot->first   = i;
+        slot->last    = i;
+        slot->convert = netconf_notif->params[i].convert_func;
+        slot->open    = ntf_netconf_strdup3( "<", 1, netconf_notif->params[i].par_info, ">" );
+        slot->close   = ntf_netconf_strdup3( "</", 2, netconf_notif->params[i].par_info, ">" );
+        if ( slot->open == NULL || slot->close == NULL )
+            goto reterr;
+        slot->open_len  = strlen( slot->open );
+        slot->close_len = strlen( slot->close );
+    }
+
+    tmpl->valid = 1;
+    return 0;
+
+reterr:
+    ntf_netconf_template_free( tmpl );
+    return -1;
+}
+
+/*
+ * Write XML message of notification to 'buf' of 'size' bytes
+ * Returns: length of message, negative value on error; message is not
+ * fit to buffer if its length is not less than 'size'
+ */
+static ssize_t prepare_netconf_message( struct ing_notification *notif, struct ntf_netconf_db_entry *netconf_notif,
+                                        char *buf, size_t size )
+{
+    int i, k;
+    struct ntf_netconf_template *tmpl;
+    struct ntf_netconf_slot *slot;
+    struct ntf_xml_writer writer;
+
+    char param_content[NCNTF_MMXEVENT_CONTENT_PARAMSIZE] = {0};
+
+    tmpl = &ntf_netconf_templates[netconf_notif - ntf_netconf_db];
+    if ( !tmpl->valid )
+    {
+        ERR( "Cannot load notification XML template" );
+        return -1;
+    }
+
+    ntf_xml_init( &writer, buf, size );
+    if ( ntf_netconf_envelope )
+        ntf_xml_envelope_start( &writer, time( NULL ) );
+
+    ntf_xml_raw( &writer, tmpl->head, tmpl->head_len );
+
+    /* process params - some content nodes can be made of multiple params values */
+    for ( i = 0; i < tmpl->slots_num; i++ )
+    {
+        slot = &tmpl->slots[i];
+
+        for ( k = slot->first; k <= slot->last; k++ )
         {
-            if ( strcmp( netconf_notif->params[j].par_info, "" ) != 0 )
+            if ( k >= notif->param_num || notif->params[k] == NULL )
             {
-                break;
+                ERR( "Missing data for parameter %d in request (tag_name: %s)", k,
+                     netconf_notif->params[slot->first].par_info );
+                return -1;
             }
+        }
 
-            len = len + strlen(notif->params[j]);
+        if ( notif->params[slot->first][0] == '\0' )
+        {
+            /* empty notification parameter would not be inserted to Xml */
+            continue;
         }
 
-        j--;
+        ntf_xml_raw( &writer, slot->open, slot->open_len );
 
-        content_node = mxmlNewElement(node, netconf_notif->params[i].par_info);
-        if ( j == i )
+        if ( slot->first == slot->last && slot->convert != NULL )
         {
-            if ( netconf_notif->params[i].convert_func == NULL )
-            {
-                /* content node is made of sole param value without convert func */
-                mxmlNewText(content_node, 0, notif->params[i]);
-            }
-            else
+            /* content node is made of sole param value with convert func */
+            memset( param_content, 0, NCNTF_MMXEVENT_CONTENT_PARAMSIZE );
+            if ( slot->convert( notif->params[slot->first], &param_content[0], NULL ) != 0 )
             {
-                /* content node is made of sole param value with convert func */
-                if ( netconf_notif->params[i].convert_func( notif->params[i],
-                                                            &param_content[0], NULL ) != 0 )
-                {
-                    ERR( "Cannot convert value of node 'content/%s'",
-                         netconf_notif->params[i].par_info );
-                    mxmlDelete( xml_notif );
-                    return -1;
-                }
-                mxmlNewText(content_node, 0, param_content);
+                ERR( "Cannot convert value of node 'content/%s'",
+                     netconf_notif->params[slot->first].par_info );
+                ntf_metrics_count( NTF_SCOPE_NETCONF, NTF_METRIC_CONVERT_FAILED, 1 );
+                return -1;
             }
+            ntf_xml_text( &writer, param_content );
         }
-        else /* j > i */
+        else
         {
-            /* content node is made of multiple params values */
-            if ( len >= NCNTF_MMXEVENT_CONTENT_PARAMSIZE )
-            {
-                ERR( "Node 'content/%s' value it too large (%d > %d)",
-                      netconf_notif->params[i].par_info, len,
-                      NCNTF_MMXEVENT_CONTENT_PARAMSIZE - 1 );
-                mxmlDelete( xml_notif );
-                return -1;
-            }
-
-            for ( k = i; k <= j; k++ )
-            {
-                strcat(multiparam_content, notif->params[k]);
-            }
-            mxmlNewText(content_node, 0, multiparam_content);
-
-            i = j;
+            /* content node is made of sole param value without convert func,
+             * or of multiple params values */
+            for ( k = slot->first; k <= slot->last; k++ )
+                ntf_xml_text( &writer, notif->params[k] );
         }
+
+        ntf_xml_raw( &writer, slot->close, slot->close_len );
     }
 
-    memset( ntf_netconf_message, 0, NCNTF_MMXEVENT_MSGSIZE );
-    if ( mxmlSaveString(xml_notif, ntf_netconf_message, NCNTF_MMXEVENT_MSGSIZE, MXML_NO_CALLBACK) <= 0 )
+    ntf_xml_raw( &writer, tmpl->tail, tmpl->tail_len );
+
+    return (ssize_t)ntf_xml_finish( &writer );
+}
+
+/*
+ * Write XML message of notification to 'buf' from compiled template,
+ * notification is not validated and is not kept for replay
+ * Returns: length of message, 0 if notification is unknown, negative value on error
+ */
+ssize_t ntf_netconf_prepare( struct ing_notification *notif, char *buf, size_t size )
+{
+    struct ntf_netconf_db_entry *netconf_notif;
+
+    netconf_notif = select_notif_from_netconf_db( notif );
+    if ( netconf_notif == NULL )
+        return 0;
+
+    return prepare_netconf_message( notif, netconf_notif, buf, size );
+}
+
+/*
+ * Take output buffer from the pool, new one is allocated if pool is empty
+ */
+static struct ntf_netconf_buffer* ntf_netconf_buffer_get()
+{
+    struct ntf_netconf_buffer *buffer;
+
+    pthread_mutex_lock( &ntf_netconf_pool_lock );
+    buffer = ntf_netconf_pool;
+    if ( buffer != NULL )
+        ntf_netconf_pool = buffer->next;
+    pthread_mutex_unlock( &ntf_netconf_pool_lock );
+
+    if ( buffer != NULL )
+        return buffer;
+
+    buffer = malloc( sizeof( struct ntf_netconf_buffer ) );
+    if ( buffer == NULL )
+        return NULL;
+
+    buffer->data = malloc( NCNTF_MMXEVENT_MSGSIZE );
+    if ( buffer->data == NULL )
     {
-        ERR( "Cannot save XML notification to string" );
-        mxmlDelete( xml_notif );
-        return -1;
+        free( buffer );
+        return NULL;
     }
+    buffer->size = NCNTF_MMXEVENT_MSGSIZE;
+    buffer->next = NULL;
+
+    return buffer;
+}
+
+/*
+ * Return output buffer to the pool
+ */
+static void ntf_netconf_buffer_put( struct ntf_netconf_buffer *buffer )
+{
+    if ( buffer == NULL )
+        return;
+
+    pthread_mutex_lock( &ntf_netconf_pool_lock );
+    buffer->next = ntf_netconf_pool;
+    ntf_netconf_pool = buffer;
+    pthread_mutex_unlock( &ntf_netconf_pool_lock );
+}
+
+/*
+ * Grow output buffer to hold 'len' bytes and terminating '\0'
+ */
+static int ntf_netconf_buffer_grow( struct ntf_netconf_buffer *buffer, size_t len )
+{
+    size_t size;
+    char *data;
+
+    if ( len >= NCNTF_MMXEVENT_MSGSIZE_MAX )
+        return -1;
+
+    for ( size = buffer->size; size <= len; size *= 2 )
+        ;
+    if ( size > NCNTF_MMXEVENT_MSGSIZE_MAX )
+        size = NCNTF_MMXEVENT_MSGSIZE_MAX;
 
-    mxmlDelete( xml_notif );
-    return strlen(ntf_netconf_message);
+    data = realloc( buffer->data, size );
+    if ( data == NULL )
+        return -1;
+
+    buffer->data = data;
+    buffer->size = size;
+    return 0;
 }
 
-static int send_netconf_message()
+/*
+ * Free all buffers of the pool
+ */
+static void ntf_netconf_pool_free()
+{
+    struct ntf_netconf_buffer *buffer;
+
+    pthread_mutex_lock( &ntf_netconf_pool_lock );
+    while ( ntf_netconf_pool != NULL )
+    {
+        buffer = ntf_netconf_pool;
+        ntf_netconf_pool = buffer->next;
+        free( buffer->data );
+        free( buffer );
+    }
+    pthread_mutex_unlock( &ntf_netconf_pool_lock );
+}
+
+static int send_netconf_message( char *message, size_t len )
 {
     struct sockaddr_in addr = {0};
+
+    if ( ntf_netconf_use_stream )
+    {
+        if ( ntf_stream_send( &ntf_netconf_stream, message, len ) != 0 )
+        {
+            ERR( "NETCONF stream buffer is full, notification is dropped" );
+            ntf_metrics_count( NTF_SCOPE_NETCONF, NTF_METRIC_DROPPED, 1 );
+            return -1;
+        }
+        ntf_stream_flush( &ntf_netconf_stream, NTF_STREAM_WAIT_MS );
+        return 0;
+    }
+
     addr.sin_family         = PF_INET;
     addr.sin_addr.s_addr    = htonl( NETCONF_SRV_ADDR );
     addr.sin_port           = htons( NETCONF_SRV_PORT );
 
     /*
-    LOG( "Sending prepared NETCONF notification: \n%s", ntf_netconf_message );
+    LOG( "Sending prepared NETCONF notification: \n%s", message );
     */
 
-    if ( sendto( sockfd, (void*)ntf_netconf_message, strlen(ntf_netconf_message),
+    if ( sendto( sockfd, (void*)message, len,
                  0, (struct sockaddr*)&addr, sizeof(struct sockaddr_in) ) < 0 )
     {
         ERR( "sendto() failed: %s (%d)", strerror(errno), errno );
+        ntf_metrics_count( NTF_SCOPE_NETCONF, NTF_METRIC_SEND_FAILED, 1 );
         return -1;
     }
 
@@ -299,11 +635,291 @@ static int send_netconf_message()
     return 0;
 }
 
+/*
+ * Send message to replay client in chunked frame
+ */
+static int ntf_netconf_replay_send( int fd, const char *msg, size_t len )
+{
+    char header[NTF_STREAM_HEADER_LEN];
+    const char *trailer;
+    size_t header_len, trailer_len;
+    struct iovec iov[3];
+    struct msghdr mh;
+    ssize_t n;
+
+    header_len = ntf_stream_frame( NTF_STREAM_FRAMING_CHUNKED, len, header, &trailer, &trailer_len );
+    iov[0].iov_base = header;
+    iov[0].iov_len  = header_len;
+    iov[1].iov_base = (void *)msg;
+    iov[1].iov_len  = len;
+    iov[2].iov_base = (void *)trailer;
+    iov[2].iov_len  = trailer_len;
+
+    memset( &mh, 0, sizeof( mh ) );
+    mh.msg_iov    = iov;
+    mh.msg_iovlen = 3;
+
+    while ( mh.msg_iovlen > 0 )
+    {
+        n = sendmsg( fd, &mh, MSG_NOSIGNAL );
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n <= 0 )
+            return -1;
+
+        /* skip written part */
+        while ( mh.msg_iovlen > 0 && (size_t)n >= mh.msg_iov->iov_len )
+        {
+            n -= mh.msg_iov->iov_len;
+            ++mh.msg_iov;
+            --mh.msg_iovlen;
+        }
+        if ( mh.msg_iovlen > 0 )
+        {
+            mh.msg_iov->iov_base = (char *)mh.msg_iov->iov_base + n;
+            mh.msg_iov->iov_len -= n;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Serve replay request of connected client
+ */
+static void ntf_netconf_replay_serve( int fd, char *msg, char *out, size_t size )
+{
+    char request[NCNTF_REPLAY_REQUEST_LEN];
+    struct ntf_xml_writer writer;
+    int64_t start_ns, stop_ns, time_ns;
+    uint64_t seq;
+    uint32_t flags;
+    ssize_t len;
+    size_t outlen;
+    int pos, num = 0;
+
+    /* read request line */
+    len = 0;
+    while ( len < (ssize_t)sizeof( request ) - 1 && memchr( request, '\n', len ) == NULL )
+    {
+        pos = recv( fd, request + len, sizeof( request ) - 1 - len, 0 );
+        if ( pos <= 0 )
+            break;
+        len += pos;
+    }
+    request[len] = '\0';
+
+    pos = ntf_xml_parse_time( request, &start_ns );
+    if ( pos < 0 )
+    {
+        ERR( "Bad NETCONF replay request: %s", request );
+        return;
+    }
+    while ( request[pos] == ' ' )
+        ++pos;
+    if ( ntf_xml_parse_time( request + pos, &stop_ns ) < 0 )
+        stop_ns = INT64_MAX;
+
+    for ( seq = ntf_replay_find( &ntf_netconf_replay, start_ns ); ; ++seq )
+    {
+        len = ntf_replay_get( &ntf_netconf_replay, &seq, msg, size, &time_ns, &flags );
+        if ( len == 0 || ( len > 0 && time_ns > stop_ns ) )
+            break;
+        if ( len < 0 )
+            continue;
+
+        if ( flags & NTF_REPLAY_ENVELOPED )
+        {
+            if ( ntf_netconf_replay_send( fd, msg, len ) != 0 )
+                return;
+        }
+        else
+        {
+            /* eventTime is required in replayed notification */
+            ntf_xml_init( &writer, out, size );
+            ntf_xml_envelope_start( &writer, time_ns / 1000000000 );
+            ntf_xml_raw( &writer, msg, len );
+            outlen = ntf_xml_finish( &writer );
+            if ( outlen < size && ntf_netconf_replay_send( fd, out, outlen ) != 0 )
+                return;
+        }
+        ++num;
+    }
+
+    ntf_xml_init( &writer, out, size );
+    ntf_xml_envelope_start( &writer, time( NULL ) );
+    ntf_xml_start( &writer, "replayComplete" );
+    ntf_xml_ns( &writer, NULL, NTF_XML_NS_NETMOD_NOTIFICATION );
+    outlen = ntf_xml_finish( &writer );
+    ntf_netconf_replay_send( fd, out, outlen );
+
+    LOG( "NETCONF replay: %d notifications sent", num );
+}
+
+/*
+ * Thread serving replay requests
+ */
+static void* ntf_netconf_replay_handler( void *arg )
+{
+    struct timeval tv = { NCNTF_REPLAY_TIMEOUT_MS / 1000, ( NCNTF_REPLAY_TIMEOUT_MS % 1000 ) * 1000 };
+    struct pollfd pfd;
+    char *msg, *out;
+    int fd;
+
+    ntf_thread_setup( "netconf", "ntf-nc-replay" );
+
+    msg = malloc( NCNTF_MMXEVENT_MSGSIZE_MAX );
+    out = malloc( NCNTF_MMXEVENT_MSGSIZE_MAX );
+    if ( msg == NULL || out == NULL )
+    {
+        ERR( "Cannot allocate buffers of NETCONF replay" );
+        goto out;
+    }
+
+    pfd.fd     = ntf_netconf_replay_fd;
+    pfd.events = POLLIN;
+    while ( ntf_netconf_replay_running )
+    {
+        if ( poll( &pfd, 1, NCNTF_REPLAY_TIMEOUT_MS ) <= 0 )
+            continue;
+
+        fd = accept( ntf_netconf_replay_fd, NULL, NULL );
+        if ( fd < 0 )
+            continue;
+
+        /* client which stops reading must not hold the replay thread */
+        setsockopt( fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof( tv ) );
+        setsockopt( fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof( tv ) );
+        ntf_netconf_replay_serve( fd, msg, out, NCNTF_MMXEVENT_MSGSIZE_MAX );
+        close( fd );
+    }
+
+out:
+    free( msg );
+    free( out );
+    return NULL;
+}
+
+/*
+ * Open replay buffer and start serving replay requests on 'address'
+ */
+static int ntf_netconf_replay_start( const char *address )
+{
+    char buffer[NCNTF_REPLAY_REQUEST_LEN] = { 0 };
+    size_t size = NTF_REPLAY_DATA_LEN;
+    long value;
+    socklen_t addrlen;
+    int one = 1;
+
+    if ( ntf_stream_address( address, &ntf_netconf_replay_addr, &addrlen ) != 0 )
+    {
+        ERR( "Bad NETCONF replay address '%s'", address );
+        return -1;
+    }
+
+    if ( ntfsettings_get_int( "netconf_replay_size", &value ) == 0 && value > 0 )
+        size = value;
+    ntfsettings_get( "netconf_replay_file", buffer, sizeof( buffer ) );
+
+    if ( ntf_replay_open( &ntf_netconf_replay, size, ( buffer[0] != '\0' ) ? buffer : NULL ) != 0 )
+        goto reterr;
+
+    ntf_netconf_replay_fd = socket( ntf_netconf_replay_addr.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+    if ( ntf_netconf_replay_fd < 0 )
+        goto reterr;
+    if ( ntf_netconf_replay_addr.ss_family == AF_UNIX )
+        unlink( ( (struct sockaddr_un *)&ntf_netconf_replay_addr )->sun_path );
+    else
+        setsockopt( ntf_netconf_replay_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof( one ) );
+
+    if ( bind( ntf_netconf_replay_fd, (struct sockaddr *)&ntf_netconf_replay_addr, addrlen ) != 0 ||
+         listen( ntf_netconf_replay_fd, 4 ) != 0 )
+    {
+        ERR( "Cannot listen on NETCONF replay address '%s': %s (%d)", address, strerror(errno), errno );
+        goto reterr;
+    }
+
+    ntf_netconf_replay_running = 1;
+    if ( pthread_create( &ntf_netconf_replay_thread, NULL, &ntf_netconf_replay_handler, NULL ) != 0 )
+    {
+        ERR( "Cannot create pthread for NETCONF replay" );
+        ntf_netconf_replay_running = 0;
+        goto reterr;
+    }
+
+    ntf_netconf_use_replay = 1;
+    return 0;
+
+reterr:
+    if ( ntf_netconf_replay_fd >= 0 )
+        close( ntf_netconf_replay_fd );
+    ntf_netconf_replay_fd = -1;
+    ntf_replay_close( &ntf_netconf_replay );
+    return -1;
+}
+
+/*
+ * Stop serving replay requests and close replay buffer
+ */
+static void ntf_netconf_replay_stop()
+{
+    if ( !ntf_netconf_use_replay )
+        return;
+
+    ntf_netconf_replay_running = 0;
+    pthread_join( ntf_netconf_replay_thread, NULL );
+
+    close( ntf_netconf_replay_fd );
+    ntf_netconf_replay_fd = -1;
+    if ( ntf_netconf_replay_addr.ss_family == AF_UNIX )
+        unlink( ( (struct sockaddr_un *)&ntf_netconf_replay_addr )->sun_path );
+
+    ntf_replay_close( &ntf_netconf_replay );
+    ntf_netconf_use_replay = 0;
+}
+
 /*
  * NETCONF listener 'init' function implementation
  */
 int ntf_netconf_init( void *args )
 {
+    char address[128] = { 0 };
+    int i;
+
+    ntf_netconf_envelope = 0;
+    ntfsettings_get_bool( "netconf_envelope", &ntf_netconf_envelope );
+
+    /* compile XML templates of notifications */
+    for ( i = 0; i < NTF_MAX_DB_MESSAGE_NUM; ++i )
+    {
+        if ( ntf_netconf_db[i].msg_id == NTF_MSG_NOTUSED )
+            break;
+
+        if ( ntf_netconf_template_compile( &ntf_netconf_db[i], &ntf_netconf_templates[i] ) != 0 )
+            ERR( "Cannot compile XML template of notification %d", ntf_netconf_db[i].msg_id );
+    }
+
+    /* start replay if configured */
+    if ( ntfsettings_get( "netconf_replay", address, sizeof( address ) ) == 0 && address[0] != '\0' )
+    {
+        if ( ntf_netconf_replay_start( address ) != 0 )
+            ERR( "NETCONF replay is disabled" );
+    }
+
+    /* open persistent stream if configured */
+    if ( ntfsettings_get( "netconf_stream", address, sizeof( address ) ) == 0 && address[0] != '\0' )
+    {
+        if ( ntf_stream_init( &ntf_netconf_stream, "netconf", address,
+                              NTF_STREAM_FRAMING_CHUNKED, NTF_STREAM_BUFFER_LEN ) != 0 )
+        {
+            ntf_stream_close( &ntf_netconf_stream );
+            ntf_netconf_replay_stop();
+            return -1;
+        }
+        ntf_netconf_use_stream = 1;
+        return 0;
+    }
+
     /* open communication socket */
     sockfd = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
     if ( sockfd == -1 )
@@ -319,6 +935,23 @@ int ntf_netconf_init( void *args )
  */
 int ntf_netconf_clean()
 {
+    int i;
+
+    for ( i = 0; i < NTF_MAX_DB_MESSAGE_NUM; ++i )
+        ntf_netconf_template_free( &ntf_netconf_templates[i] );
+
+    ntf_netconf_pool_free();
+    ntf_netconf_replay_stop();
+
+    if ( ntf_netconf_use_stream )
+    {
+        /* give the server a chance to read the rest */
+        ntf_stream_flush( &ntf_netconf_stream, NTF_STREAM_WAIT_MS );
+        ntf_stream_report( &ntf_netconf_stream );
+        ntf_stream_close( &ntf_netconf_stream );
+        ntf_netconf_use_stream = 0;
+    }
+
     if ( sockfd != -1 )
     {
         /* close communication socket */
@@ -330,12 +963,14 @@ int ntf_netconf_clean()
 }
 
 /*
- * NETCONF listener 'func' function implementation
- *   used to notify NETCONF server of hapenning events
+ * Prepare NETCONF message of notification in 'buffer', it is grown
+ * if message is not fit
+ * Returns: length of message, 0 if notification is not sent to NETCONF
+ * server, negative value on error
  */
-int ntf_send_netconf_notif( struct ing_notification *notif )
+static ssize_t ntf_netconf_render( struct ing_notification *notif, struct ntf_netconf_buffer *buffer )
 {
-    int msglen;
+    ssize_t msglen;
     struct ntf_netconf_db_entry *netconf_notif = NULL;
     int res;
 
@@ -356,19 +991,141 @@ int ntf_send_netconf_notif( struct ing_notification *notif )
         res = netconf_notif->validate(notif);
         if (res == 1){
             LOG("sending notification is not needed (msg id %d)", notif->msg_id);
+            ntf_metrics_count( NTF_SCOPE_NETCONF, NTF_METRIC_SUPPRESSED, 1 );
             return 0;
         } else if (res != 0){
             ERR("validate notification error (msg id %d)", notif->msg_id);
-            return res;
+            return res < 0 ? res : -1;
         }
     }
 
-    msglen = prepare_netconf_message( notif, netconf_notif );
-    if ( msglen <= 0 )
+    msglen = prepare_netconf_message( notif, netconf_notif, buffer->data, buffer->size );
+    if ( msglen >= (ssize_t)buffer->size )
+    {
+        if ( ntf_netconf_buffer_grow( buffer, msglen ) != 0 )
+        {
+            ERR( "Cannot allocate %zd bytes for NETCONF notification (%d) message",
+                 msglen + 1, notif->msg_id );
+            return -1;
+        }
+        msglen = prepare_netconf_message( notif, netconf_notif, buffer->data, buffer->size );
+    }
+
+    if ( msglen <= 0 || msglen >= (ssize_t)buffer->size )
     {
         ERR( "Cannot prepare NETCONF notification (%d) message", notif->msg_id );
         return -1;
     }
 
-    return send_netconf_message();
+    if ( ntf_netconf_use_replay )
+        ntf_replay_append( &ntf_netconf_replay, buffer->data, msglen,
+                           ntf_netconf_envelope ? NTF_REPLAY_ENVELOPED : 0 );
+
+    return msglen;
+}
+
+/*
+ * NETCONF listener 'func' function implementation
+ *   used to notify NETCONF server of hapenning events
+ */
+int ntf_send_netconf_notif( struct ing_notification *notif )
+{
+    struct ntf_netconf_buffer *buffer;
+    ssize_t msglen;
+    int res;
+
+    buffer = ntf_netconf_buffer_get();
+    if ( buffer == NULL )
+    {
+        ERR( "Cannot allocate buffer for NETCONF notification (%d)", notif->msg_id );
+        return -1;
+    }
+
+    msglen = ntf_netconf_render( notif, buffer );
+    if ( msglen <= 0 )
+        res = (int)msglen;
+    else
+        res = send_netconf_message( buffer->data, msglen );
+
+    ntf_netconf_buffer_put( buffer );
+    return res;
+}
+
+/*
+ * NETCONF listener 'batch' function implementation
+ *   all messages of the batch are sent to NETCONF server with one system call
+ */
+int ntf_send_netconf_batch( struct ing_notification *notifs, int n )
+{
+    struct ntf_netconf_buffer *buffers[NTF_LISTENER_BATCH_MAX] = { NULL };
+    struct mmsghdr msgs[NTF_LISTENER_BATCH_MAX];
+    struct iovec iov[NTF_LISTENER_BATCH_MAX];
+    struct sockaddr_in addr = {0};
+    int i, count, sent, res;
+    ssize_t msglen;
+
+    addr.sin_family         = PF_INET;
+    addr.sin_addr.s_addr    = htonl( NETCONF_SRV_ADDR );
+    addr.sin_port           = htons( NETCONF_SRV_PORT );
+
+    memset( msgs, 0, sizeof( msgs ) );
+    count = 0;
+    for ( i = 0; i < n && i < NTF_LISTENER_BATCH_MAX; ++i )
+    {
+        if ( buffers[count] == NULL )
+        {
+            buffers[count] = ntf_netconf_buffer_get();
+            if ( buffers[count] == NULL )
+            {
+                ERR( "Cannot allocate buffer for NETCONF notification (%d)", notifs[i].msg_id );
+                break;
+            }
+        }
+
+        msglen = ntf_netconf_render( &notifs[i], buffers[count] );
+        if ( msglen <= 0 )
+            continue;
+
+        if ( ntf_netconf_use_stream )
+        {
+            /* messages are coalesced in stream buffer and written at once */
+            if ( ntf_stream_send( &ntf_netconf_stream, buffers[count]->data, msglen ) != 0 )
+            {
+                ERR( "NETCONF stream buffer is full, notification (%d) is dropped", notifs[i].msg_id );
+                ntf_metrics_count( NTF_SCOPE_NETCONF, NTF_METRIC_DROPPED, 1 );
+            }
+            continue;
+        }
+
+        iov[count].iov_base = buffers[count]->data;
+        iov[count].iov_len  = msglen;
+        msgs[count].msg_hdr.msg_name    = &addr;
+        msgs[count].msg_hdr.msg_namelen = sizeof( struct sockaddr_in );
+        msgs[count].msg_hdr.msg_iov     = &iov[count];
+        msgs[count].msg_hdr.msg_iovlen  = 1;
+        ++count;
+    }
+
+    res = 0;
+    if ( ntf_netconf_use_stream )
+        ntf_stream_flush( &ntf_netconf_stream, NTF_STREAM_WAIT_MS );
+    else if ( count > 0 )
+    {
+        sent = sendmmsg( sockfd, msgs, count, 0 );
+        if ( sent < 0 )
+        {
+            ERR( "sendmmsg() failed: %s (%d)", strerror(errno), errno );
+            res = -1;
+            sent = 0;
+        }
+        if ( sent < count )
+            ntf_metrics_count( NTF_SCOPE_NETCONF, NTF_METRIC_SEND_FAILED, (unsigned long)( count - sent ) );
+    }
+
+    /* the buffer after the last sent message is taken if the last
+     * notification was not rendered */
+    for ( i = 0; i < NTF_LISTENER_BATCH_MAX; ++i )
+        ntf_netconf_buffer_put( buffers[i] );
+
+    return res;
 }
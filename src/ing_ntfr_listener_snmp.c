@@ -74,6 +74,7 @@
 
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 #include <sys/socket.h>
@@ -86,6 +87,7 @@
 #include "ing_ntfr_messages.h"
 #include "ing_ntfr_settings.h"
 #include "ing_ntfr_listeners.h"
+#include "ing_ntfr_metrics.h"
 
 /*
  * Constants
@@ -95,25 +97,103 @@
   * snmptrap v1 format : snmptrap -L n -v 1 -c <community> <trap-addr> <enterprise-id> <agent-addr> <trap-id> <ent-trap-value> <time> <varbinds>
   * snmptrap v2c format : snmptrap -L n -v 2c -c <community> <trap-addr> <time> <enterprise-id> <varbinds>
  */
-#define NTF_SNMP_TRAP_STR "/usr/bin/snmptrap -L n -v 2c -c %s %s \"\" %s %s >/dev/null\n "\
-                          "/usr/bin/snmptrap -L n -v 1 -c %s %s %s %s %d 0 \"\" %s >/dev/null"
+#define NTF_SNMP_TRAP_STR "/usr/bin/snmptrap -L n -v 2c -c %s %s \"\" %s %s >/dev/null"
+/* v1 trap is appended only for IPv4 server, agent address of v1 is IPv4 only */
+#define NTF_SNMP_TRAP_V1_STR "\n /usr/bin/snmptrap -L n -v 1 -c %s %s %s %s %d 0 \"\" %s >/dev/null"
 /* first  - SNMP address,
  * second - trap OID
  */
 
+/* max number of SNMP servers and length of server address */
+#define NTF_SNMP_SERVERS_MAX 4
+#define NTF_SNMP_ADDR_LEN    64
+
 /*
  * Export database from auto-generated file
  */
 extern struct ntf_snmp_db_entry ntf_snmp_db[NTF_MAX_DB_MESSAGE_NUM];
 
 /*
- * Get SNMP server address
+ * Get local IPv4 address used to reach SNMP server, it is the v1 trap
+ * agent address. UDP connect only selects route, nothing is sent.
+ * Host part of server address is used if local address is unknown
  */
-char* ntf_get_snmp_server_addr( char *buffer, size_t buff_len )
+static void ntf_snmp_agent_addr( struct sockaddr_in *srv, char *agent, size_t len )
 {
-    if ( ntfsettings_get( "snmp_srv", buffer, buff_len ) != 0 )
-        return NULL;
-    return buffer;
+    struct sockaddr_in dst, local;
+    socklen_t local_len = sizeof( local );
+    int sock;
+
+    dst = *srv;
+    if ( dst.sin_port == 0 )
+        dst.sin_port = htons( 162 );
+
+    sock = socket( AF_INET, SOCK_DGRAM, 0 );
+    if ( sock >= 0 )
+    {
+        if ( connect( sock, (struct sockaddr *)&dst, sizeof( dst ) ) == 0 &&
+             getsockname( sock, (struct sockaddr *)&local, &local_len ) == 0 &&
+             local.sin_addr.s_addr != htonl( INADDR_ANY ) )
+        {
+            inet_ntop( AF_INET, &local.sin_addr, agent, len );
+            close( sock );
+            return;
+        }
+        close( sock );
+    }
+
+    inet_ntop( AF_INET, &srv->sin_addr, agent, len );
+}
+
+/*
+ * Get SNMP server addresses in snmptrap format, "a.b.c.d[:port]" or
+ * "udp6:[ipv6][:port]". Addresses are validated on load, so they are
+ * safe to be passed to shell. Only numeric addresses are accepted in
+ * 'snmp_srv', a value with host name is rejected on load.
+ * 'agents' gets bare IPv4 agent address for v1 trap of each server,
+ * empty string for IPv6 server
+ * Returns: number of addresses, 0 if no valid server is configured
+ */
+int ntf_get_snmp_server_addrs( char addrs[][NTF_SNMP_ADDR_LEN],
+                               char agents[][INET_ADDRSTRLEN], int addrs_max )
+{
+    struct sockaddr_storage srv[NTF_SNMP_SERVERS_MAX];
+    struct sockaddr_in  *srv4;
+    struct sockaddr_in6 *srv6;
+    char host[INET6_ADDRSTRLEN];
+    int i, num, port;
+
+    num = addrs_max < NTF_SNMP_SERVERS_MAX ? addrs_max : NTF_SNMP_SERVERS_MAX;
+    if ( ntfsettings_get_addresses( "snmp_srv", srv, &num ) != 0 )
+        return 0;
+
+    for ( i = 0; i < num; ++i )
+    {
+        if ( srv[i].ss_family == AF_INET )
+        {
+            srv4 = (struct sockaddr_in *)&srv[i];
+            inet_ntop( AF_INET, &srv4->sin_addr, host, sizeof( host ) );
+            ntf_snmp_agent_addr( srv4, agents[i], INET_ADDRSTRLEN );
+            port = ntohs( srv4->sin_port );
+            if ( port != 0 )
+                snprintf( addrs[i], NTF_SNMP_ADDR_LEN, "%s:%d", host, port );
+            else
+                snprintf( addrs[i], NTF_SNMP_ADDR_LEN, "%s", host );
+        }
+        else
+        {
+            srv6 = (struct sockaddr_in6 *)&srv[i];
+            inet_ntop( AF_INET6, &srv6->sin6_addr, host, sizeof( host ) );
+            agents[i][0] = '\0';
+            port = ntohs( srv6->sin6_port );
+            if ( port != 0 )
+                snprintf( addrs[i], NTF_SNMP_ADDR_LEN, "udp6:[%s]:%d", host, port );
+            else
+                snprintf( addrs[i], NTF_SNMP_ADDR_LEN, "udp6:[%s]", host );
+        }
+    }
+
+    return num;
 }
 char* ntf_get_snmp_community( char *buffer, size_t buff_len )
 {
@@ -206,10 +286,11 @@ int ntf_snmp_clean( void __attribute__((__unused__)) *args )
 int ntf_call_snmp_trap(struct ing_notification *notif )
 {
     char community[64] = { 0 };
-    char trap_addr[64] = { 0 };
+    char trap_addrs[NTF_SNMP_SERVERS_MAX][NTF_SNMP_ADDR_LEN];
+    char agent_addrs[NTF_SNMP_SERVERS_MAX][INET_ADDRSTRLEN];
     char  cmd[1024] = { 0 };
     char  args[896] = { 0 };
-    int  i, j, res;
+    int  i, j, res, addrs_num, pos;
     int msg_found;
     FILE *pf;
 
@@ -227,6 +308,7 @@ int ntf_call_snmp_trap(struct ing_notification *notif )
                 res = ntf_snmp_db[i].validate(notif);
                 if (res == 1){
                     LOG("sending notification is not needed (msg id %d)", notif->msg_id);
+                    ntf_metrics_count( NTF_SCOPE_SNMP, NTF_METRIC_SUPPRESSED, 1 );
                     return 0;
                 } else if (res != 0){
                     ERR("validate notification error (msg id %d)", notif->msg_id);
@@ -234,21 +316,15 @@ int ntf_call_snmp_trap(struct ing_notification *notif )
                 }
             }
             ntf_get_snmp_community( &community[0], sizeof( community ) );
-            ntf_get_snmp_server_addr( &trap_addr[0], sizeof( trap_addr ) );
             for( j = 0; j < ntf_snmp_db[i].param_num; ++j )
                 if (ntf_snmp_add_param( args, sizeof( args ),
                                                    &ntf_snmp_db[i], notif, (size_t)j ) != 0)
                 {
                     ERR( "Cannot prepare SNMP notification (%d) message (param idx: %d)", notif->msg_id, j );
+                    ntf_metrics_count( NTF_SCOPE_SNMP, NTF_METRIC_CONVERT_FAILED, 1 );
                     return -1;
                 }
             msg_found = 1;
-            sprintf( cmd, NTF_SNMP_TRAP_STR,
-                // prepare msg for snmp version 2c
-                community,trap_addr, ntf_snmp_db[i].trap_oid, args,
-                // prepare msg for snmp version 1
-                // TODO. need put correct value for agent address
-                community,trap_addr, ntf_snmp_db[i].trap_oid, trap_addr, ntf_snmp_db[i].trap_type, args );
             break;
         }
     }
@@ -257,7 +333,15 @@ int ntf_call_snmp_trap(struct ing_notification *notif )
     {
         return 0;
     }
-    LOG( "SNMP trap cmd:\n  %s", cmd );
+
+    addrs_num = ntf_get_snmp_server_addrs( trap_addrs, agent_addrs, NTF_SNMP_SERVERS_MAX );
+    if ( addrs_num == 0 )
+    {
+        ERR( "No valid SNMP server in snmp_srv (numeric addresses only), "
+             "notification %d is not sent", notif->msg_id );
+        ntf_metrics_count( NTF_SCOPE_SNMP, NTF_METRIC_SEND_FAILED, 1 );
+        return -1;
+    }
 
     /* ToDo add '&' to the end of string */
     /*
@@ -273,8 +357,24 @@ int ntf_call_snmp_trap(struct ing_notification *notif )
     pclose( pf );
     */
 
-    if (system(cmd) != 0)
-        ERR( "Cannot send SNMP notification");
+    for ( j = 0; j < addrs_num; ++j )
+    {
+        // prepare msg for snmp version 2c
+        pos = snprintf( cmd, sizeof( cmd ), NTF_SNMP_TRAP_STR,
+            community, trap_addrs[j], ntf_snmp_db[i].trap_oid, args );
+        // prepare msg for snmp version 1
+        if ( agent_addrs[j][0] != '\0' && pos > 0 && (size_t)pos < sizeof( cmd ) )
+            snprintf( &cmd[pos], sizeof( cmd ) - pos, NTF_SNMP_TRAP_V1_STR,
+                community, trap_addrs[j], ntf_snmp_db[i].trap_oid, agent_addrs[j],
+                ntf_snmp_db[i].trap_type, args );
+        LOG( "SNMP trap cmd:\n  %s", cmd );
+
+        if (system(cmd) != 0)
+        {
+            ERR( "Cannot send SNMP notification to %s", trap_addrs[j] );
+            ntf_metrics_count( NTF_SCOPE_SNMP, NTF_METRIC_SEND_FAILED, 1 );
+        }
+    }
 
     return 0;
 }
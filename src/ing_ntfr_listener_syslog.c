@@ -72,234 +72,821 @@
 /* This file contains notification listeners implementation
  */
 
+#define _GNU_SOURCE
+
 #include <errno.h>
-#include <stdarg.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/select.h>
+#include <sys/uio.h>
+#include <pthread.h>
+#include <time.h>
 #include <netinet/in.h>
-#include <arpa/inet.h>
 #include <syslog.h>
 
 #include "ing_ntfr_defines.h"
 #include "ing_ntfr_messages.h"
 #include "ing_ntfr_listeners.h"
 #include "ing_ntfr_settings.h"
+#include "ing_ntfr_stream.h"
+#include "ing_ntfr_metrics.h"
 
 
 #define SYSLOG_PORT 514
 
+#define NTF_SYSLOG_LINE_LEN 2048
+/* number of syslog servers: 'syslog_srv', 'syslog_srv_2' ... */
+#define NTF_SYSLOG_DEST_MAX 4
+
+#define NTF_SYSLOG_DEST_LEN 128
+
+/* lines of a batch are formatted to per-thread buffer of this size */
+#define NTF_SYSLOG_BATCH_BUF (64 * 1024)
+
+#define NTF_SYSLOG_MSGS_MAX (NTF_LISTENER_BATCH_MAX * NTF_SYSLOG_DEST_MAX)
+
+
+#define NTF_SYSLOG_SEGMENTS_MAX (2 * NTF_PARAM_IN_MSG_MAX + 1)
+
+#define NTF_SYSLOG_APP_NAME "ingnotifier"
+
+/* SD-ID of notification parameters is "<name>@<enterprise number>" of
+ * the vendor, set by 'syslog_sd_id'; STRUCTURED-DATA is not sent without it */
+#define NTF_SYSLOG_SD_ID_LEN 33
+
+/*
+ * Message formats
+ */
+enum ntf_syslog_rfc
+{
+    NTF_SYSLOG_RFC3164 = 0, /* <PRI>Mmm dd hh:mm:ss MSG                              */
+    NTF_SYSLOG_RFC5424      /* <PRI>1 TIMESTAMP HOST APP PROCID MSGID [SD-ELEMENT] MSG */
+};
+
+/*
+ * Compiled 'msg_text' of syslog db entry: literal text segments
+ * and segments referring to notification parameter
+ */
+struct ntf_syslog_segment
+{
+    const char *text;
+    size_t      len;
+    int         param; /* index of parameter, -1 for literal text */
+};
+
+struct ntf_syslog_format
+{
+    int valid;
+    int segments_num;
+    struct ntf_syslog_segment segments[NTF_SYSLOG_SEGMENTS_MAX];
+};
+/*
+ * Timestamp of the current second, formatted once per second by each thread
+ */
+struct ntf_syslog_clock
+{
+    time_t sec;
+    size_t len;
+    char   text[32];
+};
+
+/*
+ * Syslog server
+ *
+ *  Server gets notifications of 'severity' and more severe ones, lines
+ *  are formatted according to 'rfc' with 'facility'. Servers sharing
+ *  format and facility get the same line, it is formatted once
+ */
+struct ntf_syslog_dest
+{
+    struct sockaddr_storage addr;
+    socklen_t addrlen;
+    int severity;
+    int facility;
+    int rfc;
+    int variant; /* index of (rfc, facility) pair among servers */
+};
+
+struct ntf_syslog_dests
+{
+    int dests_num;
+    int variants_num;
+    struct ntf_syslog_dest dests[NTF_SYSLOG_DEST_MAX];
+};
+
+struct ntf_syslog_name
+{
+    const char *name;
+    int         value;
+};
+
 
-/* UDP socket to send syslog messages */
+/* UDP socket to send syslog messages, IPv4 servers are reached
+ * through IPv4-mapped addresses if it is IPv6 socket */
 static int sockfd = -1;
+static int sockfamily = AF_UNSPEC;
 
-/* syslog-server IP address */
-static char syslog_address[16];
+/*
+ * Syslog servers; the table is rebuilt by listener thread before the
+ * next message is sent if settings subsystem reported a change of
+ * server addresses
+ */
+static const char *syslog_dest_keys[NTF_SYSLOG_DEST_MAX] =
+{
+    "syslog_srv", "syslog_srv_2", "syslog_srv_3", "syslog_srv_4"
+};
+static struct ntf_syslog_dests syslog_dests;
+static int syslog_dests_changed = 0;
+static pthread_rwlock_t syslog_dests_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+static const struct ntf_syslog_name syslog_severity_names[] =
+{
+    { "emerg",   LOG_EMERG   }, { "alert",  LOG_ALERT   }, { "crit",  LOG_CRIT  },
+    { "err",     LOG_ERR     }, { "error",  LOG_ERR     }, { "warning", LOG_WARNING },
+    { "warn",    LOG_WARNING }, { "notice", LOG_NOTICE  }, { "info",  LOG_INFO  },
+    { "debug",   LOG_DEBUG   }, { NULL, 0 }
+};
+
+static const struct ntf_syslog_name syslog_facility_names[] =
+{
+    { "kern",   LOG_KERN   }, { "user",     LOG_USER     }, { "mail",   LOG_MAIL   },
+    { "daemon", LOG_DAEMON }, { "auth",     LOG_AUTH     }, { "syslog", LOG_SYSLOG },
+    { "lpr",    LOG_LPR    }, { "news",     LOG_NEWS     }, { "uucp",   LOG_UUCP   },
+    { "cron",   LOG_CRON   }, { "authpriv", LOG_AUTHPRIV }, { "ftp",    LOG_FTP    },
+    { "local0", LOG_LOCAL0 }, { "local1",   LOG_LOCAL1   }, { "local2", LOG_LOCAL2 },
+    { "local3", LOG_LOCAL3 }, { "local4",   LOG_LOCAL4   }, { "local5", LOG_LOCAL5 },
+    { "local6", LOG_LOCAL6 }, { "local7",   LOG_LOCAL7   }, { NULL, 0 }
+};
+
+/*
+ * Stream to syslog server, used instead of UDP socket if 'syslog_stream'
+ * address is configured (TCP collector or local AF_UNIX stream socket).
+ * Lines are sent with RFC 6587 octet counting framing
+ */
+static struct ntf_stream syslog_stream;
+static int syslog_use_stream = 0;
 
 
 /*
  * Export database from auto-generated file
  */
-struct ntf_syslog_db_entry ntf_syslog_db[NTF_MAX_DB_MESSAGE_NUM];
+extern struct ntf_syslog_db_entry ntf_syslog_db[NTF_MAX_DB_MESSAGE_NUM];
+
+/* formats compiled at init, index is the same as in ntf_syslog_db */
+static struct ntf_syslog_format ntf_syslog_formats[NTF_MAX_DB_MESSAGE_NUM];
+
+static int syslog_rfc = NTF_SYSLOG_RFC3164;
+static char syslog_hostname[64] = "-";
+static char syslog_procid[16] = "-";
+static char syslog_sd_id[NTF_SYSLOG_SD_ID_LEN] = "";
+
+static __thread struct ntf_syslog_clock syslog_clock[2] = { { -1, 0, "" }, { -1, 0, "" } };
 
 /*
- * Check if syslog-server address has changed.
- * Returns: zero if not changed, not zero if changed.
- * If address is changed, also copy new address to 'syslog_address' global varibale.
+ * Create UDP socket, IPv6 one accepting IPv4 servers if possible
  */
-static int update_syslog_address()
+static int open_socket()
 {
-    char buf[16];
-    int ret;
+    int off = 0;
+
+    sockfd = socket(AF_INET6, SOCK_DGRAM, 0);
+    if (sockfd != -1 && setsockopt(sockfd, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off)) == 0)
+    {
+        sockfamily = AF_INET6;
+        return 0;
+    }
 
-    ret = 0;
+    if (sockfd != -1)
+        close(sockfd);
 
-    if (!ntfsettings_get("syslog_srv", buf, sizeof(buf)))
+    /* no IPv6 support */
+    sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sockfd == -1)
     {
-        if (strcmp(buf, syslog_address))
+        ERR("socket() failed: %s (%d)", strerror(errno), errno);
+        return 1;
+    }
+    sockfamily = AF_INET;
+
+    return 0;
+}
+
+/*
+ * Find value of 'name' in the table
+ */
+static int ntf_syslog_name_find( const struct ntf_syslog_name *names, const char *name, int *value )
+{
+    for ( ; names->name != NULL; ++names )
+    {
+        if ( strcmp( names->name, name ) == 0 )
         {
-            strcpy(syslog_address, buf);
-            ret = 1;
+            *value = names->value;
+            return 0;
         }
     }
 
-    return ret;
+    return -1;
 }
 
 /*
- * Create socket to access syslog server.
- * Socket is recreated if syslog server address has changed.
+ * Parse syslog server "<address>[:<port>] [<severity>] [<facility>] [rfc3164|rfc5424]",
+ * IPv6 address with port is given in brackets, e.g. "[2001:db8::1]:514 warning local3"
  */
-static int update_socket()
+static int ntf_syslog_dest_parse( const char *value, struct ntf_syslog_dest *dest )
 {
-    int ret;
-    struct sockaddr_in addr;
+    char buf[NTF_SYSLOG_DEST_LEN], *host, *token, *save;
+    struct sockaddr_in  *sin  = (struct sockaddr_in *)&dest->addr;
+    struct sockaddr_in6 *sin6 = (struct sockaddr_in6 *)&dest->addr;
+    struct in_addr addr4;
+    in_port_t port;
+
+    memset( dest, 0, sizeof( struct ntf_syslog_dest ) );
+    dest->severity = LOG_DEBUG;
+    dest->facility = LOG_USER;
+    dest->rfc      = syslog_rfc;
 
-    ret = 0;
+    strncpy( buf, value, sizeof( buf ) - 1 );
+    buf[sizeof( buf ) - 1] = '\0';
 
-    if (update_syslog_address())
+    host = strtok_r( buf, " \t", &save );
+    if ( host == NULL || ntfsettings_parse_address( host, &dest->addr ) != 0 )
+        return -1;
+
+    if ( dest->addr.ss_family == AF_INET )
     {
-        /* syslog address has changed */
-        if (sockfd != -1)
+        port = ( sin->sin_port != 0 ) ? sin->sin_port : htons( SYSLOG_PORT );
+        if ( sockfamily == AF_INET6 )
         {
-            close(sockfd);
-            sockfd = -1;
+            /* IPv4-mapped address */
+            addr4 = sin->sin_addr;
+            memset( &dest->addr, 0, sizeof( dest->addr ) );
+            sin6->sin6_family = AF_INET6;
+            sin6->sin6_port   = port;
+            sin6->sin6_addr.s6_addr[10] = 0xff;
+            sin6->sin6_addr.s6_addr[11] = 0xff;
+            memcpy( &sin6->sin6_addr.s6_addr[12], &addr4, sizeof( addr4 ) );
+            dest->addrlen = sizeof( struct sockaddr_in6 );
         }
-
-        sockfd = socket(AF_INET, SOCK_DGRAM, 0);
-        if (sockfd == -1)
+        else
+        {
+            sin->sin_port = port;
+            dest->addrlen = sizeof( struct sockaddr_in );
+        }
+    }
+    else
+    {
+        if ( sockfamily != AF_INET6 )
         {
-            ERR("socket() failed: %s (%d)", strerror(errno), errno);
-            ret = 1;
-            goto out;
+            ERR( "IPv6 is not supported, syslog server %s is ignored", host );
+            return -1;
         }
+        if ( sin6->sin6_port == 0 )
+            sin6->sin6_port = htons( SYSLOG_PORT );
+        dest->addrlen = sizeof( struct sockaddr_in6 );
+    }
+
+    while ( ( token = strtok_r( NULL, " \t", &save ) ) != NULL )
+    {
+        if ( strcmp( token, "rfc3164" ) == 0 )
+            dest->rfc = NTF_SYSLOG_RFC3164;
+        else if ( strcmp( token, "rfc5424" ) == 0 )
+            dest->rfc = NTF_SYSLOG_RFC5424;
+        else if ( ntf_syslog_name_find( syslog_severity_names, token, &dest->severity ) != 0 &&
+                  ntf_syslog_name_find( syslog_facility_names, token, &dest->facility ) != 0 )
+            return -1;
+    }
+
+    return 0;
+}
 
-        update_syslog_address();
+/*
+ * Build table of syslog servers from settings
+ */
+static void ntf_syslog_dests_load( struct ntf_syslog_dests *dests )
+{
+    char value[NTF_SYSLOG_DEST_LEN];
+    struct ntf_syslog_dest *dest;
+    int i, j;
+
+    memset( dests, 0, sizeof( struct ntf_syslog_dests ) );
 
-        memset(&addr, 0, sizeof(struct sockaddr_in));
-        addr.sin_family = AF_INET;
-        addr.sin_port = htons(SYSLOG_PORT);
-        addr.sin_addr.s_addr = inet_addr(syslog_address);
+    for ( i = 0; i < NTF_SYSLOG_DEST_MAX; ++i )
+    {
+        memset( value, 0, sizeof( value ) );
+        if ( ntfsettings_get( (char *)syslog_dest_keys[i], value, sizeof( value ) - 1 ) != 0 ||
+             value[0] == '\0' )
+            continue;
 
-        if (connect(sockfd, (struct sockaddr *)&addr, sizeof(struct sockaddr_in)) == -1)
+        dest = &dests->dests[dests->dests_num];
+        if ( ntf_syslog_dest_parse( value, dest ) != 0 )
         {
-            ERR("connect() failed: %s (%d)", strerror(errno), errno);
-            close(sockfd);
-            sockfd = -1;
-            ret = 1;
-            goto out;
+            ERR( "Bad syslog server '%s' in %s", value, syslog_dest_keys[i] );
+            continue;
         }
-    }
 
-out:
-    return ret;
+        /* servers with the same format and facility share the line */
+        dest->variant = dests->variants_num;
+        for ( j = 0; j < dests->dests_num; ++j )
+        {
+            if ( dests->dests[j].rfc == dest->rfc && dests->dests[j].facility == dest->facility )
+            {
+                dest->variant = dests->dests[j].variant;
+                break;
+            }
+        }
+        if ( dest->variant == dests->variants_num )
+            dests->variants_num++;
+
+        INF( "syslog server %s: '%s'", syslog_dest_keys[i], value );
+        dests->dests_num++;
+    }
 }
 
 /*
- * Send a message directly to remote syslog-server.
- * The code is taken from logread.c file.
+ * Settings change event: address of one of syslog servers is changed
  */
-static void send_syslog(int level, const char *format, ...)
+static void syslog_dests_notify( const char *key, const char *value, void *arg )
 {
-    va_list ap;
-    char buf[512];
-    char *c;
-    int p;
-    size_t buflen;
-    time_t t;
+    __atomic_store_n(&syslog_dests_changed, 1, __ATOMIC_RELEASE);
+}
 
-    va_start(ap, format);
+/*
+ * Rebuild table of servers if settings have changed.
+ * Settings are not read here unless the flag is set by change event
+ */
+static void update_dests()
+{
+    if (!__atomic_load_n(&syslog_dests_changed, __ATOMIC_ACQUIRE))
+        return;
 
-    p = level;
-    t = time(NULL);
-    c = ctime(&t);
+    pthread_rwlock_wrlock(&syslog_dests_lock);
+    if (__atomic_exchange_n(&syslog_dests_changed, 0, __ATOMIC_ACQ_REL))
+    {
+        INF("syslog servers are changed");
+        ntf_syslog_dests_load(&syslog_dests);
+    }
+    pthread_rwlock_unlock(&syslog_dests_lock);
+}
 
-    snprintf(buf, sizeof(buf), "<%u>", p);
-    strncat(buf, c + 4, 16);
 /*
-    if (hostname)
+ * Compile 'msg_text' of db entry to segments.
+ * Every conversion of format string is replaced with value of the
+ * next parameter, flags and width of conversions are ignored
+ */
+static int ntf_syslog_compile( struct ntf_syslog_db_entry *entry, struct ntf_syslog_format *fmt )
+{
+    const char *pos, *end;
+    struct ntf_syslog_segment *seg;
+    int conv = 0;
+
+    memset( fmt, 0, sizeof( struct ntf_syslog_format ) );
+    if ( entry->msg_text == NULL )
+        return -1;
+
+    for ( pos = entry->msg_text; *pos != '\0'; pos = end )
     {
-        strncat(buf, hostname, sizeof(buf) - strlen(buf) - 1);
-        strncat(buf, " ", sizeof(buf) - strlen(buf) - 1);
+        if ( fmt->segments_num >= NTF_SYSLOG_SEGMENTS_MAX )
+        {
+            ERR( "Too many segments in syslog message '%s'", entry->msg_text );
+            return -1;
+        }
+        seg = &fmt->segments[fmt->segments_num++];
+        seg->param = -1;
+
+        if ( pos[0] != '%' )
+        {
+            end = strchrnul( pos, '%' );
+            seg->text = pos;
+            seg->len  = end - pos;
+        }
+        else if ( pos[1] == '%' )
+        {
+            seg->text = pos;
+            seg->len  = 1;
+            end = pos + 2;
+        }
+        else
+        {
+            end = pos + 1 + strspn( pos + 1, "-+ #0123456789.hlLqjzt" );
+            if ( *end == '\0' || conv >= entry->param_num || entry->params[conv].input_idx < 1 )
+            {
+                ERR( "Bad conversion %d in syslog message '%s'", conv + 1, entry->msg_text );
+                return -1;
+            }
+            seg->param = entry->params[conv++].input_idx - 1;
+            ++end;
+        }
     }
-    if (log_prefix)
+
+    fmt->valid = 1;
+    return 0;
+}
+
+/*
+ * Append 'len' bytes to the line, the line is truncated if it is too long
+ */
+static size_t ntf_syslog_put( char *buf, size_t size, size_t pos, const char *data, size_t len )
+{
+    if ( pos >= size )
+        return size;
+    if ( len > size - pos )
+        len = size - pos;
+
+    memcpy( buf + pos, data, len );
+    return pos + len;
+}
+
+/*
+ * Append value of SD-PARAM, '"', '\\' and ']' are escaped
+ */
+static size_t ntf_syslog_put_sd( char *buf, size_t size, size_t pos, const char *value )
+{
+    const char *run;
+
+    for ( run = value; *value != '\0'; ++value )
     {
-        strncat(buf, log_prefix, sizeof(buf) - strlen(buf) - 1);
-        strncat(buf, ": ", sizeof(buf) - strlen(buf) - 1);
+        if ( *value == '"' || *value == '\\' || *value == ']' )
+        {
+            pos = ntf_syslog_put( buf, size, pos, run, value - run );
+            pos = ntf_syslog_put( buf, size, pos, "\\", 1 );
+            run = value;
+        }
     }
-*/
-    buflen = strlen(buf);
-    vsnprintf(buf + buflen, sizeof(buf) - buflen, format, ap);
 
-    write(sockfd, buf, strlen(buf));
+    return ntf_syslog_put( buf, size, pos, run, value - run );
+}
 
-    va_end(ap);
+/*
+ * Timestamp of the current second in format of syslog protocol
+ */
+static const char* ntf_syslog_timestamp( int rfc, size_t *len )
+{
+    struct ntf_syslog_clock *clock = &syslog_clock[rfc];
+    time_t now;
+    struct tm tm;
+
+    now = time( NULL );
+    if ( now != clock->sec )
+    {
+        if ( rfc == NTF_SYSLOG_RFC5424 )
+        {
+            gmtime_r( &now, &tm );
+            clock->len = strftime( clock->text, sizeof( clock->text ), "%Y-%m-%dT%H:%M:%SZ", &tm );
+        }
+        else
+        {
+            localtime_r( &now, &tm );
+            clock->len = strftime( clock->text, sizeof( clock->text ), "%b %e %H:%M:%S", &tm );
+        }
+        clock->sec = now;
+    }
+
+    *len = clock->len;
+    return clock->text;
 }
 
 /*
- *
+ * Value of notification parameter
  */
-int ntf_syslog_init( void *args )
+static const char* ntf_syslog_param( struct ing_notification *notif, int idx )
 {
-    return update_socket();
+    if ( idx < 0 || idx >= notif->param_num || notif->params[idx] == NULL )
+        return "(null)";
+
+    return notif->params[idx];
 }
 
 /*
- *
+ * Find compiled format and syslog severity of notification
+ * Returns: format, NULL if notification is not sent to syslog
  */
-int ntf_call_syslog( struct ing_notification *notif )
+static struct ntf_syslog_format* ntf_syslog_lookup( struct ing_notification *notif, int *severity )
 {
-    int severity, i;
+    int i;
 
     switch( notif->severity )
     {
     case NTF_SEVERITY_ALERT:
-        severity = LOG_ALERT;
+        *severity = LOG_ALERT;
         break;
     case NTF_SEVERITY_CRIT:
-        severity = LOG_CRIT;
+        *severity = LOG_CRIT;
         break;
     case NTF_SEVERITY_ERROR:
-        severity = LOG_ERR;
+        *severity = LOG_ERR;
         break;
     case NTF_SEVERITY_WRN:
-        severity = LOG_WARNING;
+        *severity = LOG_WARNING;
         break;
     case NTF_SEVERITY_NTF:
-        severity = LOG_NOTICE;
+        *severity = LOG_NOTICE;
         break;
     case NTF_SEVERITY_INFO:
-        severity = LOG_INFO;
+        *severity = LOG_INFO;
         break;
     case NTF_SEVERITY_DBG:
-        severity = LOG_DEBUG;
+    default:
+        *severity = LOG_DEBUG;
         break;
     }
 
-    /* Set syslog facility */
-    severity |= LOG_USER;
-
-    update_socket();
-
     for( i = 0 ; i < NTF_MAX_DB_MESSAGE_NUM; ++i )
     {
+        if ( ntf_syslog_db[i].msg_id == NTF_MSG_NOTUSED )
+            break;
+
         if ( notif->msg_id == ntf_syslog_db[i].msg_id )
+            return ntf_syslog_formats[i].valid ? &ntf_syslog_formats[i] : NULL;
+    }
+
+    return NULL;
+}
+
+/*
+ * Check SD-ID "<name>@<enterprise number>" (RFC 5424, section 6.3.2)
+ * Returns: 1 if SD-ID is valid, 0 otherwise
+ */
+static int ntf_syslog_sd_id_valid( const char *sd_id )
+{
+    const char *at = NULL, *p;
+
+    for ( p = sd_id; *p != '\0'; ++p )
+    {
+        if ( *p <= ' ' || *p > '~' || *p == '=' || *p == ']' || *p == '"' )
+            return 0;
+        if ( *p == '@' )
         {
-            /* ToDo selfmade parsing for search %s ??? */
-            switch( ntf_syslog_db[i].param_num )
+            if ( at != NULL )
+                return 0;
+            at = p;
+        }
+        else if ( at != NULL && ( *p < '0' || *p > '9' ) && *p != '.' )
+            return 0;
+    }
+
+    return ( at != NULL && at != sd_id && at[1] >= '0' && at[1] <= '9' &&
+             p - sd_id < NTF_SYSLOG_SD_ID_LEN );
+}
+
+/*
+ * Format syslog message of notification with priority 'pri' (facility | severity)
+ * Returns: length of the message, 0 if it cannot be formatted
+ */
+static size_t ntf_syslog_format( struct ing_notification *notif, struct ntf_syslog_format *fmt,
+                                 int pri, int rfc, char *buf, size_t size )
+{
+    int i, n;
+    size_t pos, len;
+    const char *stamp, *value;
+    char name[16];
+
+    /* header */
+    stamp = ntf_syslog_timestamp( rfc, &len );
+    if ( rfc == NTF_SYSLOG_RFC5424 && syslog_sd_id[0] != '\0' )
+        n = snprintf( buf, size, "<%d>1 %.*s %s %s %s %d [%s msgId=\"%d\" module=\"%d\"",
+                      pri, (int)len, stamp, syslog_hostname, NTF_SYSLOG_APP_NAME,
+                      syslog_procid, notif->msg_id, syslog_sd_id, notif->msg_id, notif->module_id );
+    else if ( rfc == NTF_SYSLOG_RFC5424 )
+        n = snprintf( buf, size, "<%d>1 %.*s %s %s %s %d - ",
+                      pri, (int)len, stamp, syslog_hostname, NTF_SYSLOG_APP_NAME,
+                      syslog_procid, notif->msg_id );
+    else
+    {
+        /* header of every line is made without snprintf, PRI is at most 191 */
+        n = 0;
+        name[n++] = '<';
+        if ( pri >= 100 )
+            name[n++] = '0' + pri / 100;
+        if ( pri >= 10 )
+            name[n++] = '0' + pri / 10 % 10;
+        name[n++] = '0' + pri % 10;
+        name[n++] = '>';
+        pos = ntf_syslog_put( buf, size, 0, name, n );
+        pos = ntf_syslog_put( buf, size, pos, stamp, len );
+        n   = ntf_syslog_put( buf, size, pos, " ", 1 );
+    }
+    if ( n < 0 || (size_t)n >= size )
+        return 0;
+    pos = n;
+
+    /* STRUCTURED-DATA carries every parameter */
+    if ( rfc == NTF_SYSLOG_RFC5424 && syslog_sd_id[0] != '\0' )
+    {
+        for ( i = 0; i < notif->param_num; ++i )
+        {
+            n = snprintf( name, sizeof( name ), " p%d=\"", i + 1 );
+            pos = ntf_syslog_put( buf, size, pos, name, n );
+            pos = ntf_syslog_put_sd( buf, size, pos, ntf_syslog_param( notif, i ) );
+            pos = ntf_syslog_put( buf, size, pos, "\"", 1 );
+        }
+        pos = ntf_syslog_put( buf, size, pos, "] ", 2 );
+    }
+
+    /* MSG */
+    for ( i = 0; i < fmt->segments_num; ++i )
+    {
+        if ( fmt->segments[i].param < 0 )
+            pos = ntf_syslog_put( buf, size, pos, fmt->segments[i].text, fmt->segments[i].len );
+        else
+        {
+            value = ntf_syslog_param( notif, fmt->segments[i].param );
+            pos = ntf_syslog_put( buf, size, pos, value, strlen( value ) );
+        }
+    }
+
+    return pos;
+}
+
+/*
+ * Send datagrams, a datagram failed to be sent is skipped
+ */
+static void ntf_syslog_sendmmsg( struct mmsghdr *msgs, int count )
+{
+    int sent;
+
+    while ( count > 0 )
+    {
+        sent = sendmmsg( sockfd, msgs, count, 0 );
+        if ( sent < 0 )
+        {
+            if ( errno == EINTR )
+                continue;
+            ERR("sendmmsg() failed: %s (%d)", strerror(errno), errno);
+            ntf_metrics_count( NTF_SCOPE_SYSLOG, NTF_METRIC_SEND_FAILED, 1 );
+            sent = 1;
+        }
+        msgs  += sent;
+        count -= sent;
+    }
+}
+
+/*
+ *
+ */
+int ntf_syslog_init( void *args )
+{
+    char buf[16] = { 0 };
+    char address[128] = { 0 };
+    int i;
+
+    /* compile message formats */
+    for ( i = 0; i < NTF_MAX_DB_MESSAGE_NUM; ++i )
+    {
+        if ( ntf_syslog_db[i].msg_id == NTF_MSG_NOTUSED )
+            break;
+
+        if ( ntf_syslog_compile( &ntf_syslog_db[i], &ntf_syslog_formats[i] ) != 0 )
+            ERR( "Cannot compile syslog message of notification %d", ntf_syslog_db[i].msg_id );
+    }
+
+    if ( ntfsettings_get( "syslog_format", buf, sizeof(buf) - 1 ) == 0 && strcmp( buf, "rfc5424" ) == 0 )
+        syslog_rfc = NTF_SYSLOG_RFC5424;
+    if ( ntfsettings_get( "syslog_sd_id", address, sizeof(address) - 1 ) == 0 && address[0] != '\0' )
+    {
+        if ( ntf_syslog_sd_id_valid( address ) )
+            strcpy( syslog_sd_id, address );
+        else
+            ERR( "Bad syslog_sd_id '%s', it must be <name>@<enterprise number>", address );
+        address[0] = '\0';
+    }
+    if ( gethostname( syslog_hostname, sizeof(syslog_hostname) ) != 0 || syslog_hostname[0] == '\0' )
+        strcpy( syslog_hostname, "-" );
+    syslog_hostname[sizeof(syslog_hostname) - 1] = '\0';
+    snprintf( syslog_procid, sizeof(syslog_procid), "%d", (int)getpid() );
+
+    /* open stream if configured */
+    if ( ntfsettings_get( "syslog_stream", address, sizeof(address) - 1 ) == 0 && address[0] != '\0' )
+    {
+        if ( ntf_stream_init( &syslog_stream, "syslog", address,
+                              NTF_STREAM_FRAMING_OCTET, NTF_STREAM_BUFFER_LEN ) != 0 )
+        {
+            ntf_stream_close( &syslog_stream );
+            return 1;
+        }
+        syslog_use_stream = 1;
+        return 0;
+    }
+
+    if ( open_socket() != 0 )
+        return 1;
+
+    for ( i = 0; i < NTF_SYSLOG_DEST_MAX; ++i )
+        ntfsettings_subscribe( (char *)syslog_dest_keys[i], &syslog_dests_notify, NULL );
+    ntf_syslog_dests_load( &syslog_dests );
+
+    return 0;
+}
+
+/*
+ *
+ */
+int ntf_call_syslog( struct ing_notification *notif )
+{
+    ntf_call_syslog_batch( notif, 1 );
+    return 0;
+}
+
+/*
+ * Send all lines of the batch with one system call: lines are queued
+ * to the stream and written at once, or sent as UDP datagrams to all
+ * servers with sendmmsg. Line of notification is formatted once for
+ * every format and facility in use
+ */
+int ntf_call_syslog_batch( struct ing_notification *notifs, int n )
+{
+    static __thread char lines[NTF_SYSLOG_BATCH_BUF];
+    struct mmsghdr msgs[NTF_SYSLOG_MSGS_MAX];
+    struct iovec iov[NTF_SYSLOG_MSGS_MAX];
+    struct iovec line[NTF_SYSLOG_DEST_MAX];
+    struct ntf_syslog_format *fmt;
+    struct ntf_syslog_dest *dest;
+    int i, d, v, count, severity;
+    size_t pos, len;
+
+    if ( syslog_use_stream )
+    {
+        for ( i = 0; i < n; ++i )
+        {
+            fmt = ntf_syslog_lookup( &notifs[i], &severity );
+            if ( fmt == NULL )
+                continue;
+
+            len = ntf_syslog_format( &notifs[i], fmt, LOG_USER | severity, syslog_rfc,
+                                     lines, NTF_SYSLOG_LINE_LEN );
+            if ( len > 0 && ntf_stream_send( &syslog_stream, lines, len ) != 0 )
             {
-            case 1:
-                send_syslog( severity, ntf_syslog_db[i].msg_text,
-                        notif->params[ ntf_syslog_db[i].params[0].input_idx - 1 ] );
-                break;
-            case 2:
-                send_syslog( severity, ntf_syslog_db[i].msg_text,
-                        notif->params[ ntf_syslog_db[i].params[0].input_idx - 1 ],
-                        notif->params[ ntf_syslog_db[i].params[1].input_idx - 1 ] );
-                break;
-            case 3:
-                send_syslog( severity, ntf_syslog_db[i].msg_text,
-                        notif->params[ ntf_syslog_db[i].params[0].input_idx - 1 ],
-                        notif->params[ ntf_syslog_db[i].params[1].input_idx - 1 ],
-                        notif->params[ ntf_syslog_db[i].params[2].input_idx - 1 ] );
-                break;
-            case 5:
-                send_syslog( severity, ntf_syslog_db[i].msg_text,
-                        notif->params[ ntf_syslog_db[i].params[0].input_idx - 1 ],
-                        notif->params[ ntf_syslog_db[i].params[1].input_idx - 1 ],
-                        notif->params[ ntf_syslog_db[i].params[2].input_idx - 1 ],
-                        notif->params[ ntf_syslog_db[i].params[3].input_idx - 1 ],
-                        notif->params[ ntf_syslog_db[i].params[4].input_idx - 1 ] );
-                break;
+                ERR( "syslog stream buffer is full, notification (%d) is dropped", notifs[i].msg_id );
+                ntf_metrics_count( NTF_SCOPE_SYSLOG, NTF_METRIC_DROPPED, 1 );
             }
-            break;
         }
+        ntf_stream_flush( &syslog_stream, NTF_STREAM_WAIT_MS );
+        return 0;
     }
 
+    if ( sockfd == -1 )
+        return -1;
+
+    update_dests();
+    pthread_rwlock_rdlock( &syslog_dests_lock );
+
+    memset( msgs, 0, sizeof( msgs ) );
+    count = 0;
+    pos = 0;
+    for ( i = 0; i < n; ++i )
+    {
+        fmt = ntf_syslog_lookup( &notifs[i], &severity );
+        if ( fmt == NULL )
+            continue;
+
+        /* room for lines of all variants */
+        if ( pos + syslog_dests.variants_num * NTF_SYSLOG_LINE_LEN > sizeof( lines ) ||
+             count + syslog_dests.dests_num > NTF_SYSLOG_MSGS_MAX )
+        {
+            ntf_syslog_sendmmsg( msgs, count );
+            memset( msgs, 0, count * sizeof( struct mmsghdr ) );
+            count = 0;
+            pos = 0;
+        }
+
+        for ( v = 0; v < syslog_dests.variants_num; ++v )
+            line[v].iov_len = 0;
+
+        for ( d = 0; d < syslog_dests.dests_num; ++d )
+        {
+            dest = &syslog_dests.dests[d];
+            if ( severity > dest->severity )
+                continue;
+
+            v = dest->variant;
+            if ( line[v].iov_len == 0 )
+            {
+                len = ntf_syslog_format( &notifs[i], fmt, dest->facility | severity, dest->rfc,
+                                         lines + pos, NTF_SYSLOG_LINE_LEN );
+                if ( len == 0 )
+                    continue;
+                line[v].iov_base = lines + pos;
+                line[v].iov_len  = len;
+                pos += len;
+            }
+
+            iov[count] = line[v];
+            msgs[count].msg_hdr.msg_name    = &dest->addr;
+            msgs[count].msg_hdr.msg_namelen = dest->addrlen;
+            msgs[count].msg_hdr.msg_iov     = &iov[count];
+            msgs[count].msg_hdr.msg_iovlen  = 1;
+            ++count;
+        }
+    }
+
+    ntf_syslog_sendmmsg( msgs, count );
+
+    pthread_rwlock_unlock( &syslog_dests_lock );
+
     return 0;
 }
 
@@ -307,6 +894,20 @@ int ntf_call_syslog( struct ing_notification *notif )
  */
 int ntf_syslog_clean()
 {
+    int i;
+
+    for ( i = 0; i < NTF_SYSLOG_DEST_MAX; ++i )
+        ntfsettings_unsubscribe( (char *)syslog_dest_keys[i], &syslog_dests_notify, NULL );
+
+    if ( syslog_use_stream )
+    {
+        /* give the server a chance to read the rest */
+        ntf_stream_flush( &syslog_stream, NTF_STREAM_WAIT_MS );
+        ntf_stream_report( &syslog_stream );
+        ntf_stream_close( &syslog_stream );
+        syslog_use_stream = 0;
+    }
+
     if (sockfd != -1)
     {
         close(sockfd);
@@ -90,6 +90,9 @@
 #include "ing_ntfr_defines.h"
 #include "ing_ntfr_messages.h"
 #include "ing_ntfr_listeners.h"
+#include "ing_ntfr_settings.h"
+#include "ing_ntfr_threads.h"
+#include "ing_ntfr_metrics.h"
 
 /*
  * Constants
@@ -566,55 +569,248 @@ int ntf_datetime_libc2yang( char *pvalue_in, char *pvalue_out, void *arg )
 }
 
 /*
+ * Receive all notifications pending on listener socket into priority queue.
+ * If queue is empty and 'wait' is set, wait for the first notification.
  */
-void* ntf_handler( void *args )
+static void ntf_handler_receive( int ntf_handle, struct ntf_listener *thread_data, int wait )
 {
-    int ntf_handle;
-    size_t len;
-    struct ing_notification notification;
-    char param_pool[512] = { 0 };
+    struct ntf_queue_entry *entry;
     ntf_stat_t rescode;
-    struct ntf_listener *thread_data;
+    size_t len;
+    int flags;
+
+    flags = ( wait && thread_data->queue->count == 0 ) ? NTF_MSG_WAIT : NTF_MSG_DONOTWAIT;
+
+    while ( ( entry = ntf_queue_reserve( thread_data->queue ) ) != NULL )
+    {
+        memset( entry->param_pool, 0, sizeof( entry->param_pool ) );
+        len = sizeof( entry->param_pool );
+
+        rescode = ing_notification_recv( ntf_handle, thread_data->name,
+                                         &entry->notif, flags, entry->param_pool, &len );
+        if ( rescode != NTF_ST_OK )
+        {
+            /* received but cannot be decoded */
+            if ( rescode != NTF_ST_TIMEOUT && rescode != NTF_ST_FAIL_NETWORK_OPERATION )
+                ntf_metrics_count( thread_data->metrics_scope, NTF_METRIC_DROPPED, 1 );
+            ntf_queue_release( thread_data->queue, entry );
+            break;
+        }
+
+        entry->received_ns = ntf_metrics_now();
+        ntf_metrics_count( thread_data->metrics_scope, NTF_METRIC_DECODED, 1 );
+        ntf_queue_push( thread_data->queue, entry );
+        flags = NTF_MSG_DONOTWAIT;
+    }
+}
+
+/*
+ * Notifications passed to listener at once
+ */
+struct ntf_handler_batch
+{
+    struct ing_notification notifs[NTF_LISTENER_BATCH_MAX];
+    char pools[NTF_LISTENER_BATCH_MAX][NTF_STR_MSG_BUFFER_LEN];
+};
+
+/*
+ * Pass notifications to listener: to its 'batch' function if it has one,
+ * otherwise one by one to its 'func'
+ */
+static void ntf_handler_call( struct ntf_listener *thread_data,
+                              struct ing_notification *notifs, int n )
+{
+    int64_t start, now;
+    int i;
+
+    if ( thread_data->batch != NULL )
+    {
+        /* every notification of batch waited for the whole call */
+        start = ntf_metrics_now();
+        thread_data->batch( notifs, n );
+        now = ntf_metrics_now();
+        for ( i = 0; i < n; ++i )
+            ntf_metrics_latency( thread_data->metrics_scope, NTF_LATENCY_OUTPUT, now - start );
+        return;
+    }
+
+    for ( i = 0; i < n; ++i )
+    {
+        start = ntf_metrics_now();
+        thread_data->func( &notifs[i] );
+        ntf_metrics_latency( thread_data->metrics_scope, NTF_LATENCY_OUTPUT,
+                             ntf_metrics_now() - start );
+    }
+}
+
+/*
+ * Dispatch everything pending in the queue in order of priority
+ */
+static void ntf_handler_dispatch( struct ntf_listener *thread_data,
+                                  struct ntf_handler_batch *batch )
+{
+    struct ntf_queue_entry *entry;
+    int n;
+
+    if ( thread_data->workers != NULL )
+    {
+        /* one notification per wake-up, workers are fed in priority order */
+        entry = ntf_queue_pop( thread_data->queue );
+        if ( entry != NULL )
+        {
+            ntf_metrics_latency( thread_data->metrics_scope, NTF_LATENCY_DISPATCH,
+                                 ntf_metrics_now() - entry->received_ns );
+            ntf_workers_submit( thread_data->workers, &entry->notif );
+            ntf_queue_release( thread_data->queue, entry );
+        }
+        return;
+    }
 
-    thread_data = (struct ntf_listener*)args;
+    n = 0;
+    while ( n < NTF_LISTENER_BATCH_MAX &&
+            ( entry = ntf_queue_pop( thread_data->queue ) ) != NULL )
+    {
+        ntf_metrics_latency( thread_data->metrics_scope, NTF_LATENCY_DISPATCH,
+                             ntf_metrics_now() - entry->received_ns );
+        ntf_notification_copy( &batch->notifs[n], batch->pools[n],
+                               sizeof( batch->pools[n] ), &entry->notif );
+        ntf_queue_release( thread_data->queue, entry );
+        ++n;
+    }
+
+    if ( n > 0 )
+        ntf_handler_call( thread_data, batch->notifs, n );
+}
 
-    if ( thread_data->func == NULL )
+/*
+ * Run listener until core asks to stop it
+ */
+static void ntf_handler_run( struct ntf_listener *thread_data )
+{
+    int ntf_handle;
+    char buffer[16] = { 0 };
+    char key[NTF_LISTENER_NAME_LEN + sizeof( "_listener_workers" )];
+    struct ntf_handler_batch *batch;
+    struct timespec curr_time, report_time;
+    int sched;
+    long workers;
+
+    if ( thread_data->func == NULL && thread_data->batch == NULL )
     {
         ERR( "Listener thread function not found, close thread %s", thread_data->name);
-        return NULL;
+        return;
     }
 
     if ( thread_data->init != NULL )
         if ( thread_data->init( NULL ) != 0 )
         {
             ERR( "Listener data init failed, close thread %s", thread_data->name);
-            return NULL;
+            return;
         }
 
-    ntf_handle = ing_listener_init( thread_data->port, 5 );
+    ntf_handle = ing_listener_init( thread_data->port, NTF_LISTENER_RECV_TIMEOUT );
     if ( ntf_handle <= 0 )
     {
         ERR( "Init of listener %s failed", thread_data->name);
-        return NULL;
+        if ( thread_data->clean != NULL )
+            thread_data->clean();
+        return;
     }
-    len = sizeof( param_pool );
 
-    for( ;; )
+    sched = NTF_QUEUE_SCHED_STRICT;
+    if ( ntfsettings_get( "listener_queue_sched", buffer, sizeof( buffer ) ) == 0 &&
+         strcmp( buffer, "weighted" ) == 0 )
+        sched = NTF_QUEUE_SCHED_WEIGHTED;
+
+    thread_data->queue = malloc( sizeof( struct ntf_queue ) );
+    batch = malloc( sizeof( struct ntf_handler_batch ) );
+    if ( thread_data->queue == NULL || batch == NULL )
     {
-        rescode = ing_notification_recv( ntf_handle, thread_data->name, 
-                                         &notification, NTF_MSG_WAIT, param_pool, &len );
-        if ( rescode == NTF_ST_OK )
-        {
-            thread_data->func( &notification );
+        ERR( "Cannot allocate queue of listener %s", thread_data->name);
+        free( thread_data->queue );
+        thread_data->queue = NULL;
+        free( batch );
+        ing_listener_free( ntf_handle );
+        if ( thread_data->clean != NULL )
+            thread_data->clean();
+        return;
+    }
+    ntf_queue_init( thread_data->queue, sched );
+
+    /* optional pool of worker threads: '<name>_listener_workers' */
+    snprintf( key, sizeof( key ), "%s_listener_workers", thread_data->name );
+    if ( ntfsettings_get_int( key, &workers ) == 0 && workers > 1 )
+    {
+        if ( thread_data->threadsafe && thread_data->func != NULL )
+            thread_data->workers = ntf_workers_start( thread_data->name,
+                                                      thread_data->func, (int)workers );
+        else
+            ERR( "%s listener cannot be run by several threads, '%s' is ignored",
+                  thread_data->name, key );
+    }
+
+    /* core starts forwarding notifications */
+    __atomic_store_n( &thread_data->ready, 1, __ATOMIC_RELEASE );
+
+    clock_gettime( CLOCK_MONOTONIC, &report_time );
 
-            memset( param_pool, 0, sizeof( param_pool ) );
-            len = sizeof( param_pool );
+    while ( !__atomic_load_n( &thread_data->stop, __ATOMIC_ACQUIRE ) )
+    {
+        /* drain the socket, then dispatch everything drained in order of
+         * priority; the socket is drained again before every dispatch, so
+         * notification of high severity never waits behind a burst of low
+         * severity ones */
+        ntf_handler_receive( ntf_handle, thread_data, 1 );
+        ntf_handler_dispatch( thread_data, batch );
+
+        clock_gettime( CLOCK_MONOTONIC, &curr_time );
+        if ( curr_time.tv_sec - report_time.tv_sec > NTF_CONF_FILE_MONITOR_TIMEOUT )
+        {
+            ntf_queue_report( thread_data->queue, thread_data->name );
+            report_time = curr_time;
         }
     }
 
+    /* graceful drain: core stopped forwarding before asking to stop, so
+     * everything sent to the listener is already in its socket */
+    for ( ;; )
+    {
+        ntf_handler_receive( ntf_handle, thread_data, 0 );
+        if ( thread_data->queue->count == 0 )
+            break;
+        ntf_handler_dispatch( thread_data, batch );
+    }
+    ntf_queue_report( thread_data->queue, thread_data->name );
+
+    if ( thread_data->workers != NULL )
+    {
+        ntf_workers_stop( thread_data->workers );
+        thread_data->workers = NULL;
+    }
+
     if ( thread_data->clean != NULL )
         if ( thread_data->clean() != 0 )
             ERR( "Failed to clean %s thread data", thread_data->name);
 
+    free( batch );
+    free( thread_data->queue );
+    thread_data->queue = NULL;
+    ing_listener_free( ntf_handle );
+}
+
+/*
+ */
+void* ntf_handler( void *args )
+{
+    struct ntf_listener *thread_data = (struct ntf_listener*)args;
+    char name[32];
+
+    snprintf( name, sizeof( name ), "ntf-%s", thread_data->name );
+    ntf_thread_setup( thread_data->name, name );
+
+    ntf_handler_run( thread_data );
+
+    INF( "Listener %s thread exits", thread_data->name );
+    __atomic_store_n( &thread_data->exited, 1, __ATOMIC_RELEASE );
     return NULL;
 }
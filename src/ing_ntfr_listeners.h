@@ -74,12 +74,16 @@
  */
 #ifndef ING_NTFR_LISTENERS_H
 #define ING_NTFR_LISTENERS_H
+#include <sys/types.h>
 #include <pthread.h>
+#include "ing_ntfr_queue.h"
+#include "ing_ntfr_workers.h"
 /* Constants
  */
 #define NTF_MAX_IFNAME_LEN 32 /* length of ifname                */
 #define NTF_MAX_IFIDX_NUM 128           /* number of entry in ifIndex array */
 #define NTF_MAX_DB_MESSAGE_NUM 64           /* number of entries in db message per listener */
+#define NTF_LISTENER_BATCH_MAX NTF_QUEUE_LEN /* notifications passed to 'batch' function at once */
 /*
  * Conversion function type
  */
@@ -90,20 +94,50 @@ typedef int ( *ntf_param_convert_func )( char *pvalue_in, char *pvalue_out, void
  */
 typedef int ( *ntf_listener_init )( void *args );
 typedef int ( *ntf_listener_func )( struct ing_notification *notif );
+typedef int ( *ntf_listener_batch_func )( struct ing_notification *notifs, int n );
 typedef int ( *ntf_validate_func )( struct ing_notification *notif );
 typedef int ( *ntf_listener_clean )();
 
+/*
+ * State of listener thread, changed by core thread only
+ */
+enum ntf_listener_state
+{
+    NTF_LISTENER_STOPPED = 0,
+    NTF_LISTENER_STARTING,      /* thread is initializing, nothing is forwarded yet */
+    NTF_LISTENER_RUNNING,       /* notifications are forwarded to listener         */
+    NTF_LISTENER_DISABLING,     /* forwarding stopped, receive shards may still be
+                                 * sending notification they got before           */
+    NTF_LISTENER_STOPPING       /* forwarding stopped, thread drains its socket    */
+};
+
+#define NTF_LISTENER_RECV_TIMEOUT 1 /* seconds, how often handler checks 'stop' */
+#define NTF_LISTENER_NAME_LEN     16
+
 /*
  */
 struct ntf_listener
 {
     pthread_t          thread_id;
-    char               name[16];
+    char               name[NTF_LISTENER_NAME_LEN];
     unsigned short     port;
     ntf_listener_init  init;
     ntf_listener_func  func;
+    ntf_listener_batch_func batch; /* optional, used instead of 'func' by handler */
     ntf_listener_clean clean;
-    int enabled;
+    int enabled;                /* notifications are forwarded to listener, written
+                                 * atomically, read by receive shards              */
+    int wanted;                 /* listener is enabled in configuration             */
+    int state;                  /* NTF_LISTENER_STOPPED ...                         */
+    int stop;                   /* set by core: drain socket and exit               */
+    int ready;                  /* set by handler when its socket is bound          */
+    int exited;                 /* set by handler when thread is about to exit      */
+    int threadsafe;             /* 'func' can be run by several worker threads      */
+    struct ntf_queue   *queue;  /* pending notifications, owned by handler thread   */
+    struct ntf_workers *workers;/* worker pool, NULL if 'func' is run by handler    */
+    int metrics_scope;          /* NTF_SCOPE_... of listener statistics            */
+    unsigned long disabled_generation; /* receive shards must pass it before
+                                        * handler is stopped                   */
 } ntf_listener_t;
 
 /*
@@ -159,6 +193,7 @@ typedef struct ntf_syslog_db_entry
 
 int ntf_syslog_init( void *args );
 int ntf_call_syslog( struct ing_notification *notif );
+int ntf_call_syslog_batch( struct ing_notification *notifs, int n );
 int ntf_syslog_clean();
 
 /* **********************************************************
@@ -199,6 +234,9 @@ typedef struct ntf_netconf_db_entry
 int ntf_netconf_init( void *args );
 int ntf_netconf_clean();
 int ntf_send_netconf_notif( struct ing_notification *notif );
+int ntf_send_netconf_batch( struct ing_notification *notifs, int n );
+/* message of notification as NETCONF listener makes it, used by benchmark */
+ssize_t ntf_netconf_prepare( struct ing_notification *notif, char *buf, size_t size );
 
 
 /* **********************************************************
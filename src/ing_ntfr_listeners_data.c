@@ -174,6 +174,10 @@ struct ntf_syslog_db_entry ntf_syslog_db[] = {
              { 3, NTF_TYPE_INT, "complete-time", NULL },
              { 4, NTF_TYPE_INT, "operation-state", NULL },
              { 5, NTF_TYPE_STR, "error-log", NULL } }
+    },
+    /* This element serves as a stop-element to prevent iterating beyond the end */
+    {
+        NTF_MSG_NOTUSED
     }
 };
 
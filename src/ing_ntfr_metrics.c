@@ -0,0 +1,651 @@
+/* ing_ntfr_metrics.c
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains counters and latency histograms of notifier core
+ * stages and the local socket exporting them
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "ing_ntfr_defines.h"
+#include "ing_ntfr_metrics.h"
+#include "ing_ntfr_threads.h"
+
+/*
+ * Histogram buckets (HDR-like): values below 16 ns have a bucket each,
+ * every next power of 2 is split to 16 buckets, so that latency is kept
+ * with precision of 1/16 up to 2^34 ns (17 s), longer ones are put to
+ * the last bucket
+ */
+#define NTF_HIST_SUB_BITS 4
+#define NTF_HIST_SUB      ( 1 << NTF_HIST_SUB_BITS )
+#define NTF_HIST_MAX_BITS 34
+#define NTF_HIST_BUCKETS  ( NTF_HIST_SUB + ( NTF_HIST_MAX_BITS - NTF_HIST_SUB_BITS ) * NTF_HIST_SUB )
+
+#define NTF_METRICS_POLL_MS  1000 /* how often stats thread checks 'stop' */
+#define NTF_METRICS_CMD_LEN  16
+#define NTF_METRICS_BACKLOG  4
+
+static const char *ntf_scope_names[NTF_SCOPE_LAST] =
+    { "core", "logger", "syslog", "snmp", "netconf", "mmx" };
+static const char *ntf_metric_names[NTF_METRIC_LAST] =
+    { "received", "forwarded", "decoded", "dropped", "convert_failed", "suppressed", "send_failed" };
+static const char *ntf_latency_names[NTF_LATENCY_LAST] =
+    { "dispatch_ns", "output_ns" };
+
+/*
+ * Latency histogram
+ */
+struct ntf_histogram
+{
+    uint64_t sum;
+    uint64_t buckets[NTF_HIST_BUCKETS];
+};
+
+/*
+ * Metrics of one thread: written by the thread only, without locks, and
+ * read by stats thread at any time. Block of exited thread is taken by
+ * the next new one, so that totals are kept when listener is restarted
+ */
+struct ntf_metrics_block
+{
+    struct ntf_metrics_block *next;
+    int owned;
+    uint64_t counters[NTF_SCOPE_LAST][NTF_METRIC_LAST];
+    struct ntf_histogram latency[NTF_SCOPE_LAST][NTF_LATENCY_LAST];
+};
+
+/*
+ * Sum of blocks of all threads
+ */
+struct ntf_metrics_snapshot
+{
+    int threads;
+    uint64_t counters[NTF_SCOPE_LAST][NTF_METRIC_LAST];
+    struct ntf_histogram latency[NTF_SCOPE_LAST][NTF_LATENCY_LAST];
+};
+
+/*
+ * Stats socket server
+ */
+struct ntf_metrics_server
+{
+    int sock;
+    int stop;
+    int64_t started;
+    pthread_t thread;
+    char path[sizeof( ((struct sockaddr_un*)0)->sun_path )];
+};
+
+/*
+ * Global variables
+ */
+static struct ntf_metrics_block *ntf_metrics_blocks = NULL; /* blocks are never freed */
+static __thread struct ntf_metrics_block *ntf_metrics_self = NULL;
+static pthread_key_t ntf_metrics_key;
+static pthread_once_t ntf_metrics_once = PTHREAD_ONCE_INIT;
+static struct ntf_metrics_server ntf_metrics_server = { .sock = -1 };
+
+/*
+ * Get scope by listener name
+ */
+int ntf_metrics_scope( const char *name )
+{
+    int i;
+
+    for ( i = 0; i < NTF_SCOPE_LAST; ++i )
+        if ( strcmp( ntf_scope_names[i], name ) == 0 )
+            return i;
+
+    return NTF_SCOPE_CORE;
+}
+
+/*
+ * Monotonic time, nanoseconds
+ */
+int64_t ntf_metrics_now()
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*
+ * Block is given back when its thread exits
+ */
+static void ntf_metrics_release( void *arg )
+{
+    struct ntf_metrics_block *block = arg;
+
+    __atomic_store_n( &block->owned, 0, __ATOMIC_RELEASE );
+}
+
+static void ntf_metrics_key_init()
+{
+    pthread_key_create( &ntf_metrics_key, &ntf_metrics_release );
+}
+
+/*
+ * Get block of calling thread, it is taken on the first use
+ */
+static struct ntf_metrics_block* ntf_metrics_block()
+{
+    struct ntf_metrics_block *block = ntf_metrics_self;
+    int owned;
+
+    if ( block != NULL )
+        return block;
+
+    pthread_once( &ntf_metrics_once, &ntf_metrics_key_init );
+
+    for ( block = __atomic_load_n( &ntf_metrics_blocks, __ATOMIC_ACQUIRE );
+          block != NULL; block = block->next )
+    {
+        owned = 0;
+        if ( __atomic_compare_exchange_n( &block->owned, &owned, 1, 0,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_RELAXED ) )
+            break;
+    }
+
+    if ( block == NULL )
+    {
+        block = calloc( 1, sizeof( struct ntf_metrics_block ) );
+        if ( block == NULL )
+            return NULL;
+        block->owned = 1;
+        block->next  = __atomic_load_n( &ntf_metrics_blocks, __ATOMIC_RELAXED );
+        while ( !__atomic_compare_exchange_n( &ntf_metrics_blocks, &block->next, block, 1,
+                                              __ATOMIC_RELEASE, __ATOMIC_RELAXED ) )
+            ;
+    }
+
+    pthread_setspecific( ntf_metrics_key, block );
+    ntf_metrics_self = block;
+    return block;
+}
+
+/*
+ * Increase value written by the only thread, reader sees old or new value
+ */
+static inline void ntf_metrics_add( uint64_t *value, uint64_t n )
+{
+    __atomic_store_n( value, __atomic_load_n( value, __ATOMIC_RELAXED ) + n, __ATOMIC_RELAXED );
+}
+
+/*
+ * Add 'n' to counter of calling thread
+ */
+void ntf_metrics_count( int scope, int metric, unsigned long n )
+{
+    struct ntf_metrics_block *block;
+
+    if ( scope < 0 || scope >= NTF_SCOPE_LAST || metric < 0 || metric >= NTF_METRIC_LAST )
+        return;
+
+    block = ntf_metrics_block();
+    if ( block != NULL )
+        ntf_metrics_add( &block->counters[scope][metric], n );
+}
+
+/*
+ * Get bucket of value
+ */
+static int ntf_metrics_bucket( uint64_t value )
+{
+    int e;
+
+    if ( value < NTF_HIST_SUB )
+        return (int)value;
+
+    e = 63 - __builtin_clzll( value );
+    if ( e >= NTF_HIST_MAX_BITS )
+        return NTF_HIST_BUCKETS - 1;
+
+    return NTF_HIST_SUB + ( e - NTF_HIST_SUB_BITS ) * NTF_HIST_SUB +
+           (int)( ( value >> ( e - NTF_HIST_SUB_BITS ) ) & ( NTF_HIST_SUB - 1 ) );
+}
+
+/*
+ * Get the highest value of bucket
+ */
+static uint64_t ntf_metrics_bucket_max( int idx )
+{
+    int e;
+
+    if ( idx < NTF_HIST_SUB )
+        return (uint64_t)idx;
+
+    e = ( idx - NTF_HIST_SUB ) / NTF_HIST_SUB + NTF_HIST_SUB_BITS;
+    return ( ( (uint64_t)( NTF_HIST_SUB + ( idx - NTF_HIST_SUB ) % NTF_HIST_SUB ) + 1 )
+             << ( e - NTF_HIST_SUB_BITS ) ) - 1;
+}
+
+/*
+ * Put latency to histogram of calling thread
+ */
+void ntf_metrics_latency( int scope, int latency, int64_t ns )
+{
+    struct ntf_metrics_block *block;
+    struct ntf_histogram *hist;
+
+    if ( scope < 0 || scope >= NTF_SCOPE_LAST || latency < 0 || latency >= NTF_LATENCY_LAST )
+        return;
+
+    block = ntf_metrics_block();
+    if ( block == NULL )
+        return;
+
+    if ( ns < 0 )
+        ns = 0;
+    hist = &block->latency[scope][latency];
+    ntf_metrics_add( &hist->buckets[ntf_metrics_bucket( (uint64_t)ns )], 1 );
+    ntf_metrics_add( &hist->sum, (uint64_t)ns );
+}
+
+/*
+ * Sum up blocks of all threads, data path is not stopped
+ */
+static void ntf_metrics_snapshot( struct ntf_metrics_snapshot *snap )
+{
+    struct ntf_metrics_block *block;
+    struct ntf_histogram *src, *dst;
+    int s, m, i;
+
+    memset( snap, 0, sizeof( struct ntf_metrics_snapshot ) );
+
+    for ( block = __atomic_load_n( &ntf_metrics_blocks, __ATOMIC_ACQUIRE );
+          block != NULL; block = block->next )
+    {
+        if ( __atomic_load_n( &block->owned, __ATOMIC_RELAXED ) )
+            snap->threads++;
+
+        for ( s = 0; s < NTF_SCOPE_LAST; ++s )
+        {
+            for ( m = 0; m < NTF_METRIC_LAST; ++m )
+                snap->counters[s][m] += __atomic_load_n( &block->counters[s][m], __ATOMIC_RELAXED );
+
+            for ( m = 0; m < NTF_LATENCY_LAST; ++m )
+            {
+                src = &block->latency[s][m];
+                dst = &snap->latency[s][m];
+                dst->sum += __atomic_load_n( &src->sum, __ATOMIC_RELAXED );
+                for ( i = 0; i < NTF_HIST_BUCKETS; ++i )
+                    dst->buckets[i] += __atomic_load_n( &src->buckets[i], __ATOMIC_RELAXED );
+            }
+        }
+    }
+}
+
+/*
+ * Number of values in histogram
+ */
+static uint64_t ntf_metrics_hist_count( struct ntf_histogram *hist )
+{
+    uint64_t count = 0;
+    int i;
+
+    for ( i = 0; i < NTF_HIST_BUCKETS; ++i )
+        count += hist->buckets[i];
+
+    return count;
+}
+
+/*
+ * Value below which 'permille' of values are (upper bound of its bucket)
+ */
+static uint64_t ntf_metrics_percentile( struct ntf_histogram *hist, uint64_t count, int permille )
+{
+    uint64_t rank, seen = 0;
+    int i;
+
+    if ( count == 0 )
+        return 0;
+
+    rank = ( count * permille + 999 ) / 1000;
+    for ( i = 0; i < NTF_HIST_BUCKETS; ++i )
+    {
+        seen += hist->buckets[i];
+        if ( seen >= rank && seen > 0 )
+            return ntf_metrics_bucket_max( i );
+    }
+
+    return ntf_metrics_bucket_max( NTF_HIST_BUCKETS - 1 );
+}
+
+/*
+ * Scope is printed if something has happened in it
+ */
+static int ntf_metrics_scope_used( struct ntf_metrics_snapshot *snap, int scope )
+{
+    int m;
+
+    for ( m = 0; m < NTF_METRIC_LAST; ++m )
+        if ( snap->counters[scope][m] != 0 )
+            return 1;
+    for ( m = 0; m < NTF_LATENCY_LAST; ++m )
+        if ( ntf_metrics_hist_count( &snap->latency[scope][m] ) != 0 )
+            return 1;
+
+    return 0;
+}
+
+/*
+ * Print snapshot as text: "<scope>.<metric> <value>" per line
+ */
+static void ntf_metrics_print_text( FILE *out, struct ntf_metrics_snapshot *snap, long uptime )
+{
+    struct ntf_histogram *hist;
+    uint64_t count;
+    int s, m;
+
+    fprintf( out, "uptime_s %ld\nthreads %d\n", uptime, snap->threads );
+
+    for ( s = 0; s < NTF_SCOPE_LAST; ++s )
+    {
+        if ( !ntf_metrics_scope_used( snap, s ) )
+            continue;
+
+        for ( m = 0; m < NTF_METRIC_LAST; ++m )
+            fprintf( out, "%s.%s %llu\n", ntf_scope_names[s], ntf_metric_names[m],
+                     (unsigned long long)snap->counters[s][m] );
+
+        for ( m = 0; m < NTF_LATENCY_LAST; ++m )
+        {
+            hist  = &snap->latency[s][m];
+            count = ntf_metrics_hist_count( hist );
+            if ( count == 0 )
+                continue;
+            fprintf( out, "%s.%s count %llu mean %llu p50 %llu p90 %llu p99 %llu p999 %llu max %llu\n",
+                     ntf_scope_names[s], ntf_latency_names[m], (unsigned long long)count,
+                     (unsigned long long)( hist->sum / count ),
+                     (unsigned long long)ntf_metrics_percentile( hist, count, 500 ),
+                     (unsigned long long)ntf_metrics_percentile( hist, count, 900 ),
+                     (unsigned long long)ntf_metrics_percentile( hist, count, 990 ),
+                     (unsigned long long)ntf_metrics_percentile( hist, count, 999 ),
+                     (unsigned long long)ntf_metrics_percentile( hist, count, 1000 ) );
+        }
+    }
+}
+
+/*
+ * Print snapshot as JSON, histograms have non-empty buckets as
+ * [highest value, count] pairs, so that they can be merged
+ */
+static void ntf_metrics_print_json( FILE *out, struct ntf_metrics_snapshot *snap, long uptime )
+{
+    struct ntf_histogram *hist;
+    uint64_t count;
+    int s, m, i, first_scope = 1, first;
+
+    fprintf( out, "{\"uptime_s\":%ld,\"threads\":%d,\"scopes\":{", uptime, snap->threads );
+
+    for ( s = 0; s < NTF_SCOPE_LAST; ++s )
+    {
+        if ( !ntf_metrics_scope_used( snap, s ) )
+            continue;
+
+        fprintf( out, "%s\"%s\":{", first_scope ? "" : ",", ntf_scope_names[s] );
+        first_scope = 0;
+
+        for ( m = 0; m < NTF_METRIC_LAST; ++m )
+            fprintf( out, "%s\"%s\":%llu", m ? "," : "", ntf_metric_names[m],
+                     (unsigned long long)snap->counters[s][m] );
+
+        for ( m = 0; m < NTF_LATENCY_LAST; ++m )
+        {
+            hist  = &snap->latency[s][m];
+            count = ntf_metrics_hist_count( hist );
+            fprintf( out, ",\"%s\":{\"count\":%llu,\"mean\":%llu,\"p50\":%llu,\"p90\":%llu,"
+                          "\"p99\":%llu,\"p999\":%llu,\"max\":%llu,\"buckets\":[",
+                     ntf_latency_names[m], (unsigned long long)count,
+                     (unsigned long long)( count ? hist->sum / count : 0 ),
+                     (unsigned long long)ntf_metrics_percentile( hist, count, 500 ),
+                     (unsigned long long)ntf_metrics_percentile( hist, count, 900 ),
+                     (unsigned long long)ntf_metrics_percentile( hist, count, 990 ),
+                     (unsigned long long)ntf_metrics_percentile( hist, count, 999 ),
+                     (unsigned long long)ntf_metrics_percentile( hist, count, 1000 ) );
+
+            first = 1;
+            for ( i = 0; i < NTF_HIST_BUCKETS; ++i )
+            {
+                if ( hist->buckets[i] == 0 )
+                    continue;
+                fprintf( out, "%s[%llu,%llu]", first ? "" : ",",
+                         (unsigned long long)ntf_metrics_bucket_max( i ),
+                         (unsigned long long)hist->buckets[i] );
+                first = 0;
+            }
+            fprintf( out, "]}" );
+        }
+        fprintf( out, "}" );
+    }
+
+    fprintf( out, "}}\n" );
+}
+
+/*
+ * Serve one client: read format line, write snapshot and close
+ */
+static void ntf_metrics_serve( int fd )
+{
+    struct ntf_metrics_snapshot *snap;
+    struct timeval tv = { 1, 0 };
+    char cmd[NTF_METRICS_CMD_LEN] = { 0 };
+    char *data = NULL;
+    size_t len = 0, off;
+    ssize_t res;
+    long uptime;
+    FILE *out;
+
+    setsockopt( fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof( tv ) );
+    setsockopt( fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof( tv ) );
+
+    /* no line in time means text */
+    if ( recv( fd, cmd, sizeof( cmd ) - 1, 0 ) < 0 )
+        cmd[0] = '\0';
+
+    snap = malloc( sizeof( struct ntf_metrics_snapshot ) );
+    out  = open_memstream( &data, &len );
+    if ( snap == NULL || out == NULL )
+    {
+        ERR( "Cannot allocate statistics snapshot" );
+        free( snap );
+        if ( out != NULL )
+            fclose( out );
+        free( data );
+        return;
+    }
+
+    ntf_metrics_snapshot( snap );
+    uptime = (long)( ( ntf_metrics_now() - ntf_metrics_server.started ) / 1000000000LL );
+    if ( strncmp( cmd, "json", 4 ) == 0 )
+        ntf_metrics_print_json( out, snap, uptime );
+    else
+        ntf_metrics_print_text( out, snap, uptime );
+    fclose( out );
+    free( snap );
+
+    for ( off = 0; off < len; off += (size_t)res )
+    {
+        res = send( fd, data + off, len - off, MSG_NOSIGNAL );
+        if ( res <= 0 )
+            break;
+    }
+    free( data );
+}
+
+/*
+ * Stats thread: clients are served one by one
+ */
+static void* ntf_metrics_thread( void __attribute__((__unused__)) *arg )
+{
+    struct pollfd pfd = { .fd = ntf_metrics_server.sock, .events = POLLIN };
+    int fd;
+
+    ntf_thread_setup( "stats", "ntf-stats" );
+
+    while ( !__atomic_load_n( &ntf_metrics_server.stop, __ATOMIC_ACQUIRE ) )
+    {
+        if ( poll( &pfd, 1, NTF_METRICS_POLL_MS ) <= 0 )
+            continue;
+
+        fd = accept4( ntf_metrics_server.sock, NULL, NULL, SOCK_CLOEXEC );
+        if ( fd < 0 )
+            continue;
+        ntf_metrics_serve( fd );
+        close( fd );
+    }
+
+    return NULL;
+}
+
+/*
+ * Start thread serving statistics on AF_UNIX stream socket
+ */
+int ntf_metrics_start( const char *path )
+{
+    struct ntf_metrics_server *srv = &ntf_metrics_server;
+    struct sockaddr_un addr;
+
+    if ( strlen( path ) >= sizeof( addr.sun_path ) )
+    {
+        ERR( "Path of stats socket %s is too long", path );
+        return -1;
+    }
+
+    memset( &addr, 0, sizeof( addr ) );
+    addr.sun_family = AF_UNIX;
+    strcpy( addr.sun_path, path );
+    strcpy( srv->path, path );
+
+    srv->sock = socket( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+    if ( srv->sock < 0 )
+    {
+        ERR( "Cannot create stats socket, err %d (%s)", errno, strerror(errno) );
+        return -1;
+    }
+
+    /* socket is left by previous run of core */
+    unlink( path );
+    if ( bind( srv->sock, (struct sockaddr*)&addr, sizeof( addr ) ) < 0 ||
+         chmod( path, 0660 ) < 0 ||
+         listen( srv->sock, NTF_METRICS_BACKLOG ) < 0 )
+    {
+        ERR( "Cannot listen on stats socket %s, err %d (%s)", path, errno, strerror(errno) );
+        close( srv->sock );
+        srv->sock = -1;
+        return -1;
+    }
+
+    srv->stop    = 0;
+    srv->started = ntf_metrics_now();
+    if ( pthread_create( &srv->thread, NULL, &ntf_metrics_thread, NULL ) != 0 )
+    {
+        ERR( "Cannot create stats thread" );
+        close( srv->sock );
+        unlink( path );
+        srv->sock = -1;
+        return -1;
+    }
+
+    LOG( "Statistics are served on %s", path );
+    return 0;
+}
+
+/*
+ * Stop thread serving statistics and remove its socket
+ */
+void ntf_metrics_stop()
+{
+    struct ntf_metrics_server *srv = &ntf_metrics_server;
+
+    if ( srv->sock < 0 )
+        return;
+
+    __atomic_store_n( &srv->stop, 1, __ATOMIC_RELEASE );
+    pthread_join( srv->thread, NULL );
+    close( srv->sock );
+    unlink( srv->path );
+    srv->sock = -1;
+}
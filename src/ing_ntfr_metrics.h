@@ -0,0 +1,148 @@
+/* ing_ntfr_metrics.h
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains counters and latency histograms of notifier core
+ * stages and the local socket exporting them
+ */
+
+#ifndef ING_NTFR_METRICS_H
+#define ING_NTFR_METRICS_H
+
+#include <stdint.h>
+
+/*
+ * Counters; every thread has its own copy written without locks, copies
+ * are summed up when statistics are read
+ */
+enum ntf_metric
+{
+    NTF_METRIC_RECEIVED = 0,    /* received by core                          */
+    NTF_METRIC_FORWARDED,       /* forwarded by core to listener             */
+    NTF_METRIC_DECODED,         /* received and decoded by listener          */
+    NTF_METRIC_DROPPED,         /* dropped: rate limit, full buffer or table */
+    NTF_METRIC_CONVERT_FAILED,  /* parameter value cannot be converted       */
+    NTF_METRIC_SUPPRESSED,      /* not sent as validate function decided     */
+    NTF_METRIC_SEND_FAILED,     /* failed to be sent by listener or core     */
+    NTF_METRIC_LAST
+};
+
+/*
+ * Latency histograms, nanoseconds
+ */
+enum ntf_metric_latency
+{
+    NTF_LATENCY_DISPATCH = 0,   /* receive by listener -> dispatch to output  */
+    NTF_LATENCY_OUTPUT,         /* dispatch -> output function has returned   */
+    NTF_LATENCY_LAST
+};
+
+/*
+ * Scope of metric: core or listener
+ */
+enum ntf_metric_scope
+{
+    NTF_SCOPE_CORE = 0,
+    NTF_SCOPE_LOGGER,
+    NTF_SCOPE_SYSLOG,
+    NTF_SCOPE_SNMP,
+    NTF_SCOPE_NETCONF,
+    NTF_SCOPE_MMX,
+    NTF_SCOPE_LAST
+};
+
+/*
+ * Get scope by listener name, NTF_SCOPE_CORE if name is unknown
+ */
+int ntf_metrics_scope( const char *name );
+/*
+ * Monotonic time, nanoseconds
+ */
+int64_t ntf_metrics_now();
+/*
+ * Add 'n' to counter of calling thread
+ */
+void ntf_metrics_count( int scope, int metric, unsigned long n );
+/*
+ * Put latency to histogram of calling thread
+ */
+void ntf_metrics_latency( int scope, int latency, int64_t ns );
+/*
+ * Start thread serving statistics on AF_UNIX stream socket 'path'.
+ * Client sends "json" or "text" line and gets snapshot in that format
+ * Returns: 0 on success, -1 on error
+ */
+int ntf_metrics_start( const char *path );
+/*
+ * Stop thread serving statistics and remove its socket
+ */
+void ntf_metrics_stop();
+
+#endif /* ING_NTFR_METRICS_H */
@@ -0,0 +1,136 @@
+/* ing_ntfr_plugin.h
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains ABI of notifier listener plugins
+ *
+ * Plugin is a shared object placed to the plugin directory of notifier
+ * ('plugin_dir' setting, NTF_PLUGIN_DIR by default). It must export
+ * descriptor of the plugin named NTF_PLUGIN_DESCRIPTOR:
+ *
+ *   const struct ntf_plugin ntf_plugin_descriptor = {
+ *       .abi_version = NTF_PLUGIN_ABI_VERSION,
+ *       .name        = "sample",
+ *       .caps        = NTF_PLUGIN_CAP_BATCH,
+ *       .init        = &sample_init,
+ *       .consume     = &sample_consume,
+ *       .clean       = &sample_clean
+ *   };
+ *
+ * Notifications are decoded once by notifier core and passed to plugins
+ * in-process, without listener socket.
+ */
+
+#ifndef ING_NTFR_PLUGIN_H
+#define ING_NTFR_PLUGIN_H
+
+#include "ing_ntfr.h"
+
+/*
+ * Version of plugin ABI, plugin built for other version is not loaded
+ */
+#define NTF_PLUGIN_ABI_VERSION 1
+
+/*
+ * Name of plugin descriptor symbol
+ */
+#define NTF_PLUGIN_DESCRIPTOR "ntf_plugin_descriptor"
+
+/*
+ * Plugin capabilities
+ *
+ *  NTF_PLUGIN_CAP_BATCH    - 'consume' accepts several notifications per call,
+ *                            otherwise it is called for every notification
+ *  NTF_PLUGIN_CAP_BLOCKING - 'consume' may block (e.g. on network I/O), so
+ *                            plugin is run by its own dispatch thread and
+ *                            does not delay other plugins
+ */
+#define NTF_PLUGIN_CAP_BATCH    0x0001
+#define NTF_PLUGIN_CAP_BLOCKING 0x0002
+
+/*
+ * Plugin descriptor
+ *
+ *  init    - called once after plugin is loaded, non-zero result unloads plugin
+ *  consume - called with 'n' notifications in order of receiving;
+ *            notifications are valid only during the call
+ *  clean   - called once before plugin is unloaded
+ */
+struct ntf_plugin
+{
+    unsigned int abi_version;
+    const char  *name;
+    unsigned int caps;
+    int ( *init )( void *args );
+    int ( *consume )( struct ing_notification *notifs, int n );
+    int ( *clean )( void );
+};
+
+#endif /* ING_NTFR_PLUGIN_H */
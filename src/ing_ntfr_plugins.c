@@ -0,0 +1,429 @@
+/* ing_ntfr_plugins.c
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains loader and in-process dispatch of listener plugins
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <dirent.h>
+#include <dlfcn.h>
+#include <pthread.h>
+
+#include "ing_ntfr_defines.h"
+#include "ing_ntfr_plugin.h"
+#include "ing_ntfr_plugins.h"
+#include "ing_ntfr_queue.h"
+#include "ing_ntfr_threads.h"
+
+/*
+ * Constants
+ */
+#define NTF_PLUGINS_MAX      16
+#define NTF_PLUGIN_INBOX_LEN 256
+
+/*
+ * Dispatch context: ring of decoded notifications and dispatch thread
+ * delivering them to its plugins. Plugins without NTF_PLUGIN_CAP_BLOCKING
+ * share one context, every blocking plugin has its own.
+ */
+struct ntf_plugin_inbox
+{
+    pthread_t       thread;
+    pthread_mutex_t guard;
+    pthread_cond_t  cond;
+    int             stop;
+    unsigned long   head;     /* written by core, under guard      */
+    unsigned long   tail;     /* written by dispatcher, under guard */
+    unsigned long   dropped;
+    unsigned long   reported;
+    int             plugins_num;
+    const struct ntf_plugin *plugins[NTF_PLUGINS_MAX];
+    struct ing_notification  notifs[NTF_PLUGIN_INBOX_LEN];
+    char pools[NTF_PLUGIN_INBOX_LEN][NTF_STR_MSG_BUFFER_LEN];
+};
+
+struct ntf_plugins
+{
+    int   handles_num;
+    void *handles[NTF_PLUGINS_MAX];
+    int   inboxes_num;
+    struct ntf_plugin_inbox *inboxes[NTF_PLUGINS_MAX];
+};
+
+static struct ntf_plugins plugins;
+
+/*
+ * Deliver notifications to all plugins of the context
+ */
+static void ntf_plugins_consume( struct ntf_plugin_inbox *inbox,
+                                 struct ing_notification *notifs, int n )
+{
+    const struct ntf_plugin *plugin;
+    int i, j;
+
+    for ( i = 0; i < inbox->plugins_num; ++i )
+    {
+        plugin = inbox->plugins[i];
+        if ( plugin->caps & NTF_PLUGIN_CAP_BATCH )
+            plugin->consume( notifs, n );
+        else
+            for ( j = 0; j < n; ++j )
+                plugin->consume( &notifs[j], 1 );
+    }
+}
+
+/*
+ * Dispatch thread
+ */
+static void* ntf_plugins_dispatcher( void *args )
+{
+    struct ntf_plugin_inbox *inbox = (struct ntf_plugin_inbox*)args;
+    unsigned long head, tail;
+    int first, n;
+
+    ntf_thread_setup( "plugins", "ntf-plugins" );
+
+    pthread_mutex_lock( &inbox->guard );
+    for ( ;; )
+    {
+        while ( inbox->head == inbox->tail && !inbox->stop )
+            pthread_cond_wait( &inbox->cond, &inbox->guard );
+
+        head = inbox->head;
+        tail = inbox->tail;
+        if ( head == tail )
+            break;
+        pthread_mutex_unlock( &inbox->guard );
+
+        /* everything received so far is delivered in one batch,
+         * or in two if it wraps around the end of the ring */
+        first = tail % NTF_PLUGIN_INBOX_LEN;
+        n = head - tail;
+        if ( first + n > NTF_PLUGIN_INBOX_LEN )
+            n = NTF_PLUGIN_INBOX_LEN - first;
+        ntf_plugins_consume( inbox, &inbox->notifs[first], n );
+
+        pthread_mutex_lock( &inbox->guard );
+        inbox->tail += n;
+    }
+    pthread_mutex_unlock( &inbox->guard );
+
+    return NULL;
+}
+
+/*
+ * Create dispatch context and start its thread
+ */
+static struct ntf_plugin_inbox* ntf_plugins_new_inbox()
+{
+    struct ntf_plugin_inbox *inbox;
+
+    if ( plugins.inboxes_num >= NTF_PLUGINS_MAX )
+        return NULL;
+
+    inbox = calloc( 1, sizeof( struct ntf_plugin_inbox ) );
+    if ( inbox == NULL )
+        return NULL;
+
+    pthread_mutex_init( &inbox->guard, NULL );
+    pthread_cond_init( &inbox->cond, NULL );
+
+    if ( pthread_create( &inbox->thread, NULL, &ntf_plugins_dispatcher, inbox ) != 0 )
+    {
+        ERR( "Cannot create plugin dispatch thread" );
+        pthread_cond_destroy( &inbox->cond );
+        pthread_mutex_destroy( &inbox->guard );
+        free( inbox );
+        return NULL;
+    }
+
+    plugins.inboxes[plugins.inboxes_num++] = inbox;
+    return inbox;
+}
+
+/*
+ * Load plugin from file and initialize it
+ */
+static const struct ntf_plugin* ntf_plugins_open( const char *path )
+{
+    const struct ntf_plugin *plugin;
+    void *handle;
+
+    if ( plugins.handles_num >= NTF_PLUGINS_MAX )
+    {
+        ERR( "too many plugins, %s is not loaded", path );
+        return NULL;
+    }
+
+    handle = dlopen( path, RTLD_NOW | RTLD_LOCAL );
+    if ( handle == NULL )
+    {
+        ERR( "Cannot load plugin %s: %s", path, dlerror() );
+        return NULL;
+    }
+
+    plugin = (const struct ntf_plugin*)dlsym( handle, NTF_PLUGIN_DESCRIPTOR );
+    if ( plugin == NULL )
+    {
+        ERR( "Plugin %s has no descriptor '%s'", path, NTF_PLUGIN_DESCRIPTOR );
+        goto reterr;
+    }
+
+    if ( plugin->abi_version != NTF_PLUGIN_ABI_VERSION )
+    {
+        ERR( "Plugin %s is built for ABI version %u (expected %u)",
+              path, plugin->abi_version, NTF_PLUGIN_ABI_VERSION );
+        goto reterr;
+    }
+
+    if ( plugin->name == NULL || plugin->consume == NULL )
+    {
+        ERR( "Plugin %s descriptor is not complete", path );
+        goto reterr;
+    }
+
+    if ( plugin->init != NULL && plugin->init( NULL ) != 0 )
+    {
+        ERR( "Plugin %s init failed", plugin->name );
+        goto reterr;
+    }
+
+    plugins.handles[plugins.handles_num++] = handle;
+    return plugin;
+
+reterr:
+    dlclose( handle );
+    return NULL;
+}
+
+/*
+ * Load all plugins found in directory 'dir' and start their dispatch threads
+ */
+int ntf_plugins_load( const char *dir )
+{
+    const struct ntf_plugin *plugin;
+    struct ntf_plugin_inbox *shared, *inbox;
+    struct dirent *ent;
+    char path[PATH_MAX];
+    size_t len;
+    DIR *pdir;
+    int loaded;
+
+    pdir = opendir( dir );
+    if ( pdir == NULL )
+        return 0;
+
+    loaded = 0;
+    shared = NULL;
+    while ( ( ent = readdir( pdir ) ) != NULL )
+    {
+        len = strlen( ent->d_name );
+        if ( len < 4 || strcmp( ent->d_name + len - 3, ".so" ) != 0 )
+            continue;
+
+        if ( snprintf( path, sizeof( path ), "%s/%s", dir, ent->d_name ) >= (int)sizeof( path ) )
+        {
+            ERR( "Plugin path %s/%s is too long, it is skipped", dir, ent->d_name );
+            continue;
+        }
+        plugin = ntf_plugins_open( path );
+        if ( plugin == NULL )
+            continue;
+
+        if ( plugin->caps & NTF_PLUGIN_CAP_BLOCKING )
+            inbox = ntf_plugins_new_inbox();
+        else
+            inbox = ( shared != NULL ) ? shared : ( shared = ntf_plugins_new_inbox() );
+
+        if ( inbox == NULL )
+        {
+            ERR( "No dispatch thread for plugin %s", plugin->name );
+            if ( plugin->clean != NULL )
+                plugin->clean();
+            dlclose( plugins.handles[--plugins.handles_num] );
+            continue;
+        }
+
+        /* dispatch thread reads the list only after the first notification */
+        inbox->plugins[inbox->plugins_num++] = plugin;
+        INF( "Plugin %s loaded (caps 0x%x)", plugin->name, plugin->caps );
+        ++loaded;
+    }
+
+    closedir( pdir );
+    return loaded;
+}
+
+/*
+ * Pass serialized notification to all loaded plugins
+ */
+void ntf_plugins_dispatch( char *buffer, size_t len )
+{
+    struct ing_notification notif;
+    struct ntf_plugin_inbox *inbox;
+    char param_pool[NTF_STR_MSG_BUFFER_LEN];
+    size_t pool_len;
+    unsigned long slot;
+    int i;
+
+    if ( plugins.inboxes_num == 0 )
+        return;
+
+    memset( &notif, 0, sizeof( notif ) );
+    pool_len = sizeof( param_pool );
+    if ( ing_notification_decode( buffer, len, &notif, param_pool, &pool_len ) != NTF_ST_OK )
+        return;
+
+    for ( i = 0; i < plugins.inboxes_num; ++i )
+    {
+        inbox = plugins.inboxes[i];
+
+        /* core never waits for plugin: if the ring is full, drop */
+        pthread_mutex_lock( &inbox->guard );
+        slot = inbox->head;
+        if ( slot - inbox->tail >= NTF_PLUGIN_INBOX_LEN )
+        {
+            ++inbox->dropped;
+            pthread_mutex_unlock( &inbox->guard );
+            continue;
+        }
+
+        /* slot is filled under guard, receive shards of core share the ring;
+         * it is not visible to dispatcher until head is moved */
+        slot %= NTF_PLUGIN_INBOX_LEN;
+        ntf_notification_copy( &inbox->notifs[slot], inbox->pools[slot],
+                               NTF_STR_MSG_BUFFER_LEN, &notif );
+        ++inbox->head;
+        pthread_cond_signal( &inbox->cond );
+        pthread_mutex_unlock( &inbox->guard );
+    }
+}
+
+/*
+ * Log number of notifications dropped since previous report
+ */
+void ntf_plugins_report()
+{
+    struct ntf_plugin_inbox *inbox;
+    unsigned long dropped;
+    int i;
+
+    for ( i = 0; i < plugins.inboxes_num; ++i )
+    {
+        inbox = plugins.inboxes[i];
+
+        pthread_mutex_lock( &inbox->guard );
+        dropped = inbox->dropped - inbox->reported;
+        inbox->reported = inbox->dropped;
+        pthread_mutex_unlock( &inbox->guard );
+
+        if ( dropped > 0 )
+            INF( "plugin %s%s: %lu notification(s) dropped",
+                  inbox->plugins[0]->name, inbox->plugins_num > 1 ? " and others" : "",
+                  dropped );
+    }
+}
+
+/*
+ * Deliver pending notifications, stop dispatch threads and unload plugins
+ */
+void ntf_plugins_unload()
+{
+    struct ntf_plugin_inbox *inbox;
+    int i, j;
+
+    for ( i = 0; i < plugins.inboxes_num; ++i )
+    {
+        inbox = plugins.inboxes[i];
+
+        pthread_mutex_lock( &inbox->guard );
+        inbox->stop = 1;
+        pthread_cond_signal( &inbox->cond );
+        pthread_mutex_unlock( &inbox->guard );
+        pthread_join( inbox->thread, NULL );
+
+        for ( j = 0; j < inbox->plugins_num; ++j )
+            if ( inbox->plugins[j]->clean != NULL )
+                inbox->plugins[j]->clean();
+
+        pthread_cond_destroy( &inbox->cond );
+        pthread_mutex_destroy( &inbox->guard );
+        free( inbox );
+    }
+
+    for ( i = 0; i < plugins.handles_num; ++i )
+        dlclose( plugins.handles[i] );
+
+    memset( &plugins, 0, sizeof( plugins ) );
+}
@@ -0,0 +1,289 @@
+/* ing_ntfr_queue.c
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains per-severity priority queue used by listener handler
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ing_ntfr_defines.h"
+#include "ing_ntfr_queue.h"
+
+#define NTF_QUEUE_NONE (-1)
+
+/*
+ * Dispatch slots per round of weighted scheduling, from ALERT to DBG
+ */
+static const int ntf_queue_weights[NTF_QUEUE_PRIO_NUM] = { 64, 32, 16, 8, 4, 2, 1 };
+
+/*
+ * Map severity level to priority index (0 is the highest priority)
+ */
+static int ntf_queue_prio( int severity )
+{
+    if ( severity < NTF_SEVERITY_ALERT || severity > NTF_SEVERITY_DBG )
+        return NTF_QUEUE_PRIO_NUM - 1;
+
+    return severity - NTF_SEVERITY_ALERT;
+}
+
+/*
+ * Copy notification with values of its parameters to 'param_pool'
+ */
+int ntf_notification_copy( struct ing_notification *dst, char *param_pool, size_t pool_len,
+                           struct ing_notification *src )
+{
+    size_t len;
+    int i;
+
+    memcpy( dst, src, sizeof( struct ing_notification ) );
+
+    for ( i = 0; i < src->param_num && i < NTF_PARAM_IN_MSG_MAX; ++i )
+    {
+        if ( src->params[i] == NULL )
+            continue;
+
+        len = strlen( src->params[i] ) + 1;
+        if ( len > pool_len )
+        {
+            dst->param_num = i;
+            return -1;
+        }
+
+        memcpy( param_pool, src->params[i], len );
+        dst->params[i] = param_pool;
+        param_pool += len;
+        pool_len   -= len;
+    }
+
+    return 0;
+}
+
+/*
+ * Initialize empty queue
+ */
+void ntf_queue_init( struct ntf_queue *queue, int sched )
+{
+    int i;
+
+    memset( queue, 0, sizeof( struct ntf_queue ) );
+    queue->sched = sched;
+
+    for ( i = 0; i < NTF_QUEUE_PRIO_NUM; ++i )
+    {
+        queue->head[i]    = NTF_QUEUE_NONE;
+        queue->tail[i]    = NTF_QUEUE_NONE;
+        queue->credits[i] = ntf_queue_weights[i];
+    }
+
+    for ( i = 0; i < NTF_QUEUE_LEN; ++i )
+        queue->entries[i].next = i + 1;
+    queue->entries[NTF_QUEUE_LEN - 1].next = NTF_QUEUE_NONE;
+    queue->free_head = 0;
+}
+
+/*
+ * Take free entry for receiving notification
+ */
+struct ntf_queue_entry* ntf_queue_reserve( struct ntf_queue *queue )
+{
+    struct ntf_queue_entry *entry;
+
+    if ( queue->free_head == NTF_QUEUE_NONE )
+        return NULL;
+
+    entry = &queue->entries[queue->free_head];
+    queue->free_head = entry->next;
+    entry->next = NTF_QUEUE_NONE;
+
+    return entry;
+}
+
+/*
+ * Put received notification to the queue of its severity
+ */
+void ntf_queue_push( struct ntf_queue *queue, struct ntf_queue_entry *entry )
+{
+    int prio, idx;
+
+    prio = ntf_queue_prio( entry->notif.severity );
+    idx  = entry - queue->entries;
+
+    entry->next = NTF_QUEUE_NONE;
+    if ( queue->tail[prio] == NTF_QUEUE_NONE )
+        queue->head[prio] = idx;
+    else
+        queue->entries[queue->tail[prio]].next = idx;
+    queue->tail[prio] = idx;
+
+    ++queue->count;
+    __atomic_add_fetch( &queue->depth[prio], 1, __ATOMIC_RELAXED );
+    if ( queue->depth[prio] > queue->max_depth[prio] )
+        queue->max_depth[prio] = queue->depth[prio];
+}
+
+/*
+ * Select priority to be dispatched next
+ */
+static int ntf_queue_select( struct ntf_queue *queue )
+{
+    int i, round;
+
+    if ( queue->sched == NTF_QUEUE_SCHED_STRICT )
+    {
+        for ( i = 0; i < NTF_QUEUE_PRIO_NUM; ++i )
+            if ( queue->head[i] != NTF_QUEUE_NONE )
+                return i;
+        return NTF_QUEUE_NONE;
+    }
+
+    /* weighted: highest non-empty priority which has credits left in the round;
+     * start the new round if all pending priorities have used their credits */
+    for ( round = 0; round < 2; ++round )
+    {
+        for ( i = 0; i < NTF_QUEUE_PRIO_NUM; ++i )
+        {
+            if ( queue->head[i] != NTF_QUEUE_NONE && queue->credits[i] > 0 )
+            {
+                --queue->credits[i];
+                return i;
+            }
+        }
+
+        for ( i = 0; i < NTF_QUEUE_PRIO_NUM; ++i )
+            queue->credits[i] = ntf_queue_weights[i];
+    }
+
+    return NTF_QUEUE_NONE;
+}
+
+/*
+ * Get the next notification to be dispatched
+ */
+struct ntf_queue_entry* ntf_queue_pop( struct ntf_queue *queue )
+{
+    struct ntf_queue_entry *entry;
+    int prio;
+
+    if ( queue->count == 0 )
+        return NULL;
+
+    prio = ntf_queue_select( queue );
+    if ( prio == NTF_QUEUE_NONE )
+        return NULL;
+
+    entry = &queue->entries[queue->head[prio]];
+    queue->head[prio] = entry->next;
+    if ( queue->head[prio] == NTF_QUEUE_NONE )
+        queue->tail[prio] = NTF_QUEUE_NONE;
+    entry->next = NTF_QUEUE_NONE;
+
+    --queue->count;
+    __atomic_sub_fetch( &queue->depth[prio], 1, __ATOMIC_RELAXED );
+
+    return entry;
+}
+
+/*
+ * Return dispatched (or not used) entry to the queue
+ */
+void ntf_queue_release( struct ntf_queue *queue, struct ntf_queue_entry *entry )
+{
+    entry->next = queue->free_head;
+    queue->free_head = entry - queue->entries;
+}
+
+/*
+ * Get current depth of the queue for severity level
+ */
+int ntf_queue_depth( struct ntf_queue *queue, int severity )
+{
+    return __atomic_load_n( &queue->depth[ntf_queue_prio( severity )], __ATOMIC_RELAXED );
+}
+
+/*
+ * Log depth of non-empty priorities and reset depth watermarks
+ */
+void ntf_queue_report( struct ntf_queue *queue, const char *name )
+{
+    int i;
+
+    for ( i = 0; i < NTF_QUEUE_PRIO_NUM; ++i )
+    {
+        if ( queue->max_depth[i] == 0 )
+            continue;
+
+        LOG( "%s listener queue, severity %d: depth %d, max depth %d",
+              name, i + NTF_SEVERITY_ALERT, queue->depth[i], queue->max_depth[i] );
+        queue->max_depth[i] = queue->depth[i];
+    }
+}
@@ -0,0 +1,165 @@
+/* ing_ntfr_queue.h
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains per-severity priority queue used by listener handler
+ * to dispatch received notifications
+ */
+
+#ifndef ING_NTFR_QUEUE_H
+#define ING_NTFR_QUEUE_H
+
+#include <stdint.h>
+
+#include "ing_ntfr_defines.h"
+
+/*
+ * Constants
+ */
+#define NTF_QUEUE_PRIO_NUM NTF_SEVERITY_DBG /* one priority per severity level */
+#define NTF_QUEUE_LEN      64               /* entries per listener queue      */
+
+/*
+ * Scheduling of priorities
+ *
+ *  strict   - notification of lower severity is dispatched only when
+ *             there are no pending notifications of higher severity
+ *  weighted - every priority gets its share of dispatch (ALERT gets 64 slots
+ *             per round, CRIT 32, ... DBG 1) so low severities are not starved
+ */
+enum ntf_queue_sched
+{
+    NTF_QUEUE_SCHED_STRICT = 0,
+    NTF_QUEUE_SCHED_WEIGHTED
+};
+
+/*
+ * Queue entry: decoded notification and pool of its parameters
+ */
+struct ntf_queue_entry
+{
+    struct ing_notification notif;
+    char param_pool[NTF_STR_MSG_BUFFER_LEN];
+    int64_t received_ns;        /* when handler received it, for statistics */
+    int  next;
+};
+
+/*
+ * Priority queue; entries are linked to per-priority FIFO lists
+ */
+struct ntf_queue
+{
+    int sched;
+    int count;
+    int free_head;
+    int head[NTF_QUEUE_PRIO_NUM];
+    int tail[NTF_QUEUE_PRIO_NUM];
+    int depth[NTF_QUEUE_PRIO_NUM];     /* current number of entries per priority */
+    int max_depth[NTF_QUEUE_PRIO_NUM]; /* highest depth since previous report    */
+    int credits[NTF_QUEUE_PRIO_NUM];
+    struct ntf_queue_entry entries[NTF_QUEUE_LEN];
+};
+
+/*
+ * Copy notification with values of its parameters to 'param_pool'
+ * Returns: 0 on success, -1 if parameters do not fit to the pool
+ */
+int ntf_notification_copy( struct ing_notification *dst, char *param_pool, size_t pool_len,
+                           struct ing_notification *src );
+/*
+ * Initialize empty queue
+ */
+void ntf_queue_init( struct ntf_queue *queue, int sched );
+/*
+ * Take free entry for receiving notification, NULL if queue is full
+ */
+struct ntf_queue_entry* ntf_queue_reserve( struct ntf_queue *queue );
+/*
+ * Put received notification to the queue of its severity
+ */
+void ntf_queue_push( struct ntf_queue *queue, struct ntf_queue_entry *entry );
+/*
+ * Get the next notification to be dispatched, NULL if queue is empty
+ */
+struct ntf_queue_entry* ntf_queue_pop( struct ntf_queue *queue );
+/*
+ * Return dispatched (or not used) entry to the queue
+ */
+void ntf_queue_release( struct ntf_queue *queue, struct ntf_queue_entry *entry );
+/*
+ * Get current depth of the queue for severity level
+ */
+int ntf_queue_depth( struct ntf_queue *queue, int severity );
+/*
+ * Log depth of non-empty priorities and reset depth watermarks
+ */
+void ntf_queue_report( struct ntf_queue *queue, const char *name );
+
+#endif /* ING_NTFR_QUEUE_H */
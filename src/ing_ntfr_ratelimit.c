@@ -0,0 +1,475 @@
+/* ing_ntfr_ratelimit.c
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains token-bucket rate limiting of notifications
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <libconfig.h>
+
+#include "ing_ntfr_defines.h"
+#include "ing_ntfr_ratelimit.h"
+
+#define NTF_RATELIMIT_RULES_MAX   32
+#define NTF_RATELIMIT_BUCKETS_MAX 1024   /* power of 2 */
+#define NTF_RATELIMIT_ANY         (-1)
+
+/* bucket fill is kept in millionth parts of token */
+#define NTF_RATELIMIT_TOKEN     1000000LL
+
+/*
+ * Token bucket of one (msg_id, module_id) key
+ */
+struct ntf_ratelimit_bucket
+{
+    int rule;                   /* rule index + 1, 0 for unused slot      */
+    int msg_id;
+    int module_id;
+    long long tokens;           /* current bucket fill                    */
+    struct timespec last;       /* time of last refill                    */
+    unsigned long dropped;      /* dropped notifications, total           */
+    unsigned long reported;     /* value of 'dropped' on previous report  */
+};
+
+/*
+ * Rate limit rule. Rule with exact key has the only bucket 'shared',
+ * rule with wildcard has a bucket per every matched key in the table
+ * of buckets, 'shared' is used by such rule only when the table is full
+ */
+struct ntf_ratelimit_rule
+{
+    int msg_id;                 /* matched msg_id or NTF_RATELIMIT_ANY    */
+    int module_id;              /* matched module_id or NTF_RATELIMIT_ANY */
+    long long rate;             /* refill rate, tokens per second         */
+    long long burst;            /* bucket capacity, tokens                */
+    struct ntf_ratelimit_bucket shared;
+};
+
+struct ntf_ratelimit
+{
+    int bypass_critical;
+    int rules_num;
+    struct ntf_ratelimit_rule rules[NTF_RATELIMIT_RULES_MAX];
+    int buckets_num;
+    int overflow;               /* table of buckets was full */
+    struct ntf_ratelimit_bucket buckets[NTF_RATELIMIT_BUCKETS_MAX];
+};
+
+static struct ntf_ratelimit ratelimit;
+static pthread_mutex_t ratelimit_lock = PTHREAD_MUTEX_INITIALIZER; /* receive shards of core share buckets */
+
+/* table is rebuilt here on reload and compaction, both are made by main thread */
+static struct ntf_ratelimit ratelimit_fresh;
+
+/*
+ * Find rule with the same key in the current table
+ */
+static struct ntf_ratelimit_rule* ntf_ratelimit_find( int msg_id, int module_id )
+{
+    int i;
+
+    for ( i = 0; i < ratelimit.rules_num; ++i )
+    {
+        if ( ratelimit.rules[i].msg_id == msg_id &&
+             ratelimit.rules[i].module_id == module_id )
+            return &ratelimit.rules[i];
+    }
+
+    return NULL;
+}
+
+/*
+ * Find bucket of 'rule' for the key in 'table', the bucket is added
+ * if 'now' is not NULL
+ * Returns: bucket or NULL if it is not found or the table is full
+ */
+static struct ntf_ratelimit_bucket* ntf_ratelimit_bucket( struct ntf_ratelimit *table, int rule,
+                                                          int msg_id, int module_id,
+                                                          struct timespec *now )
+{
+    struct ntf_ratelimit_bucket *bucket;
+    unsigned int i, n;
+
+    i = ( (unsigned int)msg_id * 2654435761U ) ^ ( (unsigned int)module_id * 40503U ) ^ (unsigned int)rule;
+    for ( n = 0; n < NTF_RATELIMIT_BUCKETS_MAX; ++n, ++i )
+    {
+        bucket = &table->buckets[i & ( NTF_RATELIMIT_BUCKETS_MAX - 1 )];
+        if ( bucket->rule == rule + 1 && bucket->msg_id == msg_id && bucket->module_id == module_id )
+            return bucket;
+        if ( bucket->rule == 0 )
+            break;
+    }
+
+    /* table is kept at most 3/4 full to keep probes short */
+    if ( now == NULL || bucket->rule != 0 || table->buckets_num >= NTF_RATELIMIT_BUCKETS_MAX / 4 * 3 )
+        return NULL;
+
+    bucket->rule      = rule + 1;
+    bucket->msg_id    = msg_id;
+    bucket->module_id = module_id;
+    bucket->tokens    = table->rules[rule].burst * NTF_RATELIMIT_TOKEN;
+    bucket->last      = *now;
+    ++table->buckets_num;
+
+    return bucket;
+}
+
+/*
+ * Copy state of 'from' bucket to 'to' bucket of rule with capacity 'burst'
+ */
+static void ntf_ratelimit_keep( struct ntf_ratelimit_bucket *to, struct ntf_ratelimit_bucket *from,
+                                long long burst )
+{
+    to->tokens   = from->tokens;
+    to->last     = from->last;
+    to->dropped  = from->dropped;
+    to->reported = from->reported;
+    if ( to->tokens > burst * NTF_RATELIMIT_TOKEN )
+        to->tokens = burst * NTF_RATELIMIT_TOKEN;
+}
+
+/*
+ * Read boolean 'rate_limit_bypass_critical', native or string "true"
+ */
+static int ntf_ratelimit_bypass( config_t *cfg )
+{
+    config_setting_t *setting;
+    const char *pvalue;
+
+    setting = config_lookup( cfg, "rate_limit_bypass_critical" );
+    if ( setting == NULL )
+        return 0;
+
+    switch ( config_setting_type( setting ) )
+    {
+    case CONFIG_TYPE_BOOL:
+        return config_setting_get_bool( setting );
+    case CONFIG_TYPE_INT:
+        return config_setting_get_int( setting ) != 0;
+    case CONFIG_TYPE_STRING:
+        pvalue = config_setting_get_string( setting );
+        return ( pvalue != NULL && strcmp( pvalue, "true" ) == 0 );
+    default:
+        ERR( "rate_limit_bypass_critical is not a boolean, it is ignored" );
+        return 0;
+    }
+}
+
+/*
+ * Load rate limit rules from configuration file
+ */
+int ntf_ratelimit_load()
+{
+    config_t cfg;
+    config_setting_t *list, *item;
+    struct ntf_ratelimit *fresh = &ratelimit_fresh;
+    struct ntf_ratelimit_rule *rule, *old;
+    struct ntf_ratelimit_bucket *bucket, *kept;
+    struct timespec now;
+    int moved[NTF_RATELIMIT_RULES_MAX];
+    int i, count, rate, burst;
+
+    memset( fresh, 0, sizeof( struct ntf_ratelimit ) );
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    config_init( &cfg );
+    if ( config_read_file( &cfg, NTF_CONF_FILE_NAME ) == CONFIG_FALSE )
+    {
+        config_destroy( &cfg );
+        return -1;
+    }
+
+    fresh->bypass_critical = ntf_ratelimit_bypass( &cfg );
+
+    list = config_lookup( &cfg, "rate_limits" );
+    count = ( list != NULL ) ? config_setting_length( list ) : 0;
+
+    for ( i = 0; i < count; ++i )
+    {
+        if ( fresh->rules_num >= NTF_RATELIMIT_RULES_MAX )
+        {
+            ERR( "too many rate limit rules, only %d are used", NTF_RATELIMIT_RULES_MAX );
+            break;
+        }
+
+        item = config_setting_get_elem( list, i );
+        rule = &fresh->rules[fresh->rules_num];
+
+        if ( config_setting_lookup_int( item, "msg_id", &rule->msg_id ) == CONFIG_FALSE )
+            rule->msg_id = NTF_RATELIMIT_ANY;
+        if ( config_setting_lookup_int( item, "module_id", &rule->module_id ) == CONFIG_FALSE )
+            rule->module_id = NTF_RATELIMIT_ANY;
+
+        if ( config_setting_lookup_int( item, "rate", &rate ) == CONFIG_FALSE || rate < 0 )
+        {
+            ERR( "rate limit rule #%d has no valid 'rate', skip it", i );
+            continue;
+        }
+        if ( config_setting_lookup_int( item, "burst", &burst ) == CONFIG_FALSE || burst < 1 )
+            burst = ( rate > 0 ) ? rate : 1;
+
+        rule->rate   = rate;
+        rule->burst  = burst;
+        rule->shared.rule      = fresh->rules_num + 1;
+        rule->shared.msg_id    = rule->msg_id;
+        rule->shared.module_id = rule->module_id;
+        rule->shared.tokens    = rule->burst * NTF_RATELIMIT_TOKEN;
+        rule->shared.last      = now;
+
+        ++fresh->rules_num;
+    }
+
+    config_destroy( &cfg );
+
+    pthread_mutex_lock( &ratelimit_lock );
+
+    /* keep state of the buckets if the same rule was already loaded */
+    for ( i = 0; i < NTF_RATELIMIT_RULES_MAX; ++i )
+        moved[i] = -1;
+    for ( i = 0; i < fresh->rules_num; ++i )
+    {
+        rule = &fresh->rules[i];
+        old = ntf_ratelimit_find( rule->msg_id, rule->module_id );
+        if ( old != NULL )
+        {
+            ntf_ratelimit_keep( &rule->shared, &old->shared, rule->burst );
+            moved[old - ratelimit.rules] = i;
+        }
+    }
+    for ( i = 0; i < NTF_RATELIMIT_BUCKETS_MAX; ++i )
+    {
+        bucket = &ratelimit.buckets[i];
+        if ( bucket->rule == 0 || moved[bucket->rule - 1] < 0 )
+            continue;
+
+        kept = ntf_ratelimit_bucket( fresh, moved[bucket->rule - 1],
+                                     bucket->msg_id, bucket->module_id, &now );
+        if ( kept != NULL )
+            ntf_ratelimit_keep( kept, bucket, fresh->rules[kept->rule - 1].burst );
+    }
+
+    memcpy( &ratelimit, fresh, sizeof( ratelimit ) );
+    pthread_mutex_unlock( &ratelimit_lock );
+    LOG( "%d rate limit rule(s) loaded, critical bypass %s",
+          ratelimit.rules_num, ratelimit.bypass_critical ? "on" : "off" );
+
+    return 0;
+}
+
+/*
+ * Add tokens to the bucket accordingly to the time passed from previous refill
+ */
+static void ntf_ratelimit_refill( struct ntf_ratelimit_bucket *bucket, long long rate,
+                                  long long burst, struct timespec *now )
+{
+    long long elapsed_us, limit;
+
+    elapsed_us = ( now->tv_sec - bucket->last.tv_sec ) * 1000000LL
+               + ( now->tv_nsec - bucket->last.tv_nsec ) / 1000;
+    if ( elapsed_us <= 0 )
+        return;
+
+    limit = burst * NTF_RATELIMIT_TOKEN;
+    bucket->tokens += elapsed_us * rate;
+    if ( bucket->tokens > limit )
+        bucket->tokens = limit;
+    bucket->last = *now;
+}
+
+/*
+ * Check if notification is allowed to be forwarded
+ */
+int ntf_ratelimit_allow( int msg_id, int module_id, int severity )
+{
+    struct ntf_ratelimit_bucket *matched[NTF_RATELIMIT_RULES_MAX];
+    struct ntf_ratelimit_bucket *bucket;
+    struct ntf_ratelimit_rule *rule;
+    struct timespec now;
+    int i, matched_num;
+
+    /* no rules is the common case, it is checked without lock */
+    if ( __atomic_load_n( &ratelimit.rules_num, __ATOMIC_RELAXED ) == 0 )
+        return 1;
+
+    pthread_mutex_lock( &ratelimit_lock );
+
+    if ( ratelimit.bypass_critical &&
+         ( severity == NTF_SEVERITY_ALERT || severity == NTF_SEVERITY_CRIT ) )
+    {
+        pthread_mutex_unlock( &ratelimit_lock );
+        return 1;
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    /* notification passes only if every matched bucket has a token */
+    matched_num = 0;
+    for ( i = 0; i < ratelimit.rules_num; ++i )
+    {
+        rule = &ratelimit.rules[i];
+        if ( ( rule->msg_id != NTF_RATELIMIT_ANY && rule->msg_id != msg_id ) ||
+             ( rule->module_id != NTF_RATELIMIT_ANY && rule->module_id != module_id ) )
+            continue;
+
+        bucket = &rule->shared;
+        if ( rule->msg_id == NTF_RATELIMIT_ANY || rule->module_id == NTF_RATELIMIT_ANY )
+        {
+            /* one noisy key of wildcard rule does not throttle the others */
+            bucket = ntf_ratelimit_bucket( &ratelimit, i, msg_id, module_id, &now );
+            if ( bucket == NULL )
+            {
+                if ( !ratelimit.overflow )
+                    ERR( "too many rate limited keys, %d buckets are used, rule #%d shares one bucket",
+                         NTF_RATELIMIT_BUCKETS_MAX / 4 * 3, i );
+                ratelimit.overflow = 1;
+                bucket = &rule->shared;
+            }
+        }
+
+        ntf_ratelimit_refill( bucket, rule->rate, rule->burst, &now );
+        if ( bucket->tokens < NTF_RATELIMIT_TOKEN )
+        {
+            ++bucket->dropped;
+            pthread_mutex_unlock( &ratelimit_lock );
+            return 0;
+        }
+        matched[matched_num++] = bucket;
+    }
+
+    for ( i = 0; i < matched_num; ++i )
+        matched[i]->tokens -= NTF_RATELIMIT_TOKEN;
+
+    pthread_mutex_unlock( &ratelimit_lock );
+    return 1;
+}
+
+/*
+ * Log drops of the bucket since previous report
+ */
+static void ntf_ratelimit_report_bucket( struct ntf_ratelimit_bucket *bucket )
+{
+    if ( bucket->dropped == bucket->reported )
+        return;
+
+    INF( "rate limit (msg_id %d, module_id %d): %lu notification(s) dropped (%lu total)",
+          bucket->msg_id, bucket->module_id,
+          bucket->dropped - bucket->reported, bucket->dropped );
+    bucket->reported = bucket->dropped;
+}
+
+/*
+ * Log number of notifications dropped per key since previous report
+ */
+void ntf_ratelimit_report()
+{
+    struct ntf_ratelimit *fresh = &ratelimit_fresh;
+    struct ntf_ratelimit_bucket *bucket, *kept;
+    struct ntf_ratelimit_rule *rule;
+    struct timespec now;
+    int i;
+
+    pthread_mutex_lock( &ratelimit_lock );
+    for ( i = 0; i < ratelimit.rules_num; ++i )
+        ntf_ratelimit_report_bucket( &ratelimit.rules[i].shared );
+    for ( i = 0; i < NTF_RATELIMIT_BUCKETS_MAX; ++i )
+    {
+        if ( ratelimit.buckets[i].rule != 0 )
+            ntf_ratelimit_report_bucket( &ratelimit.buckets[i] );
+    }
+
+    /* buckets refilled up to capacity are equal to new ones, they are
+     * removed so keys seen once do not fill the table */
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    fresh->buckets_num = 0;
+    memset( fresh->buckets, 0, sizeof( fresh->buckets ) );
+    for ( i = 0; i < NTF_RATELIMIT_BUCKETS_MAX; ++i )
+    {
+        bucket = &ratelimit.buckets[i];
+        if ( bucket->rule == 0 )
+            continue;
+
+        rule = &ratelimit.rules[bucket->rule - 1];
+        ntf_ratelimit_refill( bucket, rule->rate, rule->burst, &now );
+        if ( bucket->tokens >= rule->burst * NTF_RATELIMIT_TOKEN )
+            continue;
+
+        kept = ntf_ratelimit_bucket( fresh, bucket->rule - 1, bucket->msg_id, bucket->module_id, &now );
+        if ( kept != NULL )
+            ntf_ratelimit_keep( kept, bucket, rule->burst );
+    }
+    memcpy( ratelimit.buckets, fresh->buckets, sizeof( ratelimit.buckets ) );
+    ratelimit.buckets_num = fresh->buckets_num;
+    ratelimit.overflow    = 0;
+    pthread_mutex_unlock( &ratelimit_lock );
+}
@@ -0,0 +1,314 @@
+/* ing_ntfr_reliable.c
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains receiving side of reliable delivery of notifications:
+ * duplicates are dropped and senders get cumulative acks
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include "ing_ntfr_defines.h"
+#include "ing_ntfr_reliable.h"
+
+/* senders tracked, the least recently used one is replaced */
+#define NTF_RELIABLE_SENDERS_MAX 64
+
+/* notifications tracked ahead of the first missing one */
+#define NTF_RELIABLE_AHEAD 64
+
+/*
+ * State of reliable sender, keyed by its address and random id
+ */
+struct ntf_reliable_sender
+{
+    struct sockaddr_in addr;
+    uint32_t sender;
+    uint64_t next;          /* first sequence number not received     */
+    uint64_t ahead;         /* bit n is set if 'next + n' is received */
+    unsigned long used;     /* tick of last notification, 0 if free   */
+};
+
+/*
+ * Reliable senders of core
+ */
+struct ntf_reliable
+{
+    pthread_mutex_t lock; /* receive shards of core share senders */
+    struct ntf_reliable_sender senders[NTF_RELIABLE_SENDERS_MAX];
+    unsigned long tick;
+    unsigned long received;
+    unsigned long duplicates;
+    unsigned long reported;
+};
+
+/*
+ * Global variable
+ */
+static struct ntf_reliable reliable = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+/*
+ * Parse "!R;<sender>;<seq>;<base>;" header
+ * Returns: length of header, -1 if it is bad
+ */
+static int ntf_reliable_parse( const char *buffer, size_t len, uint32_t *sender,
+                               uint64_t *seq, uint64_t *base )
+{
+    const char *pos;
+    char *end;
+
+    if ( len < 4 || buffer[0] != NTF_RELIABLE_MARK || buffer[1] != 'R' || buffer[2] != ';' )
+        return -1;
+
+    pos = buffer + 3;
+    *sender = strtoul( pos, &end, 16 );
+    if ( end == pos || *end != ';' )
+        return -1;
+
+    pos = end + 1;
+    *seq = strtoull( pos, &end, 10 );
+    if ( end == pos || *end != ';' )
+        return -1;
+
+    pos = end + 1;
+    *base = strtoull( pos, &end, 10 );
+    if ( end == pos || *end != ';' || *base > *seq )
+        return -1;
+
+    if ( (size_t)( end + 1 - buffer ) > len )
+        return -1;
+    return end + 1 - buffer;
+}
+
+/*
+ * Find state of sender, new one replaces the least recently used
+ */
+static struct ntf_reliable_sender* ntf_reliable_sender( const struct sockaddr_in *from, uint32_t sender,
+                                                        uint64_t base )
+{
+    struct ntf_reliable_sender *s, *lru = &reliable.senders[0];
+    int i;
+
+    for ( i = 0; i < NTF_RELIABLE_SENDERS_MAX; ++i )
+    {
+        s = &reliable.senders[i];
+        if ( s->used != 0 && s->sender == sender && s->addr.sin_port == from->sin_port &&
+             s->addr.sin_addr.s_addr == from->sin_addr.s_addr )
+            return s;
+        if ( s->used < lru->used )
+            lru = s;
+    }
+
+    /* notifications before 'base' are acked by previous run of core */
+    memset( lru, 0, sizeof( struct ntf_reliable_sender ) );
+    lru->addr   = *from;
+    lru->sender = sender;
+    lru->next   = base;
+    return lru;
+}
+
+/*
+ * Move 'next' over notifications received in order
+ */
+static void ntf_reliable_advance( struct ntf_reliable_sender *s )
+{
+    while ( s->ahead & 1 )
+    {
+        s->ahead >>= 1;
+        s->next++;
+    }
+}
+
+/*
+ * Update state of sender with received sequence number, called under lock
+ * Returns: 1 if notification is new, 0 if it is a duplicate, -1 if it is not acceptable
+ */
+static int ntf_reliable_update( const struct sockaddr_in *from, uint32_t sender,
+                                uint64_t seq, uint64_t base, void **ack )
+{
+    struct ntf_reliable_sender *s;
+    uint64_t d;
+
+    s = ntf_reliable_sender( from, sender, base );
+    s->used = ++reliable.tick;
+    *ack = s;
+
+    /* sender has got acks for all before 'base' */
+    if ( base > s->next )
+    {
+        if ( base - s->next >= NTF_RELIABLE_AHEAD )
+            s->ahead = 0;
+        else
+            s->ahead >>= base - s->next;
+        s->next = base;
+        ntf_reliable_advance( s );
+    }
+
+    d = seq - s->next;
+    if ( seq < s->next || ( d < NTF_RELIABLE_AHEAD && ( s->ahead & ( 1ULL << d ) ) ) )
+    {
+        reliable.duplicates++;
+        return 0;
+    }
+    if ( d >= NTF_RELIABLE_AHEAD )
+    {
+        /* sender window is smaller, it is not possible */
+        ERR( "Reliable notification %llu is too far ahead of %llu",
+             (unsigned long long)seq, (unsigned long long)s->next );
+        *ack = NULL;
+        return -1;
+    }
+
+    s->ahead |= 1ULL << d;
+    ntf_reliable_advance( s );
+    reliable.received++;
+    return 1;
+}
+
+/*
+ * Check notification of reliable sender
+ */
+int ntf_reliable_receive( char *buffer, size_t *len, const struct sockaddr_in *from, void **ack )
+{
+    uint64_t seq, base;
+    uint32_t sender;
+    int hdr_len, res;
+
+    *ack = NULL;
+
+    hdr_len = ntf_reliable_parse( buffer, *len, &sender, &seq, &base );
+    if ( hdr_len < 0 )
+    {
+        ERR( "Bad header of reliable notification" );
+        return -1;
+    }
+
+    pthread_mutex_lock( &reliable.lock );
+    res = ntf_reliable_update( from, sender, seq, base, ack );
+    pthread_mutex_unlock( &reliable.lock );
+    if ( res != 1 )
+        return res;
+
+    *len -= hdr_len;
+    memmove( buffer, buffer + hdr_len, *len );
+    buffer[*len] = '\0';
+    return 1;
+}
+
+/*
+ * Send cumulative ack to sender
+ */
+void ntf_reliable_ack( int sock, void *ack )
+{
+    struct ntf_reliable_sender *s = ack;
+    struct sockaddr_in addr;
+    char buffer[NTF_RELIABLE_HDR_LEN];
+    int len;
+
+    if ( s == NULL )
+        return;
+
+    /* state may be updated by other receive shard meanwhile */
+    pthread_mutex_lock( &reliable.lock );
+    addr = s->addr;
+    len = snprintf( buffer, sizeof( buffer ), "%cA;%08x;%llu;", NTF_RELIABLE_MARK,
+                    s->sender, (unsigned long long)( s->next - 1 ) );
+    pthread_mutex_unlock( &reliable.lock );
+
+    if ( sendto( sock, buffer, len, MSG_DONTWAIT, (struct sockaddr *)&addr, sizeof( addr ) ) < 0 )
+        LOG( "Cannot ack reliable notification: %s (%d)", strerror(errno), errno );
+}
+
+/*
+ * Log number of reliable notifications received since previous report
+ */
+void ntf_reliable_report()
+{
+    unsigned long received, duplicates;
+
+    pthread_mutex_lock( &reliable.lock );
+    received   = reliable.received;
+    duplicates = reliable.duplicates;
+    pthread_mutex_unlock( &reliable.lock );
+
+    if ( received == reliable.reported )
+        return;
+
+    INF( "reliable: %lu notification(s) received (%lu total, %lu duplicate(s))",
+          received - reliable.reported, received, duplicates );
+    reliable.reported = received;
+}
@@ -0,0 +1,345 @@
+/* ing_ntfr_replay.c
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains time-indexed replay buffer of rendered
+ * notifications (RFC 5277 replay)
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ing_ntfr_defines.h"
+#include "ing_ntfr_replay.h"
+
+/*
+ * Entry of the logical index 'i', 0 is the oldest
+ */
+static struct ntf_replay_entry* ntf_replay_entry( struct ntf_replay *replay, uint32_t i )
+{
+    return &replay->entries[( replay->hdr->first + i ) % replay->hdr->entries_max];
+}
+
+/*
+ * Check that every kept entry lies inside data ring and entries are ordered by time
+ * Returns: 1 if entries are valid, 0 otherwise
+ */
+static int ntf_replay_valid( struct ntf_replay *replay )
+{
+    struct ntf_replay_entry *entry;
+    int64_t time_ns = INT64_MIN;
+    uint32_t i;
+
+    for ( i = 0; i < replay->hdr->count; ++i )
+    {
+        entry = ntf_replay_entry( replay, i );
+        if ( entry->len == 0 || entry->offset > replay->hdr->data_size ||
+             entry->len > replay->hdr->data_size - entry->offset || entry->time_ns < time_ns )
+            return 0;
+        time_ns = entry->time_ns;
+    }
+
+    return 1;
+}
+
+/*
+ * Open replay buffer
+ */
+int ntf_replay_open( struct ntf_replay *replay, size_t data_size, const char *file )
+{
+    struct ntf_replay_header *hdr;
+    uint32_t entries_max;
+    int keep = 0;
+    void *map;
+
+    memset( replay, 0, sizeof( struct ntf_replay ) );
+    replay->fd = -1;
+    pthread_rwlock_init( &replay->lock, NULL );
+
+    if ( data_size < NTF_REPLAY_ENTRY_AVG || data_size > UINT32_MAX )
+    {
+        ERR( "Bad size of replay buffer: %zu", data_size );
+        return -1;
+    }
+    entries_max = data_size / NTF_REPLAY_ENTRY_AVG;
+    replay->map_len = sizeof( struct ntf_replay_header ) +
+                      entries_max * sizeof( struct ntf_replay_entry ) + data_size;
+
+    if ( file == NULL )
+    {
+        map = calloc( 1, replay->map_len );
+        if ( map == NULL )
+        {
+            ERR( "Cannot allocate %zu bytes for replay buffer", replay->map_len );
+            return -1;
+        }
+    }
+    else
+    {
+        replay->fd = open( file, O_RDWR | O_CREAT | O_CLOEXEC, 0600 );
+        if ( replay->fd < 0 || ftruncate( replay->fd, replay->map_len ) != 0 )
+        {
+            ERR( "Cannot open replay file %s: %s (%d)", file, strerror(errno), errno );
+            goto reterr;
+        }
+
+        map = mmap( NULL, replay->map_len, PROT_READ | PROT_WRITE, MAP_SHARED, replay->fd, 0 );
+        if ( map == MAP_FAILED )
+        {
+            ERR( "Cannot map replay file %s: %s (%d)", file, strerror(errno), errno );
+            goto reterr;
+        }
+    }
+
+    hdr = map;
+    replay->hdr     = hdr;
+    replay->entries = (struct ntf_replay_entry *)( hdr + 1 );
+    replay->data    = (char *)( replay->entries + entries_max );
+
+    /* messages of previous run are kept if layout is the same */
+    if ( replay->fd >= 0 && hdr->magic == NTF_REPLAY_MAGIC && hdr->version == NTF_REPLAY_VERSION &&
+         hdr->entries_max == entries_max && hdr->data_size == data_size &&
+         hdr->count <= entries_max && hdr->first < entries_max && hdr->data_tail <= data_size )
+    {
+        keep = ntf_replay_valid( replay );
+        if ( !keep )
+            ERR( "Replay file %s is corrupted, its notifications are discarded", file );
+    }
+
+    if ( !keep )
+    {
+        memset( hdr, 0, sizeof( struct ntf_replay_header ) );
+        hdr->magic       = NTF_REPLAY_MAGIC;
+        hdr->version     = NTF_REPLAY_VERSION;
+        hdr->entries_max = entries_max;
+        hdr->data_size   = data_size;
+    }
+    else
+        INF( "Replay file %s: %u notifications kept", file, hdr->count );
+
+    return 0;
+
+reterr:
+    if ( replay->fd >= 0 )
+        close( replay->fd );
+    replay->fd = -1;
+    return -1;
+}
+
+/*
+ * Evict the oldest entry
+ */
+static void ntf_replay_evict( struct ntf_replay_header *hdr )
+{
+    hdr->first = ( hdr->first + 1 ) % hdr->entries_max;
+    --hdr->count;
+    ++hdr->seq_first;
+}
+
+/*
+ * Append message with the current time
+ */
+int ntf_replay_append( struct ntf_replay *replay, const char *msg, size_t len, uint32_t flags )
+{
+    struct ntf_replay_header *hdr = replay->hdr;
+    struct ntf_replay_entry *entry;
+    struct timespec now;
+    int64_t time_ns;
+    uint32_t pos;
+
+    if ( hdr == NULL || len == 0 || len > hdr->data_size )
+        return -1;
+
+    clock_gettime( CLOCK_REALTIME, &now );
+    time_ns = (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+
+    pthread_rwlock_wrlock( &replay->lock );
+
+    /* keep entries ordered by time if clock is moved back */
+    if ( hdr->count > 0 && ntf_replay_entry( replay, hdr->count - 1 )->time_ns > time_ns )
+        time_ns = ntf_replay_entry( replay, hdr->count - 1 )->time_ns;
+
+    pos = hdr->data_tail;
+    if ( pos + len > hdr->data_size )
+    {
+        /* message does not fit at the end: the rest of data ring is skipped,
+         * messages there are the oldest ones */
+        while ( hdr->count > 0 && ntf_replay_entry( replay, 0 )->offset >= pos )
+            ntf_replay_evict( hdr );
+        pos = 0;
+    }
+
+    /* evict messages overwritten by the new one */
+    while ( hdr->count > 0 &&
+            ( hdr->count == hdr->entries_max ||
+              ( ntf_replay_entry( replay, 0 )->offset >= pos &&
+                ntf_replay_entry( replay, 0 )->offset < pos + len ) ) )
+        ntf_replay_evict( hdr );
+
+    memcpy( replay->data + pos, msg, len );
+
+    entry = ntf_replay_entry( replay, hdr->count );
+    entry->time_ns = time_ns;
+    entry->offset  = pos;
+    entry->len     = len;
+    entry->flags   = flags;
+    ++hdr->count;
+    hdr->data_tail = pos + len;
+
+    pthread_rwlock_unlock( &replay->lock );
+    return 0;
+}
+
+/*
+ * Find sequence number of the first message not older than 'start_ns'
+ */
+uint64_t ntf_replay_find( struct ntf_replay *replay, int64_t start_ns )
+{
+    uint32_t lo, hi, mid;
+    uint64_t seq;
+
+    pthread_rwlock_rdlock( &replay->lock );
+
+    /* binary search, entries are ordered by time */
+    lo = 0;
+    hi = replay->hdr->count;
+    while ( lo < hi )
+    {
+        mid = lo + ( hi - lo ) / 2;
+        if ( ntf_replay_entry( replay, mid )->time_ns < start_ns )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    seq = replay->hdr->seq_first + lo;
+
+    pthread_rwlock_unlock( &replay->lock );
+    return seq;
+}
+
+/*
+ * Copy message with sequence number '*seq' to 'buf'
+ */
+ssize_t ntf_replay_get( struct ntf_replay *replay, uint64_t *seq, char *buf, size_t size,
+                        int64_t *time_ns, uint32_t *flags )
+{
+    struct ntf_replay_entry *entry;
+    ssize_t len = 0;
+
+    pthread_rwlock_rdlock( &replay->lock );
+
+    if ( *seq < replay->hdr->seq_first )
+        *seq = replay->hdr->seq_first;
+
+    if ( *seq < replay->hdr->seq_first + replay->hdr->count )
+    {
+        entry = ntf_replay_entry( replay, *seq - replay->hdr->seq_first );
+        if ( entry->len > size || entry->offset > replay->hdr->data_size ||
+             entry->len > replay->hdr->data_size - entry->offset )
+            len = -1;
+        else
+        {
+            memcpy( buf, replay->data + entry->offset, entry->len );
+            len      = entry->len;
+            *time_ns = entry->time_ns;
+            *flags   = entry->flags;
+        }
+    }
+
+    pthread_rwlock_unlock( &replay->lock );
+    return len;
+}
+
+/*
+ * Close replay buffer
+ */
+void ntf_replay_close( struct ntf_replay *replay )
+{
+    if ( replay->hdr != NULL )
+    {
+        if ( replay->fd >= 0 )
+            munmap( replay->hdr, replay->map_len );
+        else
+            free( replay->hdr );
+    }
+    if ( replay->fd >= 0 )
+        close( replay->fd );
+
+    replay->hdr = NULL;
+    replay->fd  = -1;
+    pthread_rwlock_destroy( &replay->lock );
+}
@@ -0,0 +1,166 @@
+/* ing_ntfr_replay.h
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains API of time-indexed replay buffer of rendered
+ * notifications (RFC 5277 replay)
+ */
+
+#ifndef ING_NTFR_REPLAY_H
+#define ING_NTFR_REPLAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+/*
+ * Constants
+ */
+#define NTF_REPLAY_MAGIC        (0x4e545250) /* "NTRP" */
+#define NTF_REPLAY_VERSION      (1)
+#define NTF_REPLAY_DATA_LEN     (1024 * 1024) /* default size of message data */
+#define NTF_REPLAY_ENTRY_AVG    (256)         /* average message size, gives number of entries */
+
+/*
+ * Entry flags
+ */
+#define NTF_REPLAY_ENVELOPED    (0x1) /* message is already in RFC 5277 envelope */
+
+/*
+ * Replay buffer layout, the same in memory and in mapped file:
+ * header, then ring of entries, then ring of message data
+ */
+struct ntf_replay_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entries_max;
+    uint32_t data_size;
+    uint64_t seq_first;  /* sequence number of the oldest entry */
+    uint32_t first;      /* index of the oldest entry           */
+    uint32_t count;
+    uint32_t data_tail;  /* where data of next message is put   */
+    uint32_t reserved;
+};
+
+struct ntf_replay_entry
+{
+    int64_t  time_ns;    /* event time, realtime clock; entries are ordered by it */
+    uint32_t offset;
+    uint32_t len;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+/*
+ * Replay buffer
+ *
+ *  Oldest messages are evicted when entries or data ring are full.
+ *  Messages are read one by one by sequence number, so that the lock
+ *  is not held while replayed messages are sent to a client.
+ */
+struct ntf_replay
+{
+    struct ntf_replay_header *hdr;
+    struct ntf_replay_entry  *entries;
+    char   *data;
+    size_t  map_len;
+    int     fd;          /* mapped file, -1 if buffer is in memory */
+    pthread_rwlock_t lock;
+};
+
+/*
+ * Open replay buffer of 'data_size' bytes of messages; if 'file' is not
+ * NULL, buffer is mapped to the file and messages of previous run are kept
+ */
+int ntf_replay_open( struct ntf_replay *replay, size_t data_size, const char *file );
+/*
+ * Append message with the current time
+ */
+int ntf_replay_append( struct ntf_replay *replay, const char *msg, size_t len, uint32_t flags );
+/*
+ * Find sequence number of the first message not older than 'start_ns'
+ */
+uint64_t ntf_replay_find( struct ntf_replay *replay, int64_t start_ns );
+/*
+ * Copy message with sequence number '*seq' to 'buf' of 'size' bytes;
+ * '*seq' is moved forward if the message is already evicted
+ * Returns: length of message, 0 if there are no more messages,
+ * -1 if message is larger than 'size'
+ */
+ssize_t ntf_replay_get( struct ntf_replay *replay, uint64_t *seq, char *buf, size_t size,
+                        int64_t *time_ns, uint32_t *flags );
+/*
+ * Close replay buffer
+ */
+void ntf_replay_close( struct ntf_replay *replay );
+
+#endif /* ING_NTFR_REPLAY_H */
@@ -75,34 +75,109 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
 #include <libconfig.h>
 #include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
 
 #include "ing_ntfr_defines.h"
 #include "ing_ntfr_settings.h"
 
-#define NTF_SETTINGS_KEY_LEN 32
-#define NTF_SETTINGS_VALUE_LEN 64
+/* initial number of slots of hash index, power of 2 */
+#define NTF_SETTINGS_INDEX_MIN 16
 
-#define NTF_SETTINGS_TBL_MAX 16
+/* initial size of writer tables */
+#define NTF_SETTINGS_KEYS_MIN 32
+
+/* max size of configuration file */
+#define NTF_SETTINGS_FILE_LEN_MAX (64 * 1024)
+
+/* size of native number or boolean value printed */
+#define NTF_SETTINGS_SCALAR_LEN 32
+
+/* max length of "[<IPv6>]:<port>" */
+#define NTF_SETTINGS_ADDRESS_LEN 64
 
 /*
- * Settings entry
+ * Settings entry of snapshot
  */
 struct ntf_settings_entry
+{
+    const char *key;
+    const char *value;
+    int type;
+    long num;      /* bool, int or duration in ms */
+    struct sockaddr_storage *addrs;
+    int addrs_num;
+};
+
+/*
+ * Snapshot of settings table with hash index, allocated as one block.
+ * Snapshot is never changed after it is published: readers take the
+ * current one with a single pointer load, writer builds a new one and
+ * frees the replaced one once no reader can hold it
+ */
+struct ntf_settings_snapshot
+{
+    struct ntf_settings_snapshot *retired; /* next replaced snapshot */
+    int settings_num;
+    unsigned slots;
+    int *index;                            /* entry number + 1, 0 if slot is empty */
+    struct ntf_settings_entry *entries;
+};
+
+/*
+ * Key loaded, it is looked up on update. Value is kept parsed
+ */
+struct ntf_settings_key
+{
+    char *key;
+    int type;
+    char *value;   /* NULL if key is not set */
+    long num;
+    struct sockaddr_storage *addrs;
+    int addrs_num;
+};
+
+/*
+ * Subscriber to changes of key value
+ */
+struct ntf_settings_subscriber
 {
     char key[NTF_SETTINGS_KEY_LEN];
-    char value[NTF_SETTINGS_VALUE_LEN];
-} ntf_settings_entry_t;
+    ntfsettings_notify_func func;
+    void *arg;
+};
+
+/*
+ * Key which value is changed on update
+ */
+struct ntf_settings_change
+{
+    char *key;
+    char *value;
+};
 
 /*
  * All settings of application
  */
 struct ntf_settings
 {
-    int settings_num;
-    pthread_mutex_t guard;
-    struct ntf_settings_entry settings_table[NTF_SETTINGS_TBL_MAX];
+    struct ntf_settings_snapshot *current;
+    struct ntf_settings_snapshot *retired; /* replaced, may still be read */
+    int readers;           /* threads reading a snapshot */
+    pthread_mutex_t guard; /* serializes writers */
+    int keys_num;
+    int keys_size;
+    struct ntf_settings_key *keys;
+    unsigned long long file_hash; /* hash of configuration file parsed */
+    int subscribers_num;
+    int subscribers_size;
+    struct ntf_settings_subscriber *subscribers;
 } ntf_settings_t;
 
 /*
@@ -111,6 +186,526 @@ struct ntf_settings
 struct ntf_settings settings;
 config_t g_cfg;
 
+/*
+ * Grow array of 'elem_size' elements to hold 'num' elements
+ * Returns: 0 on success, -1 if memory is exhausted
+ */
+static int ntf_settings_grow( void **array, int *size, int num, size_t elem_size, int size_min )
+{
+    void *grown;
+    int new_size;
+
+    if ( num <= *size )
+        return 0;
+
+    new_size = *size > 0 ? *size : size_min;
+    while ( new_size < num )
+        new_size *= 2;
+
+    grown = realloc( *array, new_size * elem_size );
+    if ( grown == NULL )
+    {
+        ERR( "Cannot allocate settings table of %d entries", new_size );
+        return -1;
+    }
+
+    *array = grown;
+    *size  = new_size;
+    return 0;
+}
+
+/*
+ * FNV-1a hash of key
+ */
+static unsigned ntf_settings_hash( const char *key )
+{
+    unsigned hash = 2166136261u;
+
+    for ( ; *key != '\0'; ++key )
+        hash = ( hash ^ (unsigned char)*key ) * 16777619u;
+
+    return hash;
+}
+
+/*
+ * Find entry of 'key' in snapshot
+ * Returns: entry, NULL if not found
+ */
+static struct ntf_settings_entry* ntf_settings_find( struct ntf_settings_snapshot *snapshot,
+                                                     const char *key )
+{
+    unsigned slot;
+    int idx;
+
+    slot = ntf_settings_hash( key ) & ( snapshot->slots - 1 );
+    while ( ( idx = snapshot->index[slot] ) != 0 )
+    {
+        if ( strcmp( snapshot->entries[idx - 1].key, key ) == 0 )
+            return &snapshot->entries[idx - 1];
+        slot = ( slot + 1 ) & ( snapshot->slots - 1 );
+    }
+
+    return NULL;
+}
+
+/*
+ * Parse boolean value
+ */
+static int ntf_settings_parse_bool( const char *value, long *num )
+{
+    if ( strcasecmp( value, "true" ) == 0 || strcasecmp( value, "yes" ) == 0 ||
+         strcasecmp( value, "on" ) == 0 || strcmp( value, "1" ) == 0 )
+        *num = 1;
+    else if ( strcasecmp( value, "false" ) == 0 || strcasecmp( value, "no" ) == 0 ||
+              strcasecmp( value, "off" ) == 0 || strcmp( value, "0" ) == 0 )
+        *num = 0;
+    else
+        return -1;
+
+    return 0;
+}
+
+/*
+ * Parse decimal integer, 'end' is set after the number if it is not NULL
+ */
+static int ntf_settings_parse_int( const char *value, long *num, char **end )
+{
+    char *pend;
+
+    errno = 0;
+    *num = strtol( value, &pend, 10 );
+    if ( pend == value || errno == ERANGE )
+        return -1;
+
+    if ( end != NULL )
+        *end = pend;
+    else if ( *pend != '\0' )
+        return -1;
+
+    return 0;
+}
+
+/*
+ * Parse duration to milliseconds
+ */
+static int ntf_settings_parse_duration( const char *value, long *num )
+{
+    char *unit;
+    long mult;
+
+    if ( ntf_settings_parse_int( value, num, &unit ) != 0 || *num < 0 )
+        return -1;
+
+    if ( *unit == '\0' || strcmp( unit, "ms" ) == 0 )
+        mult = 1;
+    else if ( strcmp( unit, "s" ) == 0 )
+        mult = 1000;
+    else if ( strcmp( unit, "m" ) == 0 )
+        mult = 60 * 1000;
+    else if ( strcmp( unit, "h" ) == 0 )
+        mult = 60 * 60 * 1000;
+    else
+        return -1;
+
+    if ( *num > LONG_MAX / mult )
+        return -1;
+
+    *num *= mult;
+    return 0;
+}
+
+/*
+ * Parse single address of list
+ */
+static int ntf_settings_parse_address( char *value, struct sockaddr_storage *addr )
+{
+    struct sockaddr_in  *addr4 = (struct sockaddr_in *)addr;
+    struct sockaddr_in6 *addr6 = (struct sockaddr_in6 *)addr;
+    char *host, *port, *colon;
+    long port_num = 0;
+
+    memset( addr, 0, sizeof( struct sockaddr_storage ) );
+
+    host = value;
+    port = NULL;
+    if ( host[0] == '[' )
+    {
+        host++;
+        colon = strchr( host, ']' );
+        if ( colon == NULL || ( colon[1] != '\0' && colon[1] != ':' ) )
+            return -1;
+        if ( colon[1] == ':' )
+            port = colon + 2;
+        *colon = '\0';
+    }
+    else
+    {
+        colon = strchr( host, ':' );
+        if ( colon != NULL && strchr( colon + 1, ':' ) == NULL )
+        {
+            *colon = '\0';
+            port = colon + 1;
+        }
+    }
+
+    if ( port != NULL &&
+         ( ntf_settings_parse_int( port, &port_num, NULL ) != 0 || port_num <= 0 || port_num > 65535 ) )
+        return -1;
+
+    if ( inet_pton( AF_INET, host, &addr4->sin_addr ) == 1 )
+    {
+        addr4->sin_family = AF_INET;
+        addr4->sin_port   = htons( port_num );
+        return 0;
+    }
+    if ( inet_pton( AF_INET6, host, &addr6->sin6_addr ) == 1 )
+    {
+        addr6->sin6_family = AF_INET6;
+        addr6->sin6_port   = htons( port_num );
+        return 0;
+    }
+
+    return -1;
+}
+
+/*
+ * Parse list of addresses
+ * Returns: 0 on success, '*addrs' is allocated
+ */
+static int ntf_settings_parse_addresses( const char *value, struct sockaddr_storage **addrs, int *addrs_num )
+{
+    char *list, *token, *saveptr = NULL;
+    int size = 0;
+
+    *addrs = NULL;
+    *addrs_num = 0;
+
+    list = strdup( value );
+    if ( list == NULL )
+        return -1;
+
+    for ( token = strtok_r( list, ", \t", &saveptr ); token != NULL;
+          token = strtok_r( NULL, ", \t", &saveptr ) )
+    {
+        if ( ntf_settings_grow( (void **)addrs, &size, *addrs_num + 1,
+                                sizeof( struct sockaddr_storage ), 4 ) != 0 ||
+             ntf_settings_parse_address( token, &( *addrs )[*addrs_num] ) != 0 )
+        {
+            free( *addrs );
+            free( list );
+            *addrs = NULL;
+            *addrs_num = 0;
+            return -1;
+        }
+        ( *addrs_num )++;
+    }
+
+    free( list );
+    return *addrs_num > 0 ? 0 : -1;
+}
+
+/*
+ * Set value of loaded key, "" means key is not set. Invalid value is
+ * reported and value is not changed
+ * Returns: 0 on success, -1 if value is invalid
+ */
+static int ntf_settings_key_set( struct ntf_settings_key *key, const char *value )
+{
+    struct sockaddr_storage *addrs = NULL;
+    int addrs_num = 0;
+    char *copy = NULL;
+    long num = 0;
+    int res = 0;
+
+    if ( value != NULL && value[0] != '\0' )
+    {
+        switch ( key->type )
+        {
+            case NTF_SETTINGS_BOOL:
+                res = ntf_settings_parse_bool( value, &num );
+                break;
+            case NTF_SETTINGS_INT:
+                res = ntf_settings_parse_int( value, &num, NULL );
+                break;
+            case NTF_SETTINGS_DURATION:
+                res = ntf_settings_parse_duration( value, &num );
+                break;
+            case NTF_SETTINGS_ADDRESSES:
+                res = ntf_settings_parse_addresses( value, &addrs, &addrs_num );
+                break;
+            default:
+                break;
+        }
+        if ( res != 0 )
+        {
+            ERR( "Invalid value of %s: %s", key->key, value );
+            return -1;
+        }
+
+        copy = strdup( value );
+        if ( copy == NULL )
+        {
+            free( addrs );
+            return -1;
+        }
+    }
+
+    free( key->value );
+    free( key->addrs );
+    key->value     = copy;
+    key->num       = num;
+    key->addrs     = addrs;
+    key->addrs_num = addrs_num;
+    return 0;
+}
+
+/*
+ * Look up 'key' in parsed configuration file. Native numbers and
+ * booleans are printed to 'buf', so that they are parsed as quoted ones
+ * Returns: value, NULL if key is not set or is not a scalar
+ */
+static const char* ntf_settings_lookup( const char *key, char *buf, size_t buf_len )
+{
+    config_setting_t *setting;
+
+    setting = config_lookup( &g_cfg, key );
+    if ( setting == NULL )
+        return NULL;
+
+    switch ( config_setting_type( setting ) )
+    {
+        case CONFIG_TYPE_STRING:
+            return config_setting_get_string( setting );
+        case CONFIG_TYPE_INT:
+            snprintf( buf, buf_len, "%d", config_setting_get_int( setting ) );
+            return buf;
+        case CONFIG_TYPE_INT64:
+            snprintf( buf, buf_len, "%lld", config_setting_get_int64( setting ) );
+            return buf;
+        case CONFIG_TYPE_FLOAT:
+            snprintf( buf, buf_len, "%g", config_setting_get_float( setting ) );
+            return buf;
+        case CONFIG_TYPE_BOOL:
+            snprintf( buf, buf_len, "%s", config_setting_get_bool( setting ) ? "true" : "false" );
+            return buf;
+        default:
+            ERR( "Value of %s is not a string, number or boolean, it is ignored", key );
+            return NULL;
+    }
+}
+
+/*
+ * Find loaded key
+ */
+static struct ntf_settings_key* ntf_settings_key_find( const char *key )
+{
+    int i;
+
+    for ( i = 0; i < settings.keys_num; ++i )
+        if ( strcmp( settings.keys[i].key, key ) == 0 )
+            return &settings.keys[i];
+
+    return NULL;
+}
+
+/*
+ * Free replaced snapshots if no reader is in progress: a reader that
+ * started after they were replaced takes the current one. Called under guard
+ */
+static void ntf_settings_reclaim()
+{
+    struct ntf_settings_snapshot *snapshot;
+
+    if ( __atomic_load_n( &settings.readers, __ATOMIC_SEQ_CST ) != 0 )
+        return;
+
+    while ( settings.retired != NULL )
+    {
+        snapshot = settings.retired;
+        settings.retired = snapshot->retired;
+        free( snapshot );
+    }
+}
+
+/*
+ * Build a new snapshot of keys set and publish it, the replaced one is
+ * freed later. Called under guard
+ * Returns: 0 on success, -1 if memory is exhausted
+ */
+static int ntf_settings_publish()
+{
+    struct ntf_settings_snapshot *next, *prev;
+    struct ntf_settings_entry *entry;
+    struct ntf_settings_key *key;
+    struct sockaddr_storage *addrs;
+    size_t strings_len, size, len;
+    int i, n, addrs_num;
+    unsigned slots, slot;
+    char *strings;
+
+    n = 0;
+    strings_len = 0;
+    addrs_num = 0;
+    for ( i = 0; i < settings.keys_num; ++i )
+    {
+        if ( settings.keys[i].value == NULL )
+            continue;
+        n++;
+        strings_len += strlen( settings.keys[i].key ) + strlen( settings.keys[i].value ) + 2;
+        addrs_num += settings.keys[i].addrs_num;
+    }
+
+    for ( slots = NTF_SETTINGS_INDEX_MIN; slots < 2 * (unsigned)n; slots *= 2 )
+        ;
+
+    /* header, entries, addresses, index and strings, in order of alignment */
+    size = sizeof( struct ntf_settings_snapshot ) +
+           n * sizeof( struct ntf_settings_entry ) +
+           addrs_num * sizeof( struct sockaddr_storage ) +
+           slots * sizeof( int ) + strings_len;
+    next = calloc( 1, size );
+    if ( next == NULL )
+    {
+        ERR( "Cannot allocate %zu bytes of settings", size );
+        return -1;
+    }
+
+    next->settings_num = n;
+    next->slots   = slots;
+    next->entries = (struct ntf_settings_entry *)( next + 1 );
+    addrs         = (struct sockaddr_storage *)( next->entries + n );
+    next->index   = (int *)( addrs + addrs_num );
+    strings       = (char *)( next->index + slots );
+
+    entry = next->entries;
+    n = 0;
+    for ( i = 0; i < settings.keys_num; ++i )
+    {
+        key = &settings.keys[i];
+        if ( key->value == NULL )
+            continue;
+
+        entry->type = key->type;
+        entry->num  = key->num;
+
+        len = strlen( key->key ) + 1;
+        memcpy( strings, key->key, len );
+        entry->key = strings;
+        strings += len;
+
+        len = strlen( key->value ) + 1;
+        memcpy( strings, key->value, len );
+        entry->value = strings;
+        strings += len;
+
+        memcpy( addrs, key->addrs, key->addrs_num * sizeof( struct sockaddr_storage ) );
+        entry->addrs     = addrs;
+        entry->addrs_num = key->addrs_num;
+        addrs += key->addrs_num;
+
+        slot = ntf_settings_hash( key->key ) & ( slots - 1 );
+        while ( next->index[slot] != 0 )
+            slot = ( slot + 1 ) & ( slots - 1 );
+        next->index[slot] = ++n;
+        entry++;
+    }
+
+    prev = __atomic_exchange_n( &settings.current, next, __ATOMIC_SEQ_CST );
+    if ( prev != NULL )
+    {
+        prev->retired = settings.retired;
+        settings.retired = prev;
+    }
+    ntf_settings_reclaim();
+    return 0;
+}
+
+/*
+ * FNV-1a hash of configuration file contents
+ */
+static unsigned long long ntf_settings_file_hash( const char *data, size_t len )
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    size_t i;
+
+    for ( i = 0; i < len; ++i )
+        hash = ( hash ^ (unsigned char)data[i] ) * 1099511628211ULL;
+
+    return hash;
+}
+
+/*
+ * Read configuration file
+ * Returns: allocated NUL-terminated contents, NULL on error
+ */
+static char* ntf_settings_read_file( size_t *len )
+{
+    FILE *file;
+    char *data;
+
+    file = fopen( NTF_CONF_FILE_NAME, "r" );
+    if ( file == NULL )
+    {
+        ERR( "Cannot open %s", NTF_CONF_FILE_NAME );
+        return NULL;
+    }
+
+    data = malloc( NTF_SETTINGS_FILE_LEN_MAX + 1 );
+    if ( data != NULL )
+    {
+        *len = fread( data, 1, NTF_SETTINGS_FILE_LEN_MAX + 1, file );
+        if ( *len > NTF_SETTINGS_FILE_LEN_MAX || ferror( file ) )
+        {
+            ERR( "Cannot read %s or it is larger than %d bytes",
+                 NTF_CONF_FILE_NAME, NTF_SETTINGS_FILE_LEN_MAX );
+            free( data );
+            data = NULL;
+        }
+        else
+            data[*len] = '\0';
+    }
+
+    fclose( file );
+    return data;
+}
+
+/*
+ * Parse configuration file to g_cfg unless it is the same as parsed
+ * last time. Called under guard
+ * Returns: 0 if parsed, 1 if file is not changed, -1 on error
+ */
+static int ntf_settings_parse()
+{
+    unsigned long long hash;
+    size_t len;
+    char *data;
+
+    data = ntf_settings_read_file( &len );
+    if ( data == NULL )
+        return -1;
+
+    hash = ntf_settings_file_hash( data, len );
+    if ( hash == settings.file_hash )
+    {
+        free( data );
+        return 1;
+    }
+
+    config_destroy( &g_cfg );
+    config_init( &g_cfg );
+    if ( config_read_string( &g_cfg, data ) == CONFIG_FALSE )
+    {
+        ERR( "Cannot parse %s: %s at line %d", NTF_CONF_FILE_NAME,
+             config_error_text( &g_cfg ), config_error_line( &g_cfg ) );
+        free( data );
+        return -1;
+    }
+
+    settings.file_hash = hash;
+    free( data );
+    return 0;
+}
+
 /*
  * Initialize settings API
  */
@@ -119,104 +714,345 @@ int ntfsettings_init()
     memset( &settings, 0, sizeof( struct ntf_settings ) );
     pthread_mutex_init( &settings.guard, NULL );
     config_init( &g_cfg );
-    if ( config_read_file( &g_cfg, NTF_CONF_FILE_NAME ) == CONFIG_FALSE )
+    if ( ntf_settings_parse() != 0 )
         return -1;
     return 0;
 }
 
 /*
- * Free settings API handles
+ * Free settings API handles, nothing reads settings anymore
  */
 void ntfsettings_free()
 {
+    struct ntf_settings_snapshot *snapshot;
+    int i;
+
+    pthread_mutex_lock( &settings.guard );
+
+    snapshot = __atomic_exchange_n( &settings.current, NULL, __ATOMIC_SEQ_CST );
+    free( snapshot );
+    while ( settings.retired != NULL )
+    {
+        snapshot = settings.retired;
+        settings.retired = snapshot->retired;
+        free( snapshot );
+    }
+
+    for ( i = 0; i < settings.keys_num; ++i )
+    {
+        free( settings.keys[i].key );
+        free( settings.keys[i].value );
+        free( settings.keys[i].addrs );
+    }
+    free( settings.keys );
+    settings.keys = NULL;
+    settings.keys_num = settings.keys_size = 0;
+
+    free( settings.subscribers );
+    settings.subscribers = NULL;
+    settings.subscribers_num = settings.subscribers_size = 0;
+
+    pthread_mutex_unlock( &settings.guard );
+
     config_destroy( &g_cfg );
 }
 
 /*
- * Update current settings
+ * Update current settings: all loaded keys are looked up in the file
+ * parsed again, subscribers of keys which values are changed, added or
+ * removed are notified. Invalid values are ignored, previous ones are kept
  */
 int ntf_settings_update()
 {
-    int i;
+    int i, j, res, changed_num = 0;
+    char buf[NTF_SETTINGS_SCALAR_LEN];
     const char *pvalue;
+    struct ntf_settings_key *key;
+    struct ntf_settings_change *changed = NULL;
+    struct ntf_settings_subscriber *subscribers = NULL;
+    int subscribers_num = 0;
 
     pthread_mutex_lock( &settings.guard );
 
-    config_destroy( &g_cfg );
+    res = ntf_settings_parse();
+    if ( res != 0 )
+    {
+        pthread_mutex_unlock( &settings.guard );
+        return res;
+    }
 
-    config_init( &g_cfg );
-    if ( config_read_file( &g_cfg, NTF_CONF_FILE_NAME ) == CONFIG_FALSE )
+    changed = calloc( settings.keys_num + 1, sizeof( struct ntf_settings_change ) );
+    if ( changed == NULL )
     {
         pthread_mutex_unlock( &settings.guard );
+        ERR( "Cannot allocate settings changes" );
         return -1;
     }
 
-    for ( i = 0; i < settings.settings_num; ++i )
+    for ( i = 0; i < settings.keys_num; ++i )
+    {
+        key = &settings.keys[i];
+        pvalue = ntf_settings_lookup( key->key, buf, sizeof( buf ) );
+        if ( pvalue == NULL )
+            pvalue = "";
+        if ( strcmp( pvalue, key->value != NULL ? key->value : "" ) == 0 )
+            continue;
+
+        LOG( "update value of %s; new value: %s (old value: %s)",
+              key->key, pvalue, key->value != NULL ? key->value : "" );
+        if ( ntf_settings_key_set( key, pvalue ) != 0 )
+            continue;
+
+        changed[changed_num].key   = strdup( key->key );
+        changed[changed_num].value = strdup( pvalue );
+        if ( changed[changed_num].key == NULL || changed[changed_num].value == NULL )
+        {
+            free( changed[changed_num].key );
+            free( changed[changed_num].value );
+            continue;
+        }
+        changed_num++;
+    }
+    res = ntf_settings_publish();
+
+    if ( settings.subscribers_num > 0 )
     {
-        if ( config_lookup_string( &g_cfg,
-                                    settings.settings_table[i].key,
-                                   &pvalue ) == CONFIG_TRUE )
+        subscribers = malloc( settings.subscribers_num * sizeof( struct ntf_settings_subscriber ) );
+        if ( subscribers != NULL )
         {
-            if ( strcmp( settings.settings_table[i].value, pvalue ) != 0 )
-            {
-                LOG( "update value of %s; new value: %s (old value: %s)",
-                      settings.settings_table[i].key,
-                      pvalue,
-                      settings.settings_table[i].value );
-                strncpy( settings.settings_table[i].value,
-                         pvalue, NTF_SETTINGS_VALUE_LEN );
-            }
+            subscribers_num = settings.subscribers_num;
+            memcpy( subscribers, settings.subscribers,
+                    subscribers_num * sizeof( struct ntf_settings_subscriber ) );
         }
+        else
+            ERR( "Cannot allocate settings subscribers, they are not notified" );
     }
 
-    ntfsettings_free();
     pthread_mutex_unlock( &settings.guard );
 
-    return 0;
+    /* notify subscribers out of lock, they may read settings */
+    for ( i = 0; i < changed_num; ++i )
+    {
+        for ( j = 0; j < subscribers_num; ++j )
+            if ( strcmp( changed[i].key, subscribers[j].key ) == 0 )
+                subscribers[j].func( changed[i].key, changed[i].value, subscribers[j].arg );
+        free( changed[i].key );
+        free( changed[i].value );
+    }
+    free( changed );
+    free( subscribers );
+
+    return res;
 }
 
 /*
- * Load 'key' from configuration file
+ * Load string 'key' from configuration file
  */
 void ntfsettings_load( char key[] )
 {
-    const char *pvalue = NULL;
+    ntfsettings_load_type( key, NTF_SETTINGS_STRING );
+}
+
+/*
+ * Load 'key' of 'type' from configuration file
+ */
+void ntfsettings_load_type( char key[], int type )
+{
+    char buf[NTF_SETTINGS_SCALAR_LEN];
+    const char *pvalue;
+    struct ntf_settings_key *loaded;
+
+    pthread_mutex_lock( &settings.guard );
+
+    /* key is looked up again on every update */
+    loaded = ntf_settings_key_find( key );
+    if ( loaded == NULL )
+    {
+        if ( ntf_settings_grow( (void **)&settings.keys, &settings.keys_size, settings.keys_num + 1,
+                                sizeof( struct ntf_settings_key ), NTF_SETTINGS_KEYS_MIN ) != 0 )
+        {
+            pthread_mutex_unlock( &settings.guard );
+            ERR( "key %s is not loaded", key );
+            return;
+        }
+
+        loaded = &settings.keys[settings.keys_num];
+        memset( loaded, 0, sizeof( struct ntf_settings_key ) );
+        loaded->key = strdup( key );
+        if ( loaded->key == NULL )
+        {
+            pthread_mutex_unlock( &settings.guard );
+            ERR( "key %s is not loaded", key );
+            return;
+        }
+        settings.keys_num++;
+    }
+
+    /* value of other type is dropped */
+    if ( loaded->type != type )
+    {
+        ntf_settings_key_set( loaded, NULL );
+        loaded->type = type;
+    }
+
+    pvalue = ntf_settings_lookup( key, buf, sizeof( buf ) );
+    if ( pvalue != NULL )
+        ntf_settings_key_set( loaded, pvalue );
+
+    ntf_settings_publish();
+
+    pthread_mutex_unlock( &settings.guard );
+}
+
+/*
+ * Copy entry of 'key' from the current snapshot, lock-free: reader is
+ * counted, so that snapshot replaced meanwhile is not freed under it.
+ * Value string is copied to 'param', addresses to 'addrs'
+ * Returns: 0 if key is found and is of 'type' (or 'type' is -1), -1 otherwise
+ */
+static int ntf_settings_read( const char *key, int type, char *param, size_t param_len, long *num,
+                              struct sockaddr_storage *addrs, int *addrs_num )
+{
+    struct ntf_settings_snapshot *snapshot;
+    struct ntf_settings_entry *entry = NULL;
     size_t len;
+    int res = -1;
 
-    if ( config_lookup_string( &g_cfg, key, &pvalue ) == CONFIG_FALSE )
-        return;
+    __atomic_add_fetch( &settings.readers, 1, __ATOMIC_SEQ_CST );
+
+    snapshot = __atomic_load_n( &settings.current, __ATOMIC_SEQ_CST );
+    if ( snapshot != NULL )
+        entry = ntf_settings_find( snapshot, key );
 
-    len = strlen( pvalue );
-    if ( len > 0 )
+    if ( entry != NULL && ( type < 0 || entry->type == type ) )
     {
-        strncpy( settings.settings_table[settings.settings_num].key,
-                 key, NTF_SETTINGS_KEY_LEN );
-        strncpy( settings.settings_table[settings.settings_num].value,
-                 pvalue, NTF_SETTINGS_VALUE_LEN );
-        ( settings.settings_num )++;
+        if ( param != NULL && param_len > 0 )
+        {
+            len = strnlen( entry->value, param_len - 1 );
+            memcpy( param, entry->value, len );
+            param[len] = '\0';
+        }
+        if ( num != NULL )
+            *num = entry->num;
+        if ( addrs != NULL && addrs_num != NULL )
+        {
+            if ( *addrs_num > entry->addrs_num )
+                *addrs_num = entry->addrs_num;
+            memcpy( addrs, entry->addrs, *addrs_num * sizeof( struct sockaddr_storage ) );
+        }
+        res = 0;
     }
+
+    __atomic_sub_fetch( &settings.readers, 1, __ATOMIC_RELEASE );
+    return res;
 }
 
 /*
  * Get 'key' value from settings
  */
 int ntfsettings_get( char key[], char *param, size_t param_len )
+{
+    return ntf_settings_read( key, -1, param, param_len, NULL, NULL, NULL );
+}
+
+/*
+ * Get value of 'key' of NTF_SETTINGS_BOOL type
+ */
+int ntfsettings_get_bool( char key[], int *value )
+{
+    long num;
+
+    if ( ntf_settings_read( key, NTF_SETTINGS_BOOL, NULL, 0, &num, NULL, NULL ) != 0 )
+        return -1;
+
+    *value = ( num != 0 );
+    return 0;
+}
+
+/*
+ * Get value of 'key' of NTF_SETTINGS_INT type
+ */
+int ntfsettings_get_int( char key[], long *value )
+{
+    return ntf_settings_read( key, NTF_SETTINGS_INT, NULL, 0, value, NULL, NULL );
+}
+
+/*
+ * Get value of 'key' of NTF_SETTINGS_DURATION type
+ */
+int ntfsettings_get_duration( char key[], long *msec )
+{
+    return ntf_settings_read( key, NTF_SETTINGS_DURATION, NULL, 0, msec, NULL, NULL );
+}
+
+/*
+ * Get value of 'key' of NTF_SETTINGS_ADDRESSES type
+ */
+int ntfsettings_get_addresses( char key[], struct sockaddr_storage *addrs, int *addrs_num )
+{
+    return ntf_settings_read( key, NTF_SETTINGS_ADDRESSES, NULL, 0, NULL, addrs, addrs_num );
+}
+
+/*
+ * Parse numeric address with optional port
+ */
+int ntfsettings_parse_address( const char *value, struct sockaddr_storage *addr )
+{
+    char buf[NTF_SETTINGS_ADDRESS_LEN];
+
+    if ( strlen( value ) >= sizeof( buf ) )
+        return -1;
+    strcpy( buf, value );
+
+    return ntf_settings_parse_address( buf, addr );
+}
+
+/*
+ * Subscribe to changes of 'key' value
+ */
+int ntfsettings_subscribe( char key[], ntfsettings_notify_func func, void *arg )
+{
+    struct ntf_settings_subscriber *subscriber;
+
+    pthread_mutex_lock( &settings.guard );
+
+    if ( ntf_settings_grow( (void **)&settings.subscribers, &settings.subscribers_size,
+                            settings.subscribers_num + 1, sizeof( struct ntf_settings_subscriber ),
+                            NTF_SETTINGS_KEYS_MIN ) != 0 )
+    {
+        pthread_mutex_unlock( &settings.guard );
+        ERR( "key %s is not subscribed", key );
+        return -1;
+    }
+
+    subscriber = &settings.subscribers[settings.subscribers_num++];
+    strncpy( subscriber->key, key, NTF_SETTINGS_KEY_LEN - 1 );
+    subscriber->key[NTF_SETTINGS_KEY_LEN - 1] = '\0';
+    subscriber->func = func;
+    subscriber->arg  = arg;
+
+    pthread_mutex_unlock( &settings.guard );
+    return 0;
+}
+
+/*
+ * Unsubscribe from changes of 'key' value
+ */
+void ntfsettings_unsubscribe( char key[], ntfsettings_notify_func func, void *arg )
 {
     int i;
-    size_t len;
 
-    len = param_len;
-    if ( len > NTF_SETTINGS_VALUE_LEN )
-        len = NTF_SETTINGS_VALUE_LEN;
+    pthread_mutex_lock( &settings.guard );
 
-    for( i = 0; i < settings.settings_num; ++i )
+    for ( i = 0; i < settings.subscribers_num; ++i )
     {
-        if ( strcmp( key, settings.settings_table[i].key ) == 0 )
+        if ( strcmp( settings.subscribers[i].key, key ) == 0 &&
+             settings.subscribers[i].func == func && settings.subscribers[i].arg == arg )
         {
-            strncpy( param, settings.settings_table[i].value, len );
-            return 0;
+            settings.subscribers[i] = settings.subscribers[--settings.subscribers_num];
+            break;
         }
     }
 
-    return -1;
+    pthread_mutex_unlock( &settings.guard );
 }
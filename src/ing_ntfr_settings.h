@@ -75,6 +75,36 @@
 #ifndef ING_NTFR_SETTINGS_H
 #define ING_NTFR_SETTINGS_H
 
+#include <sys/socket.h>
+
+#define NTF_SETTINGS_KEY_LEN 32
+
+/*
+ * Type of setting value, value is parsed and validated when it is loaded.
+ * Value is a string or a native libconfig number or boolean (e.g.
+ * 'recv_shards = 4;', 'syslog_listener_enabled = true;')
+ *
+ *  NTF_SETTINGS_BOOL       true|false, yes|no, on|off, 1|0
+ *  NTF_SETTINGS_INT        decimal integer
+ *  NTF_SETTINGS_DURATION   integer with ms (default), s, m or h suffix
+ *  NTF_SETTINGS_ADDRESSES  list of "a.b.c.d[:port]", "ipv6" or "[ipv6][:port]"
+ *                          separated by comma or spaces, port is 0 if omitted;
+ *                          only numeric addresses, host names are not resolved
+ */
+enum ntf_settings_type
+{
+    NTF_SETTINGS_STRING = 0,
+    NTF_SETTINGS_BOOL,
+    NTF_SETTINGS_INT,
+    NTF_SETTINGS_DURATION,
+    NTF_SETTINGS_ADDRESSES
+};
+
+/*
+ * Function called when value of subscribed key is changed
+ */
+typedef void (*ntfsettings_notify_func)( const char *key, const char *value, void *arg );
+
 /*
  * Initialize settings API
  */
@@ -84,16 +114,58 @@ int ntfsettings_init();
  */
 void ntfsettings_free();
 /*
- * Update current settings
+ * Update current settings if configuration file has changed,
+ * subscribers of changed keys are notified
+ * Returns: 0 if settings are updated, 1 if file is not changed, -1 on error
  */
 int ntf_settings_update();
 /*
- * Load 'key' from configuration file
+ * Load string 'key' from configuration file
  */
 void ntfsettings_load( char key[] );
 /*
- * Get 'key' value from settings
+ * Load 'key' of 'type' from configuration file, invalid value is
+ * reported and ignored
+ */
+void ntfsettings_load_type( char key[], int type );
+/*
+ * Get 'key' value from settings as it is written in configuration file,
+ * for a key of any type
  */
 int ntfsettings_get( char key[], char *param, size_t param_len );
+/*
+ * Get value of 'key' of NTF_SETTINGS_BOOL type
+ * Returns: 0 on success, -1 if key is not set or is of other type
+ */
+int ntfsettings_get_bool( char key[], int *value );
+/*
+ * Get value of 'key' of NTF_SETTINGS_INT type
+ */
+int ntfsettings_get_int( char key[], long *value );
+/*
+ * Get value of 'key' of NTF_SETTINGS_DURATION type, in milliseconds
+ */
+int ntfsettings_get_duration( char key[], long *msec );
+/*
+ * Get value of 'key' of NTF_SETTINGS_ADDRESSES type, '*addrs_num' is
+ * the size of 'addrs' on input and the number of addresses on output
+ */
+int ntfsettings_get_addresses( char key[], struct sockaddr_storage *addrs, int *addrs_num );
+/*
+ * Parse numeric address "<IPv4>[:<port>]", "<IPv6>" or "[<IPv6>]:<port>"
+ * the same way addresses of NTF_SETTINGS_ADDRESSES keys are parsed,
+ * port is 0 if it is not given
+ * Returns: 0 on success, -1 if address is invalid
+ */
+int ntfsettings_parse_address( const char *value, struct sockaddr_storage *addr );
+/*
+ * Subscribe to changes of 'key' value, 'func' is called from the thread
+ * updating settings with the new value
+ */
+int ntfsettings_subscribe( char key[], ntfsettings_notify_func func, void *arg );
+/*
+ * Unsubscribe from changes of 'key' value
+ */
+void ntfsettings_unsubscribe( char key[], ntfsettings_notify_func func, void *arg );
 
 #endif // ING_NTFR_SETTINGS_H
@@ -0,0 +1,549 @@
+/* ing_ntfr_stream.c
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains persistent stream connection used by listeners
+ * to deliver framed messages to their servers
+ */
+
+#include <errno.h>
+#include <netdb.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <linux/sockios.h>
+
+#include "ing_ntfr_defines.h"
+#include "ing_ntfr_stream.h"
+
+/*
+ * Parse stream address "unix:<path>" or "tcp:<host>:<port>"
+ */
+int ntf_stream_address( const char *address, struct sockaddr_storage *addr, socklen_t *addrlen )
+{
+    struct sockaddr_un *sun;
+    struct addrinfo hints, *res;
+    char host[NI_MAXHOST];
+    const char *port;
+    size_t len;
+
+    memset( addr, 0, sizeof( struct sockaddr_storage ) );
+
+    if ( strncmp( address, "unix:", 5 ) == 0 )
+    {
+        sun = (struct sockaddr_un *)addr;
+        if ( strlen( address + 5 ) == 0 || strlen( address + 5 ) >= sizeof( sun->sun_path ) )
+            return -1;
+
+        sun->sun_family = AF_UNIX;
+        strcpy( sun->sun_path, address + 5 );
+        *addrlen = sizeof( struct sockaddr_un );
+        return 0;
+    }
+
+    if ( strncmp( address, "tcp:", 4 ) != 0 )
+        return -1;
+
+    address += 4;
+    port = strrchr( address, ':' );
+    if ( port == NULL || port == address || port[1] == '\0' )
+        return -1;
+
+    len = port - address;
+    if ( address[0] == '[' && address[len - 1] == ']' )
+    {
+        /* IPv6 address in brackets */
+        address += 1;
+        len -= 2;
+    }
+    if ( len == 0 || len >= sizeof( host ) )
+        return -1;
+    memcpy( host, address, len );
+    host[len] = '\0';
+
+    memset( &hints, 0, sizeof( hints ) );
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if ( getaddrinfo( host, port + 1, &hints, &res ) != 0 )
+        return -1;
+
+    memcpy( addr, res->ai_addr, res->ai_addrlen );
+    *addrlen = res->ai_addrlen;
+    freeaddrinfo( res );
+
+    return 0;
+}
+
+/*
+ * Print 'value' in decimal, it is done per message so snprintf is not used
+ * Returns: number of digits written
+ */
+static size_t ntf_stream_decimal( char *buf, size_t value )
+{
+    char digits[24];
+    size_t n = 0, i;
+
+    do
+    {
+        digits[n++] = '0' + value % 10;
+        value /= 10;
+    } while ( value != 0 );
+
+    for ( i = 0; i < n; ++i )
+        buf[i] = digits[n - 1 - i];
+
+    return n;
+}
+
+/*
+ * Make header and trailer of frame
+ */
+size_t ntf_stream_frame( int framing, size_t len, char *header,
+                         const char **trailer, size_t *trailer_len )
+{
+    size_t n;
+
+    if ( framing == NTF_STREAM_FRAMING_CHUNKED )
+    {
+        *trailer     = "\n##\n";
+        *trailer_len = NTF_STREAM_TRAILER_LEN;
+        header[0] = '\n';
+        header[1] = '#';
+        n = 2 + ntf_stream_decimal( header + 2, len );
+        header[n++] = '\n';
+        return n;
+    }
+
+    *trailer     = "";
+    *trailer_len = 0;
+    n = ntf_stream_decimal( header, len );
+    header[n++] = ' ';
+    return n;
+}
+
+/*
+ * Initialize stream to 'address' with buffer of 'size' bytes
+ */
+int ntf_stream_init( struct ntf_stream *stream, const char *name, const char *address,
+                     int framing, size_t size )
+{
+    memset( stream, 0, sizeof( struct ntf_stream ) );
+    strncpy( stream->name, name, sizeof( stream->name ) - 1 );
+    stream->framing = framing;
+    stream->fd      = -1;
+    pthread_mutex_init( &stream->lock, NULL );
+
+    if ( ntf_stream_address( address, &stream->addr, &stream->addrlen ) != 0 )
+    {
+        ERR( "Bad %s stream address '%s'", name, address );
+        return -1;
+    }
+
+    stream->buf = malloc( size );
+    if ( stream->buf == NULL )
+    {
+        ERR( "Cannot allocate %zu bytes for %s stream", size, name );
+        return -1;
+    }
+    stream->size = size;
+
+    return 0;
+}
+
+/*
+ * Connection attempt has failed, the next one is made after backoff
+ */
+static int ntf_stream_connect_failed( struct ntf_stream *stream, int err, struct timespec *now )
+{
+    if ( stream->backoff == 0 )
+        ERR( "Cannot connect %s stream: %s (%d)", stream->name, strerror(err), err );
+
+    if ( stream->fd >= 0 )
+        close( stream->fd );
+    stream->fd = -1;
+    stream->connecting = 0;
+
+    /* exponential backoff between attempts */
+    stream->backoff = ( stream->backoff == 0 ) ? NTF_STREAM_BACKOFF_MIN : stream->backoff * 2;
+    if ( stream->backoff > NTF_STREAM_BACKOFF_MAX )
+        stream->backoff = NTF_STREAM_BACKOFF_MAX;
+    stream->retry_time = now->tv_sec + stream->backoff;
+    return -1;
+}
+
+/*
+ * Connect to the server if reconnect time came. Socket is non-blocking,
+ * so unreachable server never blocks sender: connect in progress is
+ * waited for up to 'wait_ms' and checked again on the next flush
+ * Returns: 0 if connected, -1 otherwise
+ */
+static int ntf_stream_connect( struct ntf_stream *stream, int wait_ms )
+{
+    struct timespec now;
+    struct pollfd pfd;
+    socklen_t len;
+    int res, err = 0, one = 1;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    if ( stream->fd < 0 )
+    {
+        if ( now.tv_sec < stream->retry_time )
+            return -1;
+
+        stream->fd = socket( stream->addr.ss_family, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0 );
+        if ( stream->fd < 0 )
+            return ntf_stream_connect_failed( stream, errno, &now );
+
+        if ( connect( stream->fd, (struct sockaddr *)&stream->addr, stream->addrlen ) != 0 )
+        {
+            if ( errno != EINPROGRESS )
+                return ntf_stream_connect_failed( stream, errno, &now );
+            stream->connecting = 1;
+            stream->connect_deadline = now.tv_sec + NTF_STREAM_CONNECT_TIMEOUT;
+        }
+    }
+
+    if ( stream->connecting )
+    {
+        pfd.fd     = stream->fd;
+        pfd.events = POLLOUT;
+        res = poll( &pfd, 1, wait_ms );
+        if ( res < 0 && errno != EINTR )
+            return ntf_stream_connect_failed( stream, errno, &now );
+        if ( res <= 0 )
+        {
+            if ( now.tv_sec < stream->connect_deadline )
+                return -1;
+            return ntf_stream_connect_failed( stream, ETIMEDOUT, &now );
+        }
+
+        len = sizeof( err );
+        if ( getsockopt( stream->fd, SOL_SOCKET, SO_ERROR, &err, &len ) != 0 )
+            err = errno;
+        if ( err != 0 )
+            return ntf_stream_connect_failed( stream, err, &now );
+        stream->connecting = 0;
+    }
+
+    if ( stream->addr.ss_family != AF_UNIX )
+        setsockopt( stream->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof( one ) );
+
+    INF( "%s stream connected, %zu bytes to write", stream->name, stream->tail - stream->head );
+    stream->backoff = 0;
+    return 0;
+}
+
+/*
+ * Close lost connection, messages not delivered are to be replayed
+ */
+static void ntf_stream_disconnect( struct ntf_stream *stream )
+{
+    size_t pos;
+    int i;
+
+    ERR( "%s stream connection lost: %s (%d)", stream->name, strerror(errno), errno );
+
+    for ( i = 0, pos = stream->head; i < stream->frame_num && pos < stream->sent; ++i )
+    {
+        pos += stream->frames[( stream->frame_first + i ) % NTF_STREAM_FRAMES_MAX];
+        ++stream->replayed;
+    }
+
+    close( stream->fd );
+    stream->fd   = -1;
+    stream->sent = stream->head;
+    ++stream->reconnects;
+}
+
+/*
+ * Release messages which left socket send queue
+ */
+static void ntf_stream_release( struct ntf_stream *stream )
+{
+    size_t delivered, len;
+    int outq = 0;
+
+    if ( stream->fd < 0 || stream->connecting )
+        return;
+
+    if ( ioctl( stream->fd, SIOCOUTQ, &outq ) != 0 || outq < 0 )
+        outq = 0;
+    if ( (size_t)outq > stream->sent - stream->head )
+        outq = stream->sent - stream->head;
+    delivered = stream->sent - outq;
+
+    while ( stream->frame_num > 0 )
+    {
+        len = stream->frames[stream->frame_first];
+        if ( stream->head + len > delivered )
+            break;
+
+        stream->head += len;
+        stream->frame_first = ( stream->frame_first + 1 ) % NTF_STREAM_FRAMES_MAX;
+        --stream->frame_num;
+    }
+
+    if ( stream->frame_num == 0 )
+        stream->head = stream->sent = stream->tail = 0;
+}
+
+/*
+ * Forget written messages kept for replay to get room of 'len' bytes,
+ * messages not written yet are never forgotten
+ */
+static void ntf_stream_forget( struct ntf_stream *stream, size_t len )
+{
+    size_t frame_len;
+
+    while ( stream->frame_num > 0 &&
+            ( stream->size - ( stream->tail - stream->head ) < len ||
+              stream->frame_num == NTF_STREAM_FRAMES_MAX ) )
+    {
+        frame_len = stream->frames[stream->frame_first];
+        if ( stream->head + frame_len > stream->sent )
+            break;
+
+        stream->head += frame_len;
+        stream->frame_first = ( stream->frame_first + 1 ) % NTF_STREAM_FRAMES_MAX;
+        --stream->frame_num;
+    }
+}
+
+/*
+ * Move buffered data to the beginning of buffer
+ */
+static void ntf_stream_compact( struct ntf_stream *stream )
+{
+    if ( stream->head == 0 )
+        return;
+
+    memmove( stream->buf, stream->buf + stream->head, stream->tail - stream->head );
+    stream->sent -= stream->head;
+    stream->tail -= stream->head;
+    stream->head  = 0;
+}
+
+/*
+ * Write buffered messages, stream must be locked
+ */
+static int ntf_stream_write( struct ntf_stream *stream, int wait_ms )
+{
+    struct timespec start, now;
+    struct pollfd pfd;
+    ssize_t n;
+    int left;
+
+    if ( ( stream->fd < 0 || stream->connecting ) && ntf_stream_connect( stream, wait_ms ) != 0 )
+        return -1;
+
+    /* send queue of AF_UNIX socket is accounted with overhead,
+     * so messages read by server are released before new ones are written */
+    ntf_stream_release( stream );
+
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    while ( stream->sent < stream->tail )
+    {
+        n = send( stream->fd, stream->buf + stream->sent, stream->tail - stream->sent, MSG_NOSIGNAL );
+        if ( n > 0 )
+        {
+            stream->sent += n;
+            continue;
+        }
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK ) )
+        {
+            /* server is busy, wait for it within the time left */
+            clock_gettime( CLOCK_MONOTONIC, &now );
+            left = wait_ms - ( ( now.tv_sec - start.tv_sec ) * 1000 +
+                               ( now.tv_nsec - start.tv_nsec ) / 1000000 );
+            if ( left <= 0 )
+                break;
+
+            pfd.fd     = stream->fd;
+            pfd.events = POLLOUT;
+            if ( poll( &pfd, 1, left ) < 0 && errno != EINTR )
+                break;
+            continue;
+        }
+
+        ntf_stream_disconnect( stream );
+        return -1;
+    }
+
+    ntf_stream_release( stream );
+    return ( stream->sent == stream->tail ) ? 0 : -1;
+}
+
+/*
+ * Frame message and append it to the stream buffer
+ */
+int ntf_stream_send( struct ntf_stream *stream, const char *data, size_t len )
+{
+    char header[NTF_STREAM_HEADER_LEN];
+    const char *trailer;
+    size_t header_len, trailer_len, frame_len;
+
+    if ( len == 0 )
+        return 0;
+
+    header_len = ntf_stream_frame( stream->framing, len, header, &trailer, &trailer_len );
+    frame_len  = header_len + len + trailer_len;
+
+    pthread_mutex_lock( &stream->lock );
+
+    if ( stream->tail + frame_len > stream->size || stream->frame_num == NTF_STREAM_FRAMES_MAX )
+    {
+        /* no room: reclaim delivered messages and replay history,
+         * then wait for server */
+        ntf_stream_release( stream );
+        ntf_stream_forget( stream, frame_len );
+        ntf_stream_compact( stream );
+        if ( stream->tail + frame_len > stream->size || stream->frame_num == NTF_STREAM_FRAMES_MAX )
+        {
+            ntf_stream_write( stream, NTF_STREAM_WAIT_MS );
+            ntf_stream_forget( stream, frame_len );
+            ntf_stream_compact( stream );
+        }
+        if ( stream->tail + frame_len > stream->size || stream->frame_num == NTF_STREAM_FRAMES_MAX )
+        {
+            ++stream->dropped;
+            pthread_mutex_unlock( &stream->lock );
+            return -1;
+        }
+    }
+
+    memcpy( stream->buf + stream->tail, header, header_len );
+    memcpy( stream->buf + stream->tail + header_len, data, len );
+    memcpy( stream->buf + stream->tail + header_len + len, trailer, trailer_len );
+    stream->tail += frame_len;
+    stream->frames[( stream->frame_first + stream->frame_num ) % NTF_STREAM_FRAMES_MAX] = frame_len;
+    ++stream->frame_num;
+
+    pthread_mutex_unlock( &stream->lock );
+    return 0;
+}
+
+/*
+ * Write buffered messages
+ */
+int ntf_stream_flush( struct ntf_stream *stream, int wait_ms )
+{
+    int res;
+
+    pthread_mutex_lock( &stream->lock );
+    res = ntf_stream_write( stream, wait_ms );
+    pthread_mutex_unlock( &stream->lock );
+
+    return res;
+}
+
+/*
+ * Log state and counters of stream
+ */
+void ntf_stream_report( struct ntf_stream *stream )
+{
+    pthread_mutex_lock( &stream->lock );
+    INF( "%s stream %s: %d messages (%zu bytes) buffered, %lu dropped, %lu replayed, %lu reconnects",
+         stream->name, ( stream->fd < 0 ) ? "disconnected" : stream->connecting ? "connecting" : "connected",
+         stream->frame_num, stream->tail - stream->head,
+         stream->dropped, stream->replayed, stream->reconnects );
+    pthread_mutex_unlock( &stream->lock );
+}
+
+/*
+ * Close connection and free stream buffer
+ */
+void ntf_stream_close( struct ntf_stream *stream )
+{
+    pthread_mutex_lock( &stream->lock );
+    if ( stream->fd >= 0 )
+    {
+        close( stream->fd );
+        stream->fd = -1;
+        stream->connecting = 0;
+    }
+    free( stream->buf );
+    stream->buf  = NULL;
+    stream->size = 0;
+    stream->head = stream->sent = stream->tail = 0;
+    stream->frame_num = 0;
+    pthread_mutex_unlock( &stream->lock );
+    pthread_mutex_destroy( &stream->lock );
+}
@@ -0,0 +1,187 @@
+/* ing_ntfr_stream.h
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains API of persistent stream connection used by listeners
+ * to deliver framed messages to their servers
+ */
+
+#ifndef ING_NTFR_STREAM_H
+#define ING_NTFR_STREAM_H
+
+#include <stddef.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/socket.h>
+
+/*
+ * Constants
+ */
+#define NTF_STREAM_BUFFER_LEN   (256 * 1024) /* default size of stream buffer     */
+#define NTF_STREAM_FRAMES_MAX   (4096)       /* max number of messages in buffer */
+#define NTF_STREAM_HEADER_LEN   (32)         /* max length of frame header       */
+#define NTF_STREAM_TRAILER_LEN  (4)          /* length of chunked frame trailer  */
+#define NTF_STREAM_WAIT_MS      (100)        /* max time sender waits for room   */
+#define NTF_STREAM_BACKOFF_MIN  (1)          /* reconnect backoff, seconds       */
+#define NTF_STREAM_BACKOFF_MAX  (30)
+#define NTF_STREAM_CONNECT_TIMEOUT (5)       /* seconds, connect in progress     */
+
+/*
+ * Message framing
+ */
+enum ntf_stream_framing
+{
+    NTF_STREAM_FRAMING_CHUNKED = 0, /* RFC 6242 chunked framing: \n#<len>\n<msg>\n##\n */
+    NTF_STREAM_FRAMING_OCTET        /* RFC 6587 octet counting:  <len> <msg>           */
+};
+
+/*
+ * Stream connection
+ *
+ *  Messages are framed and appended to the buffer, then all of them are
+ *  written with one system call. The buffer is bounded: when it is full,
+ *  sender waits for the server to read, and the message is dropped if
+ *  there is still no room.
+ *
+ *  Written messages are kept until the socket reports they left its send
+ *  queue, as long as there is room for new ones. When connection is lost,
+ *  they are replayed after reconnect together with messages queued
+ *  meanwhile.
+ */
+struct ntf_stream
+{
+    char   name[16];
+    int    framing;
+    struct sockaddr_storage addr;
+    socklen_t addrlen;
+    int    fd;
+    int    connecting;   /* 'fd' is being connected in background */
+    time_t connect_deadline;
+    pthread_mutex_t lock;
+
+    /* [head, sent) - written to socket, [sent, tail) - not written yet */
+    char  *buf;
+    size_t size;
+    size_t head;
+    size_t sent;
+    size_t tail;
+
+    /* lengths of framed messages starting from 'head' */
+    size_t frames[NTF_STREAM_FRAMES_MAX];
+    int    frame_first;
+    int    frame_num;
+
+    time_t retry_time;
+    int    backoff;
+
+    unsigned long dropped;
+    unsigned long replayed;
+    unsigned long reconnects;
+};
+
+/*
+ * Parse stream address "unix:<path>" or "tcp:<host>:<port>",
+ * IPv6 host is given in brackets
+ */
+int ntf_stream_address( const char *address, struct sockaddr_storage *addr, socklen_t *addrlen );
+/*
+ * Make header of frame of 'len' bytes message, header buffer must be
+ * of NTF_STREAM_HEADER_LEN bytes; trailer of the frame is returned too
+ * Returns: length of header
+ */
+size_t ntf_stream_frame( int framing, size_t len, char *header,
+                         const char **trailer, size_t *trailer_len );
+/*
+ * Initialize stream to 'address' with buffer of 'size' bytes,
+ * connection is established on the first flush; the stream must be
+ * closed even if initialization failed
+ */
+int ntf_stream_init( struct ntf_stream *stream, const char *name, const char *address,
+                     int framing, size_t size );
+/*
+ * Frame message and append it to the stream buffer
+ * Returns: 0 on success, -1 if message is dropped
+ */
+int ntf_stream_send( struct ntf_stream *stream, const char *data, size_t len );
+/*
+ * Write buffered messages, waiting up to 'wait_ms' for socket to be writable
+ * Returns: 0 if all messages are written, -1 otherwise
+ */
+int ntf_stream_flush( struct ntf_stream *stream, int wait_ms );
+/*
+ * Log state and counters of stream
+ */
+void ntf_stream_report( struct ntf_stream *stream );
+/*
+ * Close connection and free stream buffer
+ */
+void ntf_stream_close( struct ntf_stream *stream );
+
+#endif /* ING_NTFR_STREAM_H */
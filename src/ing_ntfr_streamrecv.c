@@ -0,0 +1,322 @@
+/* ing_ntfr_streamrecv.c
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains little stream server used instead of NETCONF or
+ * syslog server to check delivery of framed messages over stream
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "ing_ntfr_stream.h"
+
+#define STUB_BUFFER_LEN (128 * 1024)
+
+/*
+ * Global variables
+ */
+static const char *address = NULL; /* address to listen on              */
+static int framing = NTF_STREAM_FRAMING_CHUNKED;
+static int delay_ms = 0;           /* delay of every read, busy server  */
+static int drop_after = 0;         /* close connection after N messages */
+
+static char in[STUB_BUFFER_LEN];   /* received data      */
+static size_t in_len;
+static char msg[STUB_BUFFER_LEN];  /* message being read */
+static size_t msg_len;
+static unsigned long msg_num;
+
+/*
+ * Print help about usage command line parameters
+ */
+static void print_usage()
+{
+    printf( "ntfrstream - little stream server receiving framed notification messages\n"
+            "\nParameters:\n"
+            "\t-a, --address\taddress to listen on: unix:<path> or tcp:<host>:<port>\n"
+            "\t-o, --octet\tRFC 6587 octet counting instead of RFC 6242 chunked framing\n"
+            "\t-d, --delay\tdelay of every read, milliseconds\n"
+            "\t-n, --drop\tclose connection after every N messages\n"
+            "\t-h, --help\tdisplay this help\n"
+            "\nExample:\n\tntfrstream -a unix:/tmp/netconf.sock\n" );
+}
+
+/*
+ * Proceed command line parameters
+ */
+static void proceed_input_args( int argc, char *argv[] )
+{
+    int opt;
+    const char options[] = ":a:od:n:h";
+    static struct option longoptions[] = {
+        { "address",   required_argument, NULL, 'a' },
+        { "octet",     no_argument,       NULL, 'o' },
+        { "delay",     required_argument, NULL, 'd' },
+        { "drop",      required_argument, NULL, 'n' },
+        { "help",      no_argument,       NULL, 'h' },
+        { 0,           0,                 0,    0   }
+    };
+
+    while( ( opt = getopt_long( argc, argv,
+                                options, longoptions, NULL ) ) != -1 )
+    {
+        switch ( opt )
+        {
+        case 0: /* getopt_long produce options value */
+            break;
+        case 'a': /* address */
+            address = optarg;
+            break;
+        case 'o': /* octet counting */
+            framing = NTF_STREAM_FRAMING_OCTET;
+            break;
+        case 'd': /* read delay */
+            delay_ms = atoi( optarg );
+            break;
+        case 'n': /* close connection after N messages */
+            drop_after = atoi( optarg );
+            break;
+        case 'h': /* need to print help */
+        case ':':
+        case '?':
+        default:
+            print_usage();
+            exit( 0 );
+            break;
+        }
+    }
+
+    if ( address == NULL )
+    {
+        print_usage();
+        exit( 0 );
+    }
+}
+
+/*
+ * Parse one frame from the beginning of received data
+ * Returns: number of bytes parsed, 0 if frame is incomplete, -1 on error
+ */
+static ssize_t parse_frame( int *complete )
+{
+    char *end;
+    size_t len, hdr;
+
+    *complete = 0;
+
+    if ( framing == NTF_STREAM_FRAMING_OCTET )
+    {
+        /* <len> <msg> */
+        end = memchr( in, ' ', in_len );
+        if ( end == NULL )
+            return ( in_len > 10 ) ? -1 : 0;
+        len = strtoul( in, NULL, 10 );
+        hdr = end - in + 1;
+        if ( len == 0 || len > sizeof( msg ) )
+            return -1;
+        if ( in_len < hdr + len )
+            return 0;
+
+        memcpy( msg, in + hdr, len );
+        msg_len   = len;
+        *complete = 1;
+        return hdr + len;
+    }
+
+    /* \n#<chunk-size>\n<chunk> ... \n##\n */
+    if ( in_len < 4 )
+        return 0;
+    if ( in[0] != '\n' || in[1] != '#' )
+        return -1;
+    if ( in[2] == '#' )
+    {
+        if ( in[3] != '\n' )
+            return -1;
+        *complete = 1;
+        return 4;
+    }
+
+    end = memchr( in + 2, '\n', in_len - 2 );
+    if ( end == NULL )
+        return ( in_len > 12 ) ? -1 : 0;
+    len = strtoul( in + 2, NULL, 10 );
+    hdr = end - in + 1;
+    if ( len == 0 || msg_len + len > sizeof( msg ) )
+        return -1;
+    if ( in_len < hdr + len )
+        return 0;
+
+    memcpy( msg + msg_len, in + hdr, len );
+    msg_len += len;
+    return hdr + len;
+}
+
+/*
+ * Read messages from accepted connection until it is closed
+ */
+static void serve( int fd )
+{
+    ssize_t n;
+    int complete, received = 0;
+
+    in_len  = 0;
+    msg_len = 0;
+
+    for ( ;; )
+    {
+        if ( delay_ms > 0 )
+            usleep( delay_ms * 1000 );
+
+        n = read( fd, in + in_len, sizeof( in ) - in_len );
+        if ( n <= 0 )
+            break;
+        in_len += n;
+
+        while ( ( n = parse_frame( &complete ) ) > 0 )
+        {
+            memmove( in, in + n, in_len - n );
+            in_len -= n;
+            if ( !complete )
+                continue;
+
+            printf( "[message %lu] %zu bytes\n%.*s\n\n", ++msg_num, msg_len, (int)msg_len, msg );
+            fflush( stdout );
+            msg_len = 0;
+
+            if ( drop_after > 0 && ++received >= drop_after )
+            {
+                printf( "closing connection after %d messages\n", received );
+                return;
+            }
+        }
+        if ( n < 0 )
+        {
+            printf( "framing error, closing connection\n" );
+            return;
+        }
+    }
+}
+
+/*
+ * Main application thread
+ */
+int main( int argc, char *argv[] )
+{
+    struct sockaddr_storage addr;
+    socklen_t addrlen;
+    int srv, fd, one = 1;
+
+    proceed_input_args( argc, argv );
+
+    if ( ntf_stream_address( address, &addr, &addrlen ) != 0 )
+    {
+        printf( "bad address '%s'\n", address );
+        return -1;
+    }
+
+    srv = socket( addr.ss_family, SOCK_STREAM, 0 );
+    if ( srv < 0 )
+    {
+        printf( "socket create fail\n" );
+        return -1;
+    }
+    if ( addr.ss_family == AF_UNIX )
+        unlink( ( (struct sockaddr_un *)&addr )->sun_path );
+    else
+        setsockopt( srv, SOL_SOCKET, SO_REUSEADDR, &one, sizeof( one ) );
+
+    if ( bind( srv, (struct sockaddr *)&addr, addrlen ) != 0 || listen( srv, 1 ) != 0 )
+    {
+        printf( "cannot listen on '%s': %s\n", address, strerror( errno ) );
+        return -1;
+    }
+
+    for ( ;; )
+    {
+        fd = accept( srv, NULL, NULL );
+        if ( fd < 0 )
+            continue;
+
+        printf( "[connected]\n" );
+        serve( fd );
+        close( fd );
+        printf( "[disconnected]\n" );
+    }
+
+    return 0;
+}
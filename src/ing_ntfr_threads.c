@@ -0,0 +1,266 @@
+/* ing_ntfr_threads.c
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains naming of notifier core threads and their CPU
+ * affinity and scheduling policy set by configuration
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ing_ntfr_defines.h"
+#include "ing_ntfr_settings.h"
+#include "ing_ntfr_threads.h"
+
+#define NTF_THREAD_NAME_LEN 16 /* including '\0', limit of kernel */
+
+/*
+ * Roles of threads having settings
+ */
+static const char *ntf_thread_roles[] = { "core", "logger", "syslog", "snmp",
+                                          "netconf", "mmx", "plugins", "stats" };
+
+/*
+ * Scheduling policies by name, real-time ones have priority
+ */
+static const struct
+{
+    const char *name;
+    int policy;
+    int realtime;
+} ntf_thread_policies[] =
+{
+    { "other", SCHED_OTHER, 0 },
+    { "batch", SCHED_BATCH, 0 },
+    { "idle",  SCHED_IDLE,  0 },
+    { "fifo",  SCHED_FIFO,  1 },
+    { "rr",    SCHED_RR,    1 }
+};
+
+/* affinity of the process before threads are configured */
+static cpu_set_t ntf_threads_cpus;
+static int ntf_threads_cpus_valid = 0;
+
+/*
+ * Parse CPU list "0-3,6"
+ * Returns: 0 on success, -1 on error
+ */
+static int ntf_threads_parse_cpus( const char *value, cpu_set_t *cpus )
+{
+    const char *pos = value;
+    char *end;
+    long first, last;
+
+    CPU_ZERO( cpus );
+    while ( *pos != '\0' )
+    {
+        first = strtol( pos, &end, 10 );
+        if ( end == pos || first < 0 || first >= CPU_SETSIZE )
+            return -1;
+
+        last = first;
+        if ( *end == '-' )
+        {
+            pos  = end + 1;
+            last = strtol( pos, &end, 10 );
+            if ( end == pos || last < first || last >= CPU_SETSIZE )
+                return -1;
+        }
+        for ( ; first <= last; ++first )
+            CPU_SET( first, cpus );
+
+        if ( *end == ',' )
+            ++end;
+        else if ( *end != '\0' )
+            return -1;
+        pos = end;
+    }
+
+    return ( CPU_COUNT( cpus ) > 0 ) ? 0 : -1;
+}
+
+/*
+ * Parse scheduling policy "fifo:50"
+ * Returns: 0 on success, -1 on error
+ */
+static int ntf_threads_parse_sched( const char *value, int *policy, int *priority )
+{
+    size_t i, len;
+    char *end;
+
+    len = strcspn( value, ":" );
+    for ( i = 0; i < sizeof( ntf_thread_policies ) / sizeof( ntf_thread_policies[0] ); ++i )
+    {
+        if ( strlen( ntf_thread_policies[i].name ) != len ||
+             strncmp( ntf_thread_policies[i].name, value, len ) != 0 )
+            continue;
+
+        *policy   = ntf_thread_policies[i].policy;
+        *priority = 0;
+        if ( !ntf_thread_policies[i].realtime )
+            return ( value[len] == '\0' ) ? 0 : -1;
+
+        if ( value[len] != ':' )
+            return -1;
+        *priority = (int)strtol( value + len + 1, &end, 10 );
+        if ( end == value + len + 1 || *end != '\0' ||
+             *priority < sched_get_priority_min( *policy ) ||
+             *priority > sched_get_priority_max( *policy ) )
+            return -1;
+        return 0;
+    }
+
+    return -1;
+}
+
+/*
+ * Load thread settings and remember affinity of the process
+ */
+void ntf_threads_init()
+{
+    char key[NTF_SETTINGS_KEY_LEN];
+    size_t i;
+
+    for ( i = 0; i < sizeof( ntf_thread_roles ) / sizeof( ntf_thread_roles[0] ); ++i )
+    {
+        snprintf( key, sizeof( key ), "thread_%s_cpus", ntf_thread_roles[i] );
+        ntfsettings_load( key );
+        snprintf( key, sizeof( key ), "thread_%s_sched", ntf_thread_roles[i] );
+        ntfsettings_load( key );
+    }
+
+    ntf_threads_cpus_valid =
+        ( sched_getaffinity( 0, sizeof( ntf_threads_cpus ), &ntf_threads_cpus ) == 0 );
+}
+
+/*
+ * Name calling thread and apply settings of its role
+ */
+void ntf_thread_setup( const char *role, const char *name )
+{
+    char key[NTF_SETTINGS_KEY_LEN], value[64];
+    char thread_name[NTF_THREAD_NAME_LEN];
+    struct sched_param param, curr_param;
+    int policy, curr_policy, priority, pinned, res;
+    cpu_set_t cpus;
+
+    snprintf( thread_name, sizeof( thread_name ), "%s", name );
+    pthread_setname_np( pthread_self(), thread_name );
+
+    /* thread created by pinned one gets affinity of the process back */
+    pinned = 0;
+    snprintf( key, sizeof( key ), "thread_%s_cpus", role );
+    if ( ntfsettings_get( key, value, sizeof( value ) ) == 0 && value[0] != '\0' )
+    {
+        if ( ntf_threads_parse_cpus( value, &cpus ) == 0 )
+            pinned = 1;
+        else
+            ERR( "Bad CPU list %s = \"%s\", it is ignored", key, value );
+    }
+    if ( !pinned && ntf_threads_cpus_valid )
+    {
+        memcpy( &cpus, &ntf_threads_cpus, sizeof( cpus ) );
+        pinned = 1;
+    }
+    if ( pinned && ( res = pthread_setaffinity_np( pthread_self(), sizeof( cpus ), &cpus ) ) != 0 )
+        ERR( "Cannot set CPU affinity of thread %s, err %d (%s)", thread_name, res, strerror(res) );
+
+    policy   = SCHED_OTHER;
+    priority = 0;
+    snprintf( key, sizeof( key ), "thread_%s_sched", role );
+    if ( ntfsettings_get( key, value, sizeof( value ) ) == 0 && value[0] != '\0' &&
+         ntf_threads_parse_sched( value, &policy, &priority ) != 0 )
+    {
+        ERR( "Bad scheduling policy %s = \"%s\", it is ignored", key, value );
+        policy   = SCHED_OTHER;
+        priority = 0;
+    }
+
+    /* policy is inherited from creating thread, it is changed if it differs */
+    if ( pthread_getschedparam( pthread_self(), &curr_policy, &curr_param ) == 0 &&
+         curr_policy == policy && curr_param.sched_priority == priority )
+        return;
+
+    memset( &param, 0, sizeof( param ) );
+    param.sched_priority = priority;
+    res = pthread_setschedparam( pthread_self(), policy, &param );
+    if ( res != 0 )
+        ERR( "Cannot set scheduling policy of thread %s, err %d (%s)%s", thread_name, res, strerror(res),
+             ( res == EPERM ) ? ", CAP_SYS_NICE is required" : "" );
+    else
+        LOG( "Thread %s: scheduling policy %d, priority %d", thread_name, policy, priority );
+}
@@ -0,0 +1,314 @@
+/* ing_ntfr_workers.c
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains pool of worker threads which run listener function
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "ing_ntfr_defines.h"
+#include "ing_ntfr_queue.h"
+#include "ing_ntfr_threads.h"
+#include "ing_ntfr_metrics.h"
+#include "ing_ntfr_workers.h"
+
+#define NTF_WORKERS_NONE (-1)
+
+/*
+ * Worker thread arguments
+ */
+struct ntf_worker_args
+{
+    struct ntf_workers *pool;
+    int id;
+};
+
+/*
+ * Get lane of notification by its ordering key (FNV-1a hash)
+ */
+static int ntf_workers_lane( struct ing_notification *notif )
+{
+    unsigned int hash = 2166136261u;
+    const char *key;
+
+    if ( notif->param_num <= 0 || notif->params[0] == NULL )
+        return (unsigned int)notif->msg_id % NTF_WORKERS_LANES;
+
+    for ( key = notif->params[0]; *key != '\0'; ++key )
+    {
+        hash ^= (unsigned char)*key;
+        hash *= 16777619u;
+    }
+
+    return hash % NTF_WORKERS_LANES;
+}
+
+/*
+ * Find lane with pending item which is not processed by other worker:
+ * own lanes of the worker are checked first, then lanes of other workers
+ */
+static int ntf_workers_find_lane( struct ntf_workers *pool, int id )
+{
+    int i, lane;
+
+    for ( lane = id; lane < NTF_WORKERS_LANES; lane += pool->workers_num )
+        if ( pool->lane_head[lane] != NTF_WORKERS_NONE && !pool->lane_busy[lane] )
+            return lane;
+
+    for ( i = 1; i < NTF_WORKERS_LANES; ++i )
+    {
+        lane = ( id + i ) % NTF_WORKERS_LANES;
+        if ( pool->lane_head[lane] != NTF_WORKERS_NONE && !pool->lane_busy[lane] )
+            return lane;
+    }
+
+    return NTF_WORKERS_NONE;
+}
+
+/*
+ * Worker thread
+ */
+static void* ntf_worker( void *args )
+{
+    struct ntf_worker_args *wargs = (struct ntf_worker_args*)args;
+    struct ntf_workers *pool = wargs->pool;
+    struct ntf_work_item *item;
+    int id = wargs->id, lane, idx;
+    char name[32];
+
+    free( wargs );
+
+    snprintf( name, sizeof( name ), "ntf-%s-w%d", pool->name, id );
+    ntf_thread_setup( pool->name, name );
+
+    pthread_mutex_lock( &pool->guard );
+    for ( ;; )
+    {
+        lane = ntf_workers_find_lane( pool, id );
+        if ( lane == NTF_WORKERS_NONE )
+        {
+            if ( pool->stop && pool->pending == 0 )
+                break;
+            pthread_cond_wait( &pool->work_cond, &pool->guard );
+            continue;
+        }
+
+        idx  = pool->lane_head[lane];
+        item = &pool->items[idx];
+        pool->lane_head[lane] = item->next;
+        if ( pool->lane_head[lane] == NTF_WORKERS_NONE )
+            pool->lane_tail[lane] = NTF_WORKERS_NONE;
+        pool->lane_busy[lane] = 1;
+        pthread_mutex_unlock( &pool->guard );
+
+        pool->func( &item->notif );
+        ntf_metrics_latency( pool->scope, NTF_LATENCY_OUTPUT,
+                             ntf_metrics_now() - item->dispatched_ns );
+
+        pthread_mutex_lock( &pool->guard );
+        item->next = pool->free_head;
+        pool->free_head = idx;
+        pool->lane_busy[lane] = 0;
+        --pool->pending;
+        pthread_cond_signal( &pool->space_cond );
+        /* lane could be skipped by other workers while it was busy */
+        if ( pool->lane_head[lane] != NTF_WORKERS_NONE || ( pool->stop && pool->pending == 0 ) )
+            pthread_cond_broadcast( &pool->work_cond );
+    }
+    pthread_mutex_unlock( &pool->guard );
+
+    return NULL;
+}
+
+/*
+ * Start pool of 'workers_num' threads running 'func'
+ */
+struct ntf_workers* ntf_workers_start( const char *name, ntf_workers_func func, int workers_num )
+{
+    struct ntf_workers *pool;
+    struct ntf_worker_args *wargs;
+    int i, items_num;
+
+    if ( workers_num < 1 )
+        workers_num = 1;
+    if ( workers_num > NTF_WORKERS_MAX )
+        workers_num = NTF_WORKERS_MAX;
+
+    pool = calloc( 1, sizeof( struct ntf_workers ) );
+    if ( pool == NULL )
+        return NULL;
+
+    pthread_mutex_init( &pool->guard, NULL );
+    pthread_cond_init( &pool->work_cond, NULL );
+    pthread_cond_init( &pool->space_cond, NULL );
+    pool->name = name;
+    pool->func = func;
+    pool->scope = ntf_metrics_scope( name );
+
+    for ( i = 0; i < NTF_WORKERS_LANES; ++i )
+    {
+        pool->lane_head[i] = NTF_WORKERS_NONE;
+        pool->lane_tail[i] = NTF_WORKERS_NONE;
+    }
+
+    /* only a few items are in flight, the rest waits in priority queue of handler */
+    items_num = workers_num * NTF_WORKERS_INFLIGHT;
+    for ( i = 0; i < items_num; ++i )
+        pool->items[i].next = i + 1;
+    pool->items[items_num - 1].next = NTF_WORKERS_NONE;
+    pool->free_head = 0;
+
+    for ( i = 0; i < workers_num; ++i )
+    {
+        wargs = malloc( sizeof( struct ntf_worker_args ) );
+        if ( wargs == NULL )
+            break;
+        wargs->pool = pool;
+        wargs->id   = i;
+
+        if ( pthread_create( &pool->threads[i], NULL, &ntf_worker, wargs ) != 0 )
+        {
+            ERR( "Cannot create worker thread #%d of %s listener", i, name );
+            free( wargs );
+            break;
+        }
+        ++pool->workers_num;
+    }
+
+    if ( pool->workers_num == 0 )
+    {
+        ntf_workers_stop( pool );
+        return NULL;
+    }
+
+    LOG( "%s listener: %d worker thread(s) started", name, pool->workers_num );
+    return pool;
+}
+
+/*
+ * Dispatch notification to the pool
+ */
+void ntf_workers_submit( struct ntf_workers *pool, struct ing_notification *notif )
+{
+    struct ntf_work_item *item;
+    int idx, lane;
+
+    pthread_mutex_lock( &pool->guard );
+    while ( pool->free_head == NTF_WORKERS_NONE )
+        pthread_cond_wait( &pool->space_cond, &pool->guard );
+
+    idx  = pool->free_head;
+    item = &pool->items[idx];
+    pool->free_head = item->next;
+    pthread_mutex_unlock( &pool->guard );
+
+    /* the item is owned by dispatcher until it is linked to the lane */
+    ntf_notification_copy( &item->notif, item->param_pool, sizeof( item->param_pool ), notif );
+    item->next = NTF_WORKERS_NONE;
+    item->dispatched_ns = ntf_metrics_now();
+    lane = ntf_workers_lane( &item->notif );
+
+    pthread_mutex_lock( &pool->guard );
+    if ( pool->lane_tail[lane] == NTF_WORKERS_NONE )
+        pool->lane_head[lane] = idx;
+    else
+        pool->items[pool->lane_tail[lane]].next = idx;
+    pool->lane_tail[lane] = idx;
+    ++pool->pending;
+
+    if ( !pool->lane_busy[lane] )
+        pthread_cond_signal( &pool->work_cond );
+    pthread_mutex_unlock( &pool->guard );
+}
+
+/*
+ * Process all dispatched notifications, stop workers and free the pool
+ */
+void ntf_workers_stop( struct ntf_workers *pool )
+{
+    int i;
+
+    pthread_mutex_lock( &pool->guard );
+    pool->stop = 1;
+    pthread_cond_broadcast( &pool->work_cond );
+    pthread_mutex_unlock( &pool->guard );
+
+    for ( i = 0; i < pool->workers_num; ++i )
+        pthread_join( pool->threads[i], NULL );
+
+    pthread_cond_destroy( &pool->space_cond );
+    pthread_cond_destroy( &pool->work_cond );
+    pthread_mutex_destroy( &pool->guard );
+    free( pool );
+}
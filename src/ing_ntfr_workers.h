@@ -0,0 +1,147 @@
+/* ing_ntfr_workers.h
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains pool of worker threads which run listener function
+ * for notifications dispatched by listener handler
+ */
+
+#ifndef ING_NTFR_WORKERS_H
+#define ING_NTFR_WORKERS_H
+
+#include <pthread.h>
+
+#include "ing_ntfr_defines.h"
+
+/*
+ * Constants
+ */
+#define NTF_WORKERS_MAX      8  /* worker threads per listener                   */
+#define NTF_WORKERS_LANES    32 /* ordering lanes, notifications of a lane are   */
+                                /* processed one by one in order of dispatch     */
+#define NTF_WORKERS_INFLIGHT 2  /* dispatched, not yet processed items per worker */
+
+typedef int ( *ntf_workers_func )( struct ing_notification *notif );
+
+/*
+ * Notification dispatched to the pool
+ */
+struct ntf_work_item
+{
+    struct ing_notification notif;
+    char param_pool[NTF_STR_MSG_BUFFER_LEN];
+    int64_t dispatched_ns;      /* when it was submitted, for statistics */
+    int  next;
+};
+
+/*
+ * Worker pool
+ *
+ * Every notification is put to the lane selected by its ordering key
+ * (the first parameter, e.g. interface name, or msg_id if there are no
+ * parameters). A lane is processed by at most one worker at a time, so
+ * notifications with the same key are processed in order of dispatch.
+ * Every worker serves its own lanes first and steals work from lanes of
+ * other workers when its own lanes are empty.
+ */
+struct ntf_workers
+{
+    pthread_mutex_t  guard;
+    pthread_cond_t   work_cond;  /* signaled when item is added or lane is freed */
+    pthread_cond_t   space_cond; /* signaled when item is returned to free list  */
+    const char      *name;
+    ntf_workers_func func;
+    int scope;                   /* NTF_SCOPE_... of listener statistics */
+    int workers_num;
+    int stop;
+    int pending;
+    int free_head;
+    int lane_head[NTF_WORKERS_LANES];
+    int lane_tail[NTF_WORKERS_LANES];
+    int lane_busy[NTF_WORKERS_LANES];
+    pthread_t threads[NTF_WORKERS_MAX];
+    struct ntf_work_item items[NTF_WORKERS_MAX * NTF_WORKERS_INFLIGHT];
+};
+
+/*
+ * Start pool of 'workers_num' threads running 'func'
+ */
+struct ntf_workers* ntf_workers_start( const char *name, ntf_workers_func func, int workers_num );
+/*
+ * Dispatch notification to the pool; notification is copied,
+ * call is blocked while all in-flight items are in use
+ */
+void ntf_workers_submit( struct ntf_workers *pool, struct ing_notification *notif );
+/*
+ * Process all dispatched notifications, stop workers and free the pool
+ */
+void ntf_workers_stop( struct ntf_workers *pool );
+
+#endif /* ING_NTFR_WORKERS_H */
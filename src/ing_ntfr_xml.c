@@ -0,0 +1,327 @@
+/* ing_ntfr_xml.c
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains streaming XML writer used to build NETCONF notifications
+ */
+
+#define _GNU_SOURCE
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "ing_ntfr_xml.h"
+
+/*
+ * Append 'len' bytes, only length is counted if buffer is too small
+ */
+static void ntf_xml_put( struct ntf_xml_writer *xml, const char *data, size_t len )
+{
+    if ( xml->len + len < xml->size )
+        memcpy( xml->buf + xml->len, data, len );
+    xml->len += len;
+}
+
+/*
+ * Append string with escaping; '"' is escaped only in attribute values
+ */
+static void ntf_xml_put_escaped( struct ntf_xml_writer *xml, const char *text, int attr )
+{
+    const char *run;
+
+    for ( run = text; *text != '\0'; ++text )
+    {
+        switch ( *text )
+        {
+        case '&':
+            ntf_xml_put( xml, run, text - run );
+            ntf_xml_put( xml, "&amp;", 5 );
+            break;
+        case '<':
+            ntf_xml_put( xml, run, text - run );
+            ntf_xml_put( xml, "&lt;", 4 );
+            break;
+        case '>':
+            ntf_xml_put( xml, run, text - run );
+            ntf_xml_put( xml, "&gt;", 4 );
+            break;
+        case '"':
+            if ( !attr )
+                continue;
+            ntf_xml_put( xml, run, text - run );
+            ntf_xml_put( xml, "&quot;", 6 );
+            break;
+        default:
+            continue;
+        }
+        run = text + 1;
+    }
+
+    ntf_xml_put( xml, run, text - run );
+}
+
+/*
+ * Close start tag of the current element before its content
+ */
+static void ntf_xml_close_start( struct ntf_xml_writer *xml )
+{
+    if ( xml->start_open )
+    {
+        ntf_xml_put( xml, ">", 1 );
+        xml->start_open = 0;
+    }
+}
+
+/*
+ * Start writing to buffer 'buf' of 'size' bytes
+ */
+void ntf_xml_init( struct ntf_xml_writer *xml, char *buf, size_t size )
+{
+    xml->buf        = buf;
+    xml->size       = size;
+    xml->len        = 0;
+    xml->depth      = 0;
+    xml->start_open = 0;
+}
+
+/*
+ * Open element
+ */
+void ntf_xml_start( struct ntf_xml_writer *xml, const char *name )
+{
+    ntf_xml_close_start( xml );
+
+    ntf_xml_put( xml, "<", 1 );
+    ntf_xml_put( xml, name, strlen( name ) );
+    xml->start_open = 1;
+
+    if ( xml->depth < NTF_XML_DEPTH_MAX )
+        xml->stack[xml->depth] = name;
+    ++xml->depth;
+}
+
+/*
+ * Declare namespace of the element just opened
+ */
+void ntf_xml_ns( struct ntf_xml_writer *xml, const char *prefix, const char *uri )
+{
+    if ( !xml->start_open )
+        return;
+
+    if ( prefix == NULL )
+        ntf_xml_put( xml, " xmlns=\"", 8 );
+    else
+    {
+        ntf_xml_put( xml, " xmlns:", 7 );
+        ntf_xml_put( xml, prefix, strlen( prefix ) );
+        ntf_xml_put( xml, "=\"", 2 );
+    }
+    ntf_xml_put_escaped( xml, uri, 1 );
+    ntf_xml_put( xml, "\"", 1 );
+}
+
+/*
+ * Add attribute to the element just opened
+ */
+void ntf_xml_attr( struct ntf_xml_writer *xml, const char *name, const char *value )
+{
+    if ( !xml->start_open )
+        return;
+
+    ntf_xml_put( xml, " ", 1 );
+    ntf_xml_put( xml, name, strlen( name ) );
+    ntf_xml_put( xml, "=\"", 2 );
+    ntf_xml_put_escaped( xml, value, 1 );
+    ntf_xml_put( xml, "\"", 1 );
+}
+
+/*
+ * Write text content
+ */
+void ntf_xml_text( struct ntf_xml_writer *xml, const char *text )
+{
+    ntf_xml_close_start( xml );
+    ntf_xml_put_escaped( xml, text, 0 );
+}
+
+/*
+ * Write ready XML fragment as is
+ */
+void ntf_xml_raw( struct ntf_xml_writer *xml, const char *data, size_t len )
+{
+    ntf_xml_close_start( xml );
+    ntf_xml_put( xml, data, len );
+}
+
+/*
+ * Close the current element
+ */
+void ntf_xml_end( struct ntf_xml_writer *xml )
+{
+    const char *name;
+
+    if ( xml->depth == 0 )
+        return;
+    --xml->depth;
+
+    if ( xml->start_open )
+    {
+        ntf_xml_put( xml, "/>", 2 );
+        xml->start_open = 0;
+        return;
+    }
+
+    name = ( xml->depth < NTF_XML_DEPTH_MAX ) ? xml->stack[xml->depth] : "";
+    ntf_xml_put( xml, "</", 2 );
+    ntf_xml_put( xml, name, strlen( name ) );
+    ntf_xml_put( xml, ">", 1 );
+}
+
+/*
+ * Open RFC 5277 envelope: <notification> and its <eventTime>
+ */
+void ntf_xml_envelope_start( struct ntf_xml_writer *xml, time_t event_time )
+{
+    char stamp[32];
+    struct tm tm;
+    size_t len;
+
+    gmtime_r( &event_time, &tm );
+    len = strftime( stamp, sizeof( stamp ), "%Y-%m-%dT%H:%M:%SZ", &tm );
+
+    ntf_xml_start( xml, "notification" );
+    ntf_xml_ns( xml, NULL, NTF_XML_NS_NETCONF_NOTIFICATION );
+    ntf_xml_start( xml, "eventTime" );
+    ntf_xml_raw( xml, stamp, len );
+    ntf_xml_end( xml );
+}
+
+/*
+ * Parse RFC 3339 date-time
+ */
+int ntf_xml_parse_time( const char *str, int64_t *time_ns )
+{
+    struct tm tm;
+    const char *pos;
+    int64_t frac = 0, scale = 1000000000;
+    int hh, mm, sign;
+    time_t t;
+
+    memset( &tm, 0, sizeof( tm ) );
+    pos = strptime( str, "%Y-%m-%dT%H:%M:%S", &tm );
+    if ( pos == NULL )
+        return -1;
+
+    if ( *pos == '.' )
+    {
+        for ( ++pos; isdigit( (unsigned char)*pos ); ++pos )
+        {
+            if ( scale > 1 )
+            {
+                scale /= 10;
+                frac  += ( *pos - '0' ) * scale;
+            }
+        }
+    }
+
+    t = timegm( &tm );
+    if ( *pos == 'Z' || *pos == 'z' )
+        ++pos;
+    else if ( ( *pos == '+' || *pos == '-' ) &&
+              sscanf( pos + 1, "%2d:%2d", &hh, &mm ) == 2 && pos[3] == ':' )
+    {
+        sign = ( *pos == '-' ) ? -1 : 1;
+        t   -= sign * ( hh * 3600 + mm * 60 );
+        pos += 6;
+    }
+    else
+        return -1;
+
+    *time_ns = (int64_t)t * 1000000000 + frac;
+    return pos - str;
+}
+
+/*
+ * Close all open elements and terminate the document with '\0'
+ */
+size_t ntf_xml_finish( struct ntf_xml_writer *xml )
+{
+    while ( xml->depth > 0 )
+        ntf_xml_end( xml );
+
+    if ( xml->len < xml->size )
+        xml->buf[xml->len] = '\0';
+    else if ( xml->size > 0 )
+        xml->buf[0] = '\0';
+
+    return xml->len;
+}
@@ -0,0 +1,154 @@
+/* ing_ntfr_xml.h
+ *
+ * Copyright (c) 2026 Inango Systems LTD.
+ *
+ * Author: Inango Systems LTD. <support@inango-systems.com>
+ * Creation Date: Oct 2026
+ *
+ * The author may be reached at support@inango-systems.com
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Subject to the terms and conditions of this license, each copyright holder
+ * and contributor hereby grants to those receiving rights under this license
+ * a perpetual, worldwide, non-exclusive, no-charge, royalty-free, irrevocable
+ * (except for failure to satisfy the conditions of this license) patent license
+ * to make, have made, use, offer to sell, sell, import, and otherwise transfer
+ * this software, where such license applies only to those patent claims, already
+ * acquired or hereafter acquired, licensable by such copyright holder or contributor
+ * that are necessarily infringed by:
+ *
+ * (a) their Contribution(s) (the licensed copyrights of copyright holders and
+ * non-copyrightable additions of contributors, in source or binary form) alone;
+ * or
+ *
+ * (b) combination of their Contribution(s) with the work of authorship to which
+ * such Contribution(s) was added by such copyright holder or contributor, if,
+ * at the time the Contribution is added, such addition causes such combination
+ * to be necessarily infringed. The patent license shall not apply to any other
+ * combinations which include the Contribution.
+ *
+ * Except as expressly stated above, no rights or licenses from any copyright
+ * holder or contributor is granted under this license, whether expressly, by
+ * implication, estoppel or otherwise.
+ *
+ * DISCLAIMER
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * NOTE
+ *
+ * This is part of a management middleware software package called MMX that was developed by Inango Systems Ltd.
+ *
+ * This version of MMX provides web and command-line management interfaces.
+ *
+ * Please contact us at Inango at support@inango-systems.com if you would like to hear more about
+ * - other management packages, such as SNMP, TR-069 or Netconf
+ * - how we can extend the data model to support all parts of your system
+ * - professional sub-contract and customization services
+ *
+ */
+/* Inango Notifier is a SW component allowing to pass notifications
+ * from various applications to network management entities like
+ * SNMP agent, TR-069 client, syslog client, etc...
+ */
+/* This file contains streaming XML writer used to build NETCONF notifications
+ */
+
+#ifndef ING_NTFR_XML_H
+#define ING_NTFR_XML_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * Constants
+ */
+#define NTF_XML_DEPTH_MAX 16
+
+#define NTF_XML_NS_NETCONF_NOTIFICATION "urn:ietf:params:xml:ns:netconf:notification:1.0"
+#define NTF_XML_NS_NETMOD_NOTIFICATION  "urn:ietf:params:xml:ns:netmod:notification"
+
+/*
+ * XML writer
+ *
+ * Writer puts XML straight into the buffer given by caller, nothing is
+ * allocated. Element names are not copied, they must be valid until the
+ * element is closed. If the buffer is too small, writing continues without
+ * storing anything, so that ntf_xml_finish() can report the required size.
+ */
+struct ntf_xml_writer
+{
+    char  *buf;
+    size_t size;
+    size_t len;      /* length of the document, even if it is not fit to buffer */
+    int    depth;
+    int    start_open; /* start tag of the current element is not closed yet */
+    const char *stack[NTF_XML_DEPTH_MAX];
+};
+
+/*
+ * Start writing to buffer 'buf' of 'size' bytes
+ */
+void ntf_xml_init( struct ntf_xml_writer *xml, char *buf, size_t size );
+/*
+ * Open element, attributes can be added until content is written
+ */
+void ntf_xml_start( struct ntf_xml_writer *xml, const char *name );
+/*
+ * Declare namespace of the element just opened; 'prefix' is NULL for
+ * the default namespace
+ */
+void ntf_xml_ns( struct ntf_xml_writer *xml, const char *prefix, const char *uri );
+/*
+ * Add attribute to the element just opened, the value is escaped
+ */
+void ntf_xml_attr( struct ntf_xml_writer *xml, const char *name, const char *value );
+/*
+ * Write text content, XML special characters are escaped
+ */
+void ntf_xml_text( struct ntf_xml_writer *xml, const char *text );
+/*
+ * Write ready XML fragment as is
+ */
+void ntf_xml_raw( struct ntf_xml_writer *xml, const char *data, size_t len );
+/*
+ * Close the current element
+ */
+void ntf_xml_end( struct ntf_xml_writer *xml );
+/*
+ * Open RFC 5277 envelope: <notification> and its <eventTime>
+ */
+void ntf_xml_envelope_start( struct ntf_xml_writer *xml, time_t event_time );
+/*
+ * Parse RFC 3339 date-time "YYYY-MM-DDThh:mm:ss[.frac](Z|+hh:mm|-hh:mm)"
+ * Returns: number of characters parsed, -1 on error
+ */
+int ntf_xml_parse_time( const char *str, int64_t *time_ns );
+/*
+ * Close all open elements and terminate the document with '\0'
+ * Returns: length of the document; if it is not less than size of the
+ * buffer, the document is not fit and the buffer of 'length + 1' bytes
+ * is required
+ */
+size_t ntf_xml_finish( struct ntf_xml_writer *xml );
+
+#endif /* ING_NTFR_XML_H */